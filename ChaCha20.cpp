@@ -0,0 +1,285 @@
+#include "ChaCha20.h"
+#include <cstring>
+#include <vector>
+
+// The AVX2 batch path is compiled on every x86-64 build and chosen at run
+// time (useAvx2()), so a plain -O2 build uses it on CPUs that have AVX2.
+// GCC/Clang compile just those functions for AVX2 (target attribute);
+// MSVC accepts AVX2 intrinsics without a flag.
+#if defined(__AVX2__)
+#define CHACHA20_AVX2 1
+#define CHACHA20_AVX2_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CHACHA20_AVX2 1
+#define CHACHA20_AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define CHACHA20_AVX2 1
+#define CHACHA20_AVX2_TARGET
+#endif
+
+#if defined(CHACHA20_AVX2)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+    std::uint32_t load32(const std::uint8_t* p) {
+        return static_cast<std::uint32_t>(p[0])
+            | (static_cast<std::uint32_t>(p[1]) << 8)
+            | (static_cast<std::uint32_t>(p[2]) << 16)
+            | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    void store32(std::uint8_t* p, std::uint32_t v) {
+        p[0] = static_cast<std::uint8_t>(v);
+        p[1] = static_cast<std::uint8_t>(v >> 8);
+        p[2] = static_cast<std::uint8_t>(v >> 16);
+        p[3] = static_cast<std::uint8_t>(v >> 24);
+    }
+
+    std::uint32_t rotl(std::uint32_t v, int n) {
+        return (v << n) | (v >> (32 - n));
+    }
+
+    void quarterRound(std::uint32_t& a, std::uint32_t& b, std::uint32_t& c, std::uint32_t& d) {
+        a += b; d ^= a; d = rotl(d, 16);
+        c += d; b ^= c; b = rotl(b, 12);
+        a += b; d ^= a; d = rotl(d, 8);
+        c += d; b ^= c; b = rotl(b, 7);
+    }
+
+    // state words 0-3: "expand 32-byte k"
+    const std::uint32_t kSigma[4] = { 0x61707865u, 0x3320646eu, 0x79622d32u, 0x6b206574u };
+
+    void initState(std::uint32_t s[16], const ChaCha20::Key& key,
+        const ChaCha20::Nonce& nonce, std::uint32_t counter) {
+        for (int i = 0; i < 4; ++i) s[i] = kSigma[i];
+        for (int i = 0; i < 8; ++i) s[4 + i] = load32(&key[4 * i]);
+        s[12] = counter;
+        for (int i = 0; i < 3; ++i) s[13 + i] = load32(&nonce[4 * i]);
+    }
+
+    void xorBlock(const std::uint8_t* in, std::uint8_t* out,
+        const std::uint8_t* keystream, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = static_cast<std::uint8_t>(in[i] ^ keystream[i]);
+        }
+    }
+
+#if defined(CHACHA20_AVX2)
+    bool cpuHasAvx2() {
+#if defined(__AVX2__)
+        return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+        int regs[4];
+        __cpuid(regs, 0);
+        if (regs[0] < 7) return false;
+        __cpuid(regs, 1);
+        const bool osSavesAvx = (regs[2] & (1 << 27)) != 0 && (regs[2] & (1 << 28)) != 0
+            && (_xgetbv(0) & 6) == 6;   // OSXSAVE, AVX, and the OS saves YMM state
+        if (!osSavesAvx) return false;
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    bool useAvx2() {
+        static const bool supported = cpuHasAvx2();
+        return supported;
+    }
+
+    // one keystream block of one job, scheduled onto a SIMD lane
+    struct BlockTask {
+        const ChaCha20::Job* job;
+        std::uint32_t counter;
+    };
+
+    CHACHA20_AVX2_TARGET inline __m256i rotl16(__m256i v) {
+        const __m256i shuffle = _mm256_setr_epi8(
+            2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+            2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+        return _mm256_shuffle_epi8(v, shuffle);
+    }
+
+    CHACHA20_AVX2_TARGET inline __m256i rotl8(__m256i v) {
+        const __m256i shuffle = _mm256_setr_epi8(
+            3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+            3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+        return _mm256_shuffle_epi8(v, shuffle);
+    }
+
+    template <int N>
+    CHACHA20_AVX2_TARGET inline __m256i rotlN(__m256i v) {
+        return _mm256_or_si256(_mm256_slli_epi32(v, N), _mm256_srli_epi32(v, 32 - N));
+    }
+
+    CHACHA20_AVX2_TARGET inline void quarterRound8(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+        a = _mm256_add_epi32(a, b); d = rotl16(_mm256_xor_si256(d, a));
+        c = _mm256_add_epi32(c, d); b = rotlN<12>(_mm256_xor_si256(b, c));
+        a = _mm256_add_epi32(a, b); d = rotl8(_mm256_xor_si256(d, a));
+        c = _mm256_add_epi32(c, d); b = rotlN<7>(_mm256_xor_si256(b, c));
+    }
+
+    // Computes keystream for up to eight tasks at once. Lanes carry the
+    // per-task counter and nonce; constants and key are broadcast.
+    CHACHA20_AVX2_TARGET void processTasks8(const ChaCha20::Key& key, const BlockTask* tasks, int laneCount) {
+        alignas(32) std::uint32_t counters[8] = {};
+        alignas(32) std::uint32_t nonces[3][8] = {};
+        for (int l = 0; l < laneCount; ++l) {
+            ChaCha20::Nonce n = ChaCha20::nonceFromId(tasks[l].job->nonceId);
+            counters[l] = tasks[l].counter;
+            for (int w = 0; w < 3; ++w) nonces[w][l] = load32(&n[4 * w]);
+        }
+
+        __m256i init[16];
+        for (int i = 0; i < 4; ++i) init[i] = _mm256_set1_epi32(static_cast<int>(kSigma[i]));
+        for (int i = 0; i < 8; ++i) init[4 + i] = _mm256_set1_epi32(static_cast<int>(load32(&key[4 * i])));
+        init[12] = _mm256_load_si256(reinterpret_cast<const __m256i*>(counters));
+        for (int w = 0; w < 3; ++w) init[13 + w] = _mm256_load_si256(reinterpret_cast<const __m256i*>(nonces[w]));
+
+        __m256i x[16];
+        for (int i = 0; i < 16; ++i) x[i] = init[i];
+
+        for (int round = 0; round < 10; ++round) {
+            quarterRound8(x[0], x[4], x[8], x[12]);
+            quarterRound8(x[1], x[5], x[9], x[13]);
+            quarterRound8(x[2], x[6], x[10], x[14]);
+            quarterRound8(x[3], x[7], x[11], x[15]);
+            quarterRound8(x[0], x[5], x[10], x[15]);
+            quarterRound8(x[1], x[6], x[11], x[12]);
+            quarterRound8(x[2], x[7], x[8], x[13]);
+            quarterRound8(x[3], x[4], x[9], x[14]);
+        }
+
+        alignas(32) std::uint32_t words[16][8];
+        for (int i = 0; i < 16; ++i) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(words[i]), _mm256_add_epi32(x[i], init[i]));
+        }
+
+        // transpose lane-major words into per-task keystream and apply it
+        std::uint8_t keystream[64];
+        for (int l = 0; l < laneCount; ++l) {
+            for (int i = 0; i < 16; ++i) store32(&keystream[4 * i], words[i][l]);
+
+            const ChaCha20::Job& job = *tasks[l].job;
+            std::size_t offset = static_cast<std::size_t>(tasks[l].counter) * 64;
+            std::size_t n = job.length - offset < 64 ? job.length - offset : 64;
+            xorBlock(job.in + offset, job.out + offset, keystream, n);
+        }
+    }
+
+    // Flattens jobs into 64-byte block tasks and runs them eight at a time,
+    // so short payloads from different messages share a SIMD pass.
+    CHACHA20_AVX2_TARGET void xorBatch8(const ChaCha20::Key& key, const ChaCha20::Job* jobs, std::size_t count) {
+        BlockTask tasks[8];
+        int laneCount = 0;
+        for (std::size_t j = 0; j < count; ++j) {
+            std::uint32_t blocks = static_cast<std::uint32_t>((jobs[j].length + 63) / 64);
+            for (std::uint32_t b = 0; b < blocks; ++b) {
+                tasks[laneCount++] = { &jobs[j], b };
+                if (laneCount == 8) {
+                    processTasks8(key, tasks, laneCount);
+                    laneCount = 0;
+                }
+            }
+        }
+        if (laneCount > 0) {
+            processTasks8(key, tasks, laneCount);
+        }
+    }
+#endif
+}
+
+void ChaCha20::block(const Key& key, const Nonce& nonce, std::uint32_t counter,
+    std::uint8_t out[64]) {
+    std::uint32_t s[16];
+    initState(s, key, nonce, counter);
+
+    std::uint32_t x[16];
+    std::memcpy(x, s, sizeof(x));
+
+    for (int round = 0; round < 10; ++round) {
+        quarterRound(x[0], x[4], x[8], x[12]);
+        quarterRound(x[1], x[5], x[9], x[13]);
+        quarterRound(x[2], x[6], x[10], x[14]);
+        quarterRound(x[3], x[7], x[11], x[15]);
+        quarterRound(x[0], x[5], x[10], x[15]);
+        quarterRound(x[1], x[6], x[11], x[12]);
+        quarterRound(x[2], x[7], x[8], x[13]);
+        quarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) {
+        store32(&out[4 * i], x[i] + s[i]);
+    }
+}
+
+ChaCha20::Key ChaCha20::deriveKey(const std::string& passphrase) {
+    Key seed{};
+    if (!passphrase.empty()) {
+        for (std::size_t i = 0; i < seed.size(); ++i) {
+            seed[i] = static_cast<std::uint8_t>(passphrase[i % passphrase.size()]);
+        }
+    }
+
+    std::uint8_t mixed[64];
+    block(seed, Nonce{}, 0, mixed);
+
+    Key key{};
+    std::memcpy(key.data(), mixed, key.size());
+    return key;
+}
+
+ChaCha20::Nonce ChaCha20::nonceFromId(std::uint64_t id) {
+    Nonce nonce{};
+    for (int i = 0; i < 8; ++i) {
+        nonce[4 + i] = static_cast<std::uint8_t>(id >> (8 * i));
+    }
+    return nonce;
+}
+
+void ChaCha20::xorStream(const Key& key, const Nonce& nonce, std::uint32_t counter,
+    const std::uint8_t* in, std::uint8_t* out, std::size_t length) {
+    std::uint8_t keystream[64];
+    std::size_t offset = 0;
+    while (offset < length) {
+        block(key, nonce, counter++, keystream);
+        std::size_t n = length - offset < 64 ? length - offset : 64;
+        xorBlock(in + offset, out + offset, keystream, n);
+        offset += n;
+    }
+}
+
+void ChaCha20::xorBatch(const Key& key, const Job* jobs, std::size_t count) {
+#if defined(CHACHA20_AVX2)
+    if (useAvx2()) {
+        xorBatch8(key, jobs, count);
+        return;
+    }
+#endif
+    for (std::size_t j = 0; j < count; ++j) {
+        xorStream(key, nonceFromId(jobs[j].nonceId), 0, jobs[j].in, jobs[j].out, jobs[j].length);
+    }
+}
+
+std::string ChaCha20::apply(const Key& key, std::uint64_t nonceId, const std::string& text) {
+    std::string out(text.size(), '\0');
+    xorStream(key, nonceFromId(nonceId), 0,
+        reinterpret_cast<const std::uint8_t*>(text.data()),
+        reinterpret_cast<std::uint8_t*>(&out[0]), text.size());
+    return out;
+}
+
+bool ChaCha20::hasSimdBatch() {
+#if defined(CHACHA20_AVX2)
+    return useAvx2();
+#else
+    return false;
+#endif
+}
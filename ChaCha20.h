@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ChaCha20 stream cipher (RFC 8439), self-contained.
+//
+// Used by Network to encrypt payloads "on the wire". Every message gets its
+// own nonce derived from its message id, so no two messages share a
+// keystream under the same key.
+//
+// xorBatch() encrypts/decrypts many independent messages at once. On a CPU
+// with AVX2 (detected at run time, no compiler flag needed) it computes
+// eight 64-byte keystream blocks per pass, one per 32-bit lane, mixing
+// blocks from different messages in the same pass. Otherwise it falls back
+// to the scalar block function.
+class ChaCha20 {
+public:
+    using Key = std::array<std::uint8_t, 32>;
+    using Nonce = std::array<std::uint8_t, 12>;
+
+    // one message of a batch; 'in' and 'out' may alias
+    struct Job {
+        const std::uint8_t* in;
+        std::uint8_t* out;
+        std::size_t length;
+        std::uint64_t nonceId;
+    };
+
+    // expands a passphrase into a 256-bit key (one ChaCha20 block over the
+    // passphrase bytes repeated to 32 bytes)
+    static Key deriveKey(const std::string& passphrase);
+
+    // 96-bit nonce: 4 zero bytes followed by the little-endian 64-bit id
+    static Nonce nonceFromId(std::uint64_t id);
+
+    // XORs 'length' bytes of keystream (starting at block 'counter') into out
+    static void xorStream(const Key& key, const Nonce& nonce, std::uint32_t counter,
+        const std::uint8_t* in, std::uint8_t* out, std::size_t length);
+
+    // encrypts/decrypts every job with the nonce derived from its nonceId
+    static void xorBatch(const Key& key, const Job* jobs, std::size_t count);
+
+    // convenience wrapper used by Network: returns the transformed string
+    static std::string apply(const Key& key, std::uint64_t nonceId, const std::string& text);
+
+    // true when xorBatch() uses the AVX2 path on this CPU
+    static bool hasSimdBatch();
+
+    // raw block function: 64 bytes of keystream for (key, nonce, counter)
+    static void block(const Key& key, const Nonce& nonce, std::uint32_t counter,
+        std::uint8_t out[64]);
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+// One communication event, exactly as it appears as a comms_log.csv row.
+// The views are only valid during CommsObserver::onCommsEvent().
+struct CommsEvent {
+    std::string_view event;     // send, deliver, broadcast, drop_scheduled, ...
+    double time = 0.0;
+    long long id = 0;
+    std::string_view from;
+    std::string_view to;
+    double latency = 0.0;
+    std::uint64_t dropped = 0;
+    std::string_view payload;   // printable form (frames described), unquoted
+};
+
+// Receives every communication event, live from Network or replayed from
+// a recorded comms log by ReplayEngine.
+class CommsObserver {
+public:
+    virtual ~CommsObserver() = default;
+    virtual void onCommsEvent(const CommsEvent& event) = 0;
+};
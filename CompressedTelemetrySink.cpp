@@ -0,0 +1,124 @@
+#include "CompressedTelemetrySink.h"
+#include "Profiler.h"
+#include <cstring>
+
+namespace {
+
+    template <typename T>
+    void append(std::string& out, const T* values, std::size_t count) {
+        out.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+    }
+}
+
+CompressedTelemetrySink::CompressedTelemetrySink(const std::string& path, std::size_t framesPerBlock)
+    : mWriter(path),
+    mFramesPerBlock(framesPerBlock ? framesPerBlock : 1)
+{
+}
+
+CompressedTelemetrySink::~CompressedTelemetrySink() {
+    close();
+}
+
+/*
+ * @brief:
+ *         Copies the frame into the current block; starts a new block when
+ *         the drone set changes or the block is full.
+ *
+ * @param: frame
+ *         Frame of the step that just finished.
+ */
+
+void CompressedTelemetrySink::publish(const TelemetryFrame& frame) {
+    if (!mWriter.isOpen()) return;
+    PROFILE_SCOPE("logging.compress");
+
+    const std::size_t n = frame.count;
+    bool sameDrones = mFrames > 0 && mIds.size() == n
+        && (n == 0 || std::memcmp(mIds.data(), frame.ids, n * sizeof(int)) == 0);
+    if (mFrames > 0 && !sameDrones) flushBlock();
+    if (mFrames == 0) mIds.assign(frame.ids, frame.ids + n);
+
+    mSteps.push_back(frame.step);
+    mTimes.push_back(frame.time);
+    const double* columns[4] = { frame.x, frame.y, frame.vx, frame.vy };
+    for (int c = 0; c < 4; ++c) mColumns[c].insert(mColumns[c].end(), columns[c], columns[c] + n);
+
+    if (++mFrames == mFramesPerBlock) flushBlock();
+}
+
+/*
+ * @brief:
+ *         Serialises the block and hands it to the writer thread.
+ */
+
+void CompressedTelemetrySink::flushBlock() {
+    if (mFrames == 0) return;
+
+    std::string block;
+    const std::size_t n = mIds.size();
+    block.reserve(8 + 16 * mFrames + 4 * n + 32 * mFrames * n);
+    std::uint32_t header[2] = { static_cast<std::uint32_t>(mFrames), static_cast<std::uint32_t>(n) };
+    append(block, header, 2);
+    append(block, mSteps.data(), mFrames);
+    append(block, mTimes.data(), mFrames);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::int32_t id = mIds[i];
+        append(block, &id, 1);
+    }
+    for (int c = 0; c < 4; ++c) append(block, mColumns[c].data(), mColumns[c].size());
+
+    mWriter.writeBlock(std::move(block), LogCompression::BlockFilter::TelemetryColumns);
+
+    mFrames = 0;
+    mSteps.clear();
+    mTimes.clear();
+    for (int c = 0; c < 4; ++c) mColumns[c].clear();
+}
+
+void CompressedTelemetrySink::close() {
+    if (!mWriter.isOpen()) return;
+    flushBlock();
+    mWriter.close();
+}
+
+CompressedTelemetryReader::CompressedTelemetryReader(const std::string& path)
+    : mLog(path)
+{
+}
+
+bool CompressedTelemetryReader::next(LoggedFrame& out) {
+    while (mCursor >= mFrames) {
+        LogCompression::BlockFilter filter;
+        if (!mLog.nextBlock(mBlock, filter)) return false;
+        if (filter != LogCompression::BlockFilter::TelemetryColumns || mBlock.size() < 8) {
+            mError = "not a telemetry block";
+            return false;
+        }
+        std::uint32_t header[2];
+        std::memcpy(header, mBlock.data(), 8);
+        mFrames = header[0];
+        mDrones = header[1];
+        mCursor = 0;
+    }
+
+    const std::size_t K = mFrames, n = mDrones, k = mCursor++;
+    const char* base = mBlock.data() + 8;
+    const char* ids = base + 16 * K;
+    const char* columns = ids + 4 * n;
+
+    std::memcpy(&out.step, base + 8 * k, 8);
+    std::memcpy(&out.time, base + 8 * K + 8 * k, 8);
+    out.ids.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::int32_t id;
+        std::memcpy(&id, ids + 4 * i, 4);
+        out.ids[i] = id;
+    }
+    std::vector<double>* dst[4] = { &out.x, &out.y, &out.vx, &out.vy };
+    for (int c = 0; c < 4; ++c) {
+        dst[c]->resize(n);
+        if (n) std::memcpy(dst[c]->data(), columns + 8 * (static_cast<std::size_t>(c) * K * n + k * n), 8 * n);
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef COMPRESSED_TELEMETRY_SINK_H
+#define COMPRESSED_TELEMETRY_SINK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "LogCompression.h"
+#include "TelemetryLogReader.h"
+#include "TelemetrySink.h"
+
+/*
+ * @class:
+ *         CompressedTelemetrySink
+ * @brief:
+ *         Records frames in a compressed binary log (".dtz"), using the
+ *         float-aware TelemetryColumns filter (LogCompression.h).
+ *
+ * Consecutive frames with the same drones are grouped into blocks of up
+ * to framesPerBlock frames. A block is laid out column-wise so the filter
+ * can XOR each value against the previous frame's:
+ *
+ *   u32 frames K, u32 drones n,
+ *   u64 steps[K], f64 times[K], i32 ids[n],
+ *   f64 x[K][n], y[K][n], vx[K][n], vy[K][n]
+ *
+ * Values are stored exactly (no quantisation). Filtering and compression
+ * run on the writer's background thread; publish() only copies.
+ */
+
+class CompressedTelemetrySink : public TelemetrySink {
+public:
+
+    /*
+     * @param: path
+     *         Output file, e.g. "telemetry.dtz".
+     * @param: framesPerBlock
+     *         Frames per block; more frames compress better, fewer let a
+     *         reader start sooner.
+     */
+
+    explicit CompressedTelemetrySink(const std::string& path, std::size_t framesPerBlock = 256);
+
+    ~CompressedTelemetrySink() override;
+
+    bool isOpen() const { return mWriter.isOpen(); }
+
+    const std::string& error() const { return mWriter.error(); }
+
+    void publish(const TelemetryFrame& frame) override;
+
+    void close() override;
+
+private:
+    void flushBlock();
+
+    CompressedLogWriter mWriter;
+    std::size_t mFramesPerBlock;
+    std::size_t mFrames = 0;
+    std::vector<int> mIds;
+    std::vector<std::uint64_t> mSteps;
+    std::vector<double> mTimes;
+    std::vector<double> mColumns[4];
+};
+
+/*
+ * @class:
+ *         CompressedTelemetryReader
+ * @brief:
+ *         Reads the frames of a ".dtz" log in order.
+ */
+
+class CompressedTelemetryReader {
+public:
+    explicit CompressedTelemetryReader(const std::string& path);
+
+    bool isOpen() const { return mLog.isOpen(); }
+
+    const std::string& error() const { return mError.empty() ? mLog.error() : mError; }
+
+    /*
+     * @brief:
+     *         Copies the next frame.
+     *
+     * @return:
+     *         false after the last frame or on a corrupt block (error()).
+     */
+
+    bool next(LoggedFrame& out);
+
+private:
+    CompressedLogReader mLog;
+    std::string mError;
+    std::string mBlock;
+    std::size_t mFrames = 0;
+    std::size_t mDrones = 0;
+    std::size_t mCursor = 0;
+};
+
+#endif // COMPRESSED_TELEMETRY_SINK_H
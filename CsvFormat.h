@@ -0,0 +1,48 @@
+#ifndef CSV_FORMAT_H
+#define CSV_FORMAT_H
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*
+ * @brief:
+ *         Number formatting for the CSV logs without iostreams.
+ *
+ * The logs have always been written through a default-configured
+ * std::ofstream, which prints doubles like printf("%g") with precision 6.
+ * std::to_chars with chars_format::general and precision 6 is specified
+ * to produce exactly that text, so switching a log to these helpers does
+ * not change a single byte of it, and they need no locale or stream state.
+ */
+
+namespace CsvFormat {
+
+    // Upper bounds for one field: "-1.23457e-308" is 13 chars, a 64-bit
+    // integer at most 20 digits plus sign.
+    constexpr std::size_t kMaxRealChars = 24;
+    constexpr std::size_t kMaxIntChars = 24;
+
+    inline char* putReal(char* p, double v) {
+        return std::to_chars(p, p + kMaxRealChars, v, std::chars_format::general, 6).ptr;
+    }
+
+    template <typename Int>
+    inline char* putInt(char* p, Int v) {
+        return std::to_chars(p, p + kMaxIntChars, v).ptr;
+    }
+
+    inline void appendReal(std::string& out, double v) {
+        char buf[kMaxRealChars];
+        out.append(buf, static_cast<std::size_t>(putReal(buf, v) - buf));
+    }
+
+    template <typename Int>
+    inline void appendInt(std::string& out, Int v) {
+        char buf[kMaxIntChars];
+        out.append(buf, static_cast<std::size_t>(putInt(buf, v) - buf));
+    }
+}
+
+#endif // CSV_FORMAT_H
@@ -0,0 +1,163 @@
+#include "CsvTelemetrySink.h"
+#include "CsvFormat.h"
+#include "Profiler.h"
+#include "TelemetryLogIndex.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+    const char kHeader[] = "time,droneId,x,y,vx,vy\n";
+
+    // time + id + 4 reals, 5 commas and a newline
+    constexpr std::size_t kMaxRowChars = 5 * CsvFormat::kMaxRealChars + CsvFormat::kMaxIntChars + 6;
+
+    // below this many rows per chunk, waking workers costs more than it saves
+    constexpr std::size_t kMinRowsPerChunk = 1024;
+}
+
+/*
+ * @brief:
+ *         Opens the CSV (or its compressed writer) and index files, writes
+ *         both headers and starts the formatting threads.
+ */
+
+CsvTelemetrySink::CsvTelemetrySink(const std::string& path, std::size_t threads, bool compress)
+    : mIndex(TelemetryLogIndex::indexPath(path), std::ios::binary),
+    mBytesWritten(&MetricsRegistry::global().counter("log.sim_bytes_written"))
+{
+    if (compress) {
+        mCompressed = std::make_unique<CompressedLogWriter>(path + ".lz");
+        if (!mCompressed->isOpen()) {
+            mError = mCompressed->error();
+            return;
+        }
+        // a plain log from an earlier run would not match the fresh index
+        std::remove(path.c_str());
+    }
+    else {
+        mLog.open(path, std::ios::binary);
+        if (!mLog) {
+            mError = "could not open " + path + " for writing";
+            return;
+        }
+    }
+    if (!mIndex) {
+        mError = "could not open " + TelemetryLogIndex::indexPath(path) + " for writing";
+        return;
+    }
+
+    writeText(kHeader, sizeof(kHeader) - 1);
+    mOffset = sizeof(kHeader) - 1;
+    mBytesWritten->add(mOffset);
+
+    if (threads != 1) {
+        mPool = std::make_unique<WorkerPool>(threads);
+        mChunks.resize(mPool->size());
+        mChunkBytes.resize(mPool->size());
+    }
+
+    char header[TelemetryLogIndex::kHeaderSize];
+    TelemetryLogIndex::encodeHeader(header);
+    mIndex.write(header, sizeof(header));
+    mOpen = true;
+}
+
+CsvTelemetrySink::~CsvTelemetrySink() {
+    close();
+}
+
+void CsvTelemetrySink::writeText(const char* data, std::size_t size) {
+    if (mCompressed) mCompressed->write(data, size);
+    else mLog.write(data, static_cast<std::streamsize>(size));
+}
+
+char* CsvTelemetrySink::formatRows(const TelemetryFrame& frame, std::size_t begin, std::size_t end, char* out) const {
+    for (std::size_t i = begin; i < end; ++i) {
+        std::memcpy(out, mTime, mTimeLength);   // same time on every row of the step
+        out += mTimeLength;
+        *out++ = ',';
+        out = CsvFormat::putInt(out, frame.ids[i]);
+        *out++ = ',';
+        out = CsvFormat::putReal(out, frame.x[i]);
+        *out++ = ',';
+        out = CsvFormat::putReal(out, frame.y[i]);
+        *out++ = ',';
+        out = CsvFormat::putReal(out, frame.vx[i]);
+        *out++ = ',';
+        out = CsvFormat::putReal(out, frame.vy[i]);
+        *out++ = '\n';
+    }
+    return out;
+}
+
+/*
+ * @brief:
+ *         Appends one row per drone with a single write, then the step's
+ *         index entry.
+ *
+ * @param: frame
+ *         Frame of the step that just finished.
+ */
+
+void CsvTelemetrySink::publish(const TelemetryFrame& frame) {
+    if (!mOpen) return;
+    PROFILE_SCOPE("logging");
+
+    mTimeLength = static_cast<std::size_t>(CsvFormat::putReal(mTime, frame.time) - mTime);
+
+    const std::size_t n = frame.count;
+    std::size_t chunks = mPool ? std::min(mPool->size(), n / kMinRowsPerChunk) : 1;
+    std::size_t bytes = 0;
+
+    if (chunks <= 1) {
+        mStepText.resize(n * kMaxRowChars);
+        bytes = static_cast<std::size_t>(formatRows(frame, 0, n, mStepText.data()) - mStepText.data());
+    }
+    else {
+        const std::size_t perChunk = (n + chunks - 1) / chunks;
+        mPool->run(chunks, [&](std::size_t c, std::size_t) {
+            std::size_t begin = c * perChunk;
+            std::size_t end = std::min(n, begin + perChunk);
+            std::vector<char>& text = mChunks[c];
+            text.resize((end - begin) * kMaxRowChars);
+            mChunkBytes[c] = static_cast<std::size_t>(formatRows(frame, begin, end, text.data()) - text.data());
+        });
+
+        for (std::size_t c = 0; c < chunks; ++c) bytes += mChunkBytes[c];
+        mStepText.resize(bytes);
+        char* out = mStepText.data();
+        for (std::size_t c = 0; c < chunks; ++c) {
+            std::memcpy(out, mChunks[c].data(), mChunkBytes[c]);
+            out += mChunkBytes[c];
+        }
+    }
+
+    writeText(mStepText.data(), bytes);
+
+    TelemetryLogIndex::Entry entry;
+    entry.step = frame.step;
+    entry.time = frame.time;
+    entry.offset = mOffset;
+    entry.count = static_cast<std::uint32_t>(n);
+    char encoded[TelemetryLogIndex::kEntrySize];
+    TelemetryLogIndex::encodeEntry(encoded, entry);
+    mIndex.write(encoded, sizeof(encoded));
+
+    mOffset += bytes;
+    mBytesWritten->add(bytes);
+}
+
+/*
+ * @brief:
+ *         Flushes and closes both files.
+ */
+
+void CsvTelemetrySink::close() {
+    if (!mOpen) return;
+    if (mCompressed) mCompressed->close();
+    else mLog.close();
+    mIndex.close();
+    mOpen = false;
+}
@@ -0,0 +1,101 @@
+#ifndef CSV_TELEMETRY_SINK_H
+#define CSV_TELEMETRY_SINK_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "LogCompression.h"
+#include "Metrics.h"
+#include "TelemetrySink.h"
+#include "WorkerPool.h"
+
+/*
+ * @class:
+ *         CsvTelemetrySink
+ * @brief:
+ *         Writes every frame to a CSV log (time,droneId,x,y,vx,vy) and a
+ *         step index next to it ("<path>.idx", see TelemetryLogIndex.h).
+ *
+ * Rows are formatted with std::to_chars (CsvFormat.h), which produces the
+ * same text as the default stream formatting main used to write this file
+ * with. With more than one thread, large frames are split into chunks of
+ * drones that are formatted in parallel into per-chunk buffers; the chunks
+ * are joined in drone order and each step reaches the file in a single
+ * write. The index lets TelemetryLogReader jump to any step without
+ * scanning the CSV.
+ *
+ * With compression the CSV goes to "<path>.lz" (LogCompression.h) instead;
+ * the index still refers to offsets in the decompressed text.
+ */
+
+class CsvTelemetrySink : public TelemetrySink {
+public:
+
+    /*
+     * @brief:
+     *         Creates (truncates) the CSV and its index and writes the CSV
+     *         header.
+     *
+     * @param: path
+     *         CSV path, e.g. "simulation_log.csv".
+     * @param: threads
+     *         Formatting threads (including the simulation thread).
+     * @param: compress
+     *         Write a compressed "<path>.lz" instead of the plain CSV.
+     */
+
+    explicit CsvTelemetrySink(const std::string& path, std::size_t threads = 1, bool compress = false);
+
+    ~CsvTelemetrySink() override;
+
+    CsvTelemetrySink(const CsvTelemetrySink&) = delete;
+    CsvTelemetrySink& operator=(const CsvTelemetrySink&) = delete;
+
+    /*
+     * @brief:
+     *         True if both files were opened; otherwise error() describes
+     *         why.
+     */
+
+    bool isOpen() const { return mOpen; }
+
+    const std::string& error() const { return mError; }
+
+    void publish(const TelemetryFrame& frame) override;
+
+    void close() override;
+
+private:
+
+    /*
+     * @brief:
+     *         Formats rows [begin, end) of the frame into 'out'.
+     *
+     * @return:
+     *         End of the written text.
+     */
+
+    char* formatRows(const TelemetryFrame& frame, std::size_t begin, std::size_t end, char* out) const;
+
+    void writeText(const char* data, std::size_t size);
+
+    bool mOpen = false;
+    std::string mError;
+    std::ofstream mLog;
+    std::unique_ptr<CompressedLogWriter> mCompressed;
+    std::ofstream mIndex;
+    std::uint64_t mOffset = 0;       // bytes written to the CSV so far
+
+    std::unique_ptr<WorkerPool> mPool;
+    std::vector<std::vector<char>> mChunks;   // per-chunk row text
+    std::vector<std::size_t> mChunkBytes;
+    std::vector<char> mStepText;              // whole step, written at once
+    char mTime[32];
+    std::size_t mTimeLength = 0;
+
+    Counter* mBytesWritten;
+};
+
+#endif // CSV_TELEMETRY_SINK_H
@@ -0,0 +1,178 @@
+#include "DecimatingTelemetrySink.h"
+#include "Profiler.h"
+#include <cmath>
+#include <fstream>
+
+DecimatingTelemetrySink::DecimatingTelemetrySink(TelemetrySink& next, const DecimationParams& params)
+    : mNext(next),
+    mParams(params),
+    mRowsSeenCounter(&MetricsRegistry::global().counter("log.decimation_rows_seen")),
+    mRowsLoggedCounter(&MetricsRegistry::global().counter("log.decimation_rows_logged"))
+{
+    if (mParams.stepInterval < 1) mParams.stepInterval = 1;
+}
+
+DecimatingTelemetrySink::Track& DecimatingTelemetrySink::track(int droneId) {
+    std::size_t index = static_cast<std::size_t>(droneId < 0 ? 0 : droneId);
+    if (index >= mTracks.size()) mTracks.resize(index + 1);
+    return mTracks[index];
+}
+
+/*
+ * @brief:
+ *         Adds the drone's row to the step still held back, or to the next
+ *         step if nothing is held yet.
+ */
+
+void DecimatingTelemetrySink::flagEvent(int droneId) {
+    Track& t = track(droneId);
+    if (!mHasPending || t.latestStep != mPendingStep) {
+        t.event = true;
+        return;
+    }
+    if (t.loggedStep == mPendingStep) return;
+
+    append(droneId, t.latestX, t.latestY, t.latestVX, t.latestVY);
+    t.loggedStep = mPendingStep;
+    t.x = t.latestX;
+    t.y = t.latestY;
+    t.vx = t.latestVX;
+    t.vy = t.latestVY;
+}
+
+/*
+ * @brief:
+ *         Decides whether a drone's row is logged this step.
+ */
+
+bool DecimatingTelemetrySink::keep(const Track& t, std::uint64_t step,
+    double x, double y, double vx, double vy) const
+{
+    if (!t.seen || t.event) return true;
+    if (step % static_cast<std::uint64_t>(mParams.stepInterval) != 0) return false;
+    if (mParams.maxGapSteps > 0 && step - t.loggedStep >= static_cast<std::uint64_t>(mParams.maxGapSteps)) {
+        return true;
+    }
+    if (mParams.positionEpsilon <= 0.0 && mParams.velocityEpsilon <= 0.0) return true;
+
+    double dp = std::hypot(x - t.x, y - t.y);
+    double dv = std::hypot(vx - t.vx, vy - t.vy);
+    return dp > mParams.positionEpsilon || dv > mParams.velocityEpsilon;
+}
+
+void DecimatingTelemetrySink::append(int id, double x, double y, double vx, double vy) {
+    mIds.push_back(id);
+    mX.push_back(x);
+    mY.push_back(y);
+    mVX.push_back(vx);
+    mVY.push_back(vy);
+}
+
+void DecimatingTelemetrySink::forwardPending() {
+    TelemetryFrame out;
+    out.step = mPendingStep;
+    out.time = mPendingTime;
+    out.count = mIds.size();
+    out.ids = mIds.data();
+    out.x = mX.data();
+    out.y = mY.data();
+    out.vx = mVX.data();
+    out.vy = mVY.data();
+    mNext.publish(out);
+
+    mRowsLogged += mIds.size();
+    mRowsLoggedCounter->add(mIds.size());
+    mIds.clear();
+    mX.clear();
+    mY.clear();
+    mVX.clear();
+    mVY.clear();
+    mHasPending = false;
+}
+
+/*
+ * @brief:
+ *         Forwards the previous step, then selects this step's rows.
+ *
+ * @param: frame
+ *         Frame of the step that just finished.
+ */
+
+void DecimatingTelemetrySink::publish(const TelemetryFrame& frame) {
+    if (mClosed) return;
+    PROFILE_SCOPE("logging.decimate");
+
+    if (mHasPending) forwardPending();
+
+    for (std::size_t i = 0; i < frame.count; ++i) {
+        Track& t = track(frame.ids[i]);
+        t.latestStep = frame.step;
+        t.latestX = frame.x[i];
+        t.latestY = frame.y[i];
+        t.latestVX = frame.vx[i];
+        t.latestVY = frame.vy[i];
+
+        if (!keep(t, frame.step, frame.x[i], frame.y[i], frame.vx[i], frame.vy[i])) continue;
+
+        append(frame.ids[i], frame.x[i], frame.y[i], frame.vx[i], frame.vy[i]);
+        t.seen = true;
+        t.event = false;
+        t.loggedStep = frame.step;
+        t.x = frame.x[i];
+        t.y = frame.y[i];
+        t.vx = frame.vx[i];
+        t.vy = frame.vy[i];
+    }
+
+    mPendingStep = frame.step;
+    mPendingTime = frame.time;
+    mHasPending = true;
+    mRowsSeen += frame.count;
+    mRowsSeenCounter->add(frame.count);
+}
+
+/*
+ * @brief:
+ *         Adds the final state of every drone in the last frame whose last
+ *         row is older, forwards it and closes the next sink.
+ */
+
+void DecimatingTelemetrySink::close() {
+    if (mClosed) return;
+    mClosed = true;
+
+    if (mHasPending) {
+        for (std::size_t id = 0; id < mTracks.size(); ++id) {
+            Track& t = mTracks[id];
+            if (!t.seen || t.latestStep != mPendingStep || t.loggedStep == mPendingStep) continue;
+            append(static_cast<int>(id), t.latestX, t.latestY, t.latestVX, t.latestVY);
+            t.loggedStep = mPendingStep;
+        }
+        forwardPending();
+    }
+    mNext.close();
+}
+
+/*
+ * @brief:
+ *         Writes the decimation settings and row counts as key=value lines.
+ */
+
+bool DecimatingTelemetrySink::writeMetadata(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+
+    out << "format=dronesim-telemetry\n"
+        << "sparse=" << (mParams.stepInterval > 1 || mParams.positionEpsilon > 0.0
+            || mParams.velocityEpsilon > 0.0 ? 1 : 0) << "\n"
+        << "fill=hold-last-row\n"
+        << "step_interval=" << mParams.stepInterval << "\n"
+        << "position_epsilon=" << mParams.positionEpsilon << "\n"
+        << "velocity_epsilon=" << mParams.velocityEpsilon << "\n"
+        << "max_gap_steps=" << mParams.maxGapSteps << "\n"
+        << "events_always_logged=1\n"
+        << "final_state_logged=" << (mClosed ? 1 : 0) << "\n"
+        << "rows_seen=" << mRowsSeen << "\n"
+        << "rows_logged=" << mRowsLogged << "\n";
+    return static_cast<bool>(out);
+}
@@ -0,0 +1,132 @@
+#ifndef DECIMATING_TELEMETRY_SINK_H
+#define DECIMATING_TELEMETRY_SINK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Metrics.h"
+#include "TelemetrySink.h"
+
+/*
+ * @brief:
+ *         What DecimatingTelemetrySink keeps. The defaults keep everything.
+ */
+
+struct DecimationParams {
+    int stepInterval = 1;           // consider drones only every Nth step
+    double positionEpsilon = 0.0;   // m, change since the drone's last logged row
+    double velocityEpsilon = 0.0;   // m/s, change since the drone's last logged row
+    int maxGapSteps = 0;            // log a drone at least this often (0 = never forced)
+};
+
+/*
+ * @class:
+ *         DecimatingTelemetrySink
+ * @brief:
+ *         Sink stage that forwards only the rows worth keeping to another
+ *         sink (typically CsvTelemetrySink).
+ *
+ * On every stepInterval-th step, a drone is forwarded if its position or
+ * velocity moved more than the epsilon away from the last row that was
+ * logged for it (not from the previous step, so slow drift cannot hide),
+ * or if maxGapSteps have passed since its last row. A drone's first frame
+ * is always logged, flagEvent() forces a drone's row whatever the interval,
+ * and close() logs the final state of every drone whose last row is stale,
+ * so each track ends on its true final state. Rows added by flagEvent()
+ * and close() come after the step's other rows, so within a step rows are
+ * not always in drone order.
+ *
+ * Every step is forwarded, possibly with no rows, so a step index written
+ * downstream stays dense. Frames are forwarded one step late (a step is
+ * only known to be the last one when close() is called). Readers
+ * reconstruct a drone's state at any step by holding its most recent row;
+ * that value is within the epsilons of the true state on every considered
+ * step.
+ *
+ * With both epsilons at 0 the change test is off and every considered
+ * step logs every drone.
+ */
+
+class DecimatingTelemetrySink : public TelemetrySink {
+public:
+
+    /*
+     * @param: next
+     *         Sink that receives the decimated frames; must outlive this one.
+     * @param: params
+     *         Decimation settings.
+     */
+
+    DecimatingTelemetrySink(TelemetrySink& next, const DecimationParams& params);
+
+    const DecimationParams& params() const { return mParams; }
+
+    /*
+     * @brief:
+     *         Forces the drone's row into the most recent step (e.g. it
+     *         reached its target, lost a link or crashed).
+     */
+
+    void flagEvent(int droneId);
+
+    void publish(const TelemetryFrame& frame) override;
+
+    /*
+     * @brief:
+     *         Logs stale final states, then closes the next sink.
+     */
+
+    void close() override;
+
+    std::uint64_t rowsSeen() const { return mRowsSeen; }
+
+    std::uint64_t rowsLogged() const { return mRowsLogged; }
+
+    /*
+     * @brief:
+     *         Writes a key=value sidecar describing the decimation (so tools
+     *         know the log is sparse and how to fill gaps) plus row counts.
+     *
+     * @return:
+     *         false if the file could not be written.
+     */
+
+    bool writeMetadata(const std::string& path) const;
+
+private:
+    struct Track {
+        bool seen = false;
+        bool event = false;
+        std::uint64_t loggedStep = 0;
+        double x = 0.0, y = 0.0, vx = 0.0, vy = 0.0;      // last logged row
+        std::uint64_t latestStep = 0;
+        double latestX = 0.0, latestY = 0.0, latestVX = 0.0, latestVY = 0.0;
+    };
+
+    Track& track(int droneId);
+
+    bool keep(const Track& t, std::uint64_t step, double x, double y, double vx, double vy) const;
+
+    void append(int id, double x, double y, double vx, double vy);
+
+    void forwardPending();
+
+    TelemetrySink& mNext;
+    DecimationParams mParams;
+    std::vector<Track> mTracks;      // indexed by drone id
+    bool mClosed = false;
+    bool mHasPending = false;
+    std::uint64_t mPendingStep = 0;
+    double mPendingTime = 0.0;
+
+    // rows selected for the pending frame
+    std::vector<int> mIds;
+    std::vector<double> mX, mY, mVX, mVY;
+
+    std::uint64_t mRowsSeen = 0;
+    std::uint64_t mRowsLogged = 0;
+    Counter* mRowsSeenCounter;
+    Counter* mRowsLoggedCounter;
+};
+
+#endif // DECIMATING_TELEMETRY_SINK_H
@@ -0,0 +1,232 @@
+#pragma once
+#include "MessageCodec.h"
+#include "Vector2.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// parameters of delta-compressed STATUS reports
+struct DeltaTelemetryParams {
+    int keyframeInterval = 10;        // full StatusMsg every N reports
+    double positionThreshold = 0.05;  // m, smaller position changes are suppressed
+    double velocityThreshold = 0.25;  // m/s, smaller velocity changes are suppressed
+};
+
+// drone state in integer telemetry units (codec::kTelemetryScale per metre)
+struct QuantizedState {
+    std::int64_t x = 0, y = 0;
+    std::int64_t vx = 0, vy = 0;
+
+    // false if a value is NaN or too large for telemetry units
+    static bool from(const Vector2& pos, const Vector2& vel, QuantizedState& out) {
+        return codec::toFixed(pos.x, codec::kTelemetryScale, out.x)
+            && codec::toFixed(pos.y, codec::kTelemetryScale, out.y)
+            && codec::toFixed(vel.x, codec::kTelemetryScale, out.vx)
+            && codec::toFixed(vel.y, codec::kTelemetryScale, out.vy);
+    }
+
+    Vector2 position() const {
+        return Vector2(x / codec::kTelemetryScale, y / codec::kTelemetryScale);
+    }
+
+    Vector2 velocity() const {
+        return Vector2(vx / codec::kTelemetryScale, vy / codec::kTelemetryScale);
+    }
+};
+
+// small per-drone history of reports, indexed by sequence number
+class ReportHistory {
+public:
+    void store(std::uint32_t seq, const QuantizedState& state) {
+        Entry& e = entries_[seq % kSize];
+        e.seq = seq;
+        e.state = state;
+        e.valid = true;
+    }
+
+    const QuantizedState* find(std::uint32_t seq) const {
+        const Entry& e = entries_[seq % kSize];
+        return e.valid && e.seq == seq ? &e.state : nullptr;
+    }
+
+    static constexpr std::uint32_t kSize = 32;
+
+private:
+    struct Entry {
+        std::uint32_t seq = 0;
+        QuantizedState state;
+        bool valid = false;
+    };
+
+    std::array<Entry, kSize> entries_{};
+};
+
+// Drone side. Every report is either
+//   - a keyframe (full StatusMsg): until HQ has acknowledged anything, and
+//     every keyframeInterval reports after that;
+//   - suppressed: the state is within the thresholds of the acknowledged
+//     report and of every report sent after it, so whichever of those HQ
+//     holds is current;
+//   - a delta (StatusDeltaMsg) against the last acknowledged report.
+// Deltas are computed in integer units, so HQ reconstructs exactly the
+// quantized state the drone encoded; a lost delta costs nothing because the
+// next one is still relative to an acknowledged base.
+class DeltaEncoder {
+public:
+    enum class Kind { Keyframe, Delta, Suppressed, Unencodable };
+
+    // appends the report for 'seq' to 'out' unless it is suppressed or the
+    // state cannot be quantized (NaN or out of range; nothing changes)
+    Kind encode(const DeltaTelemetryParams& params, std::uint32_t droneId, std::uint32_t seq,
+        const Vector2& pos, const Vector2& vel, std::string& out)
+    {
+        QuantizedState q;
+        if (!QuantizedState::from(pos, vel, q)) return Kind::Unencodable;
+        ++sinceKeyframe_;
+
+        bool keyframe = !hasAcked_ || sinceKeyframe_ >= params.keyframeInterval;
+        if (!keyframe && hqCopyCurrent(q, params)) {
+            return Kind::Suppressed;
+        }
+
+        if (keyframe) {
+            codec::StatusMsg status;
+            status.droneId = droneId;
+            status.seq = seq;
+            status.x = q.x / codec::kTelemetryScale;
+            status.y = q.y / codec::kTelemetryScale;
+            status.vx = q.vx / codec::kTelemetryScale;
+            status.vy = q.vy / codec::kTelemetryScale;
+            codec::encodeTo(out, status);
+            sinceKeyframe_ = 0;
+        }
+        else {
+            codec::StatusDeltaMsg delta;
+            delta.droneId = droneId;
+            delta.seq = seq;
+            delta.baseSeq = ackedSeq_;
+            delta.dx = q.x - acked_.x;
+            delta.dy = q.y - acked_.y;
+            delta.dvx = q.vx - acked_.vx;
+            delta.dvy = q.vy - acked_.vy;
+            codec::encodeTo(out, delta);
+        }
+
+        sent_.store(seq, q);
+        lastSentSeq_ = seq;
+        hasSent_ = true;
+        return keyframe ? Kind::Keyframe : Kind::Delta;
+    }
+
+    // HQ acknowledged report 'seq'; it becomes the delta base if newer
+    void onAck(std::uint32_t seq) {
+        if (hasAcked_ && seq <= ackedSeq_) return;
+        const QuantizedState* state = sent_.find(seq);
+        if (!state) return;
+        acked_ = *state;
+        ackedSeq_ = seq;
+        hasAcked_ = true;
+    }
+
+private:
+    // HQ holds the acknowledged report or a newer one we sent; suppress only
+    // if all of those are within the thresholds of the current state
+    bool hqCopyCurrent(const QuantizedState& q, const DeltaTelemetryParams& params) const {
+        if (!within(q, acked_, params)) return false;
+        if (lastSentSeq_ - ackedSeq_ >= ReportHistory::kSize) return false;
+        for (std::uint32_t seq = ackedSeq_ + 1; hasSent_ && seq <= lastSentSeq_; ++seq) {
+            const QuantizedState* sent = sent_.find(seq);
+            if (sent && !within(q, *sent, params)) return false;
+        }
+        return true;
+    }
+
+    static bool within(const QuantizedState& a, const QuantizedState& b,
+        const DeltaTelemetryParams& params) {
+        double pos = params.positionThreshold * codec::kTelemetryScale;
+        double vel = params.velocityThreshold * codec::kTelemetryScale;
+        return std::llabs(a.x - b.x) <= pos && std::llabs(a.y - b.y) <= pos
+            && std::llabs(a.vx - b.vx) <= vel && std::llabs(a.vy - b.vy) <= vel;
+    }
+
+    ReportHistory sent_;
+    QuantizedState acked_;
+    std::uint32_t ackedSeq_ = 0;
+    std::uint32_t lastSentSeq_ = 0;
+    int sinceKeyframe_ = 0;
+    bool hasAcked_ = false;
+    bool hasSent_ = false;
+};
+
+// HQ side: reconstructs each drone's full state from keyframes and deltas.
+class DeltaDecoder {
+public:
+    struct DroneState {
+        QuantizedState state;
+        std::uint32_t seq = 0;
+        bool known = false;
+    };
+
+    // applies one STATUS/STATUS_DELTA payload. Returns false for other
+    // payloads and for deltas whose base report is unknown here; on success
+    // droneId/seq identify the report to acknowledge.
+    bool apply(std::string_view payload, std::uint32_t& droneId, std::uint32_t& seq) {
+        codec::MessageView view(payload);
+        if (!view.valid()) return false;
+
+        QuantizedState q;
+        if (view.type() == codec::MessageType::Status) {
+            codec::StatusMsg status;
+            if (!view.decode(status)) return false;
+            droneId = status.droneId;
+            seq = status.seq;
+            if (!QuantizedState::from(Vector2(status.x, status.y), Vector2(status.vx, status.vy), q)) return false;
+        }
+        else if (view.type() == codec::MessageType::StatusDelta) {
+            codec::StatusDeltaMsg delta;
+            if (!view.decode(delta)) return false;
+            const QuantizedState* base = delta.droneId < drones_.size()
+                ? history_[delta.droneId].find(delta.baseSeq) : nullptr;
+            if (!base) {
+                ++missingBase_;
+                return false;
+            }
+            droneId = delta.droneId;
+            seq = delta.seq;
+            q = { base->x + delta.dx, base->y + delta.dy, base->vx + delta.dvx, base->vy + delta.dvy };
+        }
+        else {
+            return false;
+        }
+
+        if (droneId >= drones_.size()) {
+            drones_.resize(droneId + 1);
+            history_.resize(droneId + 1);
+        }
+        history_[droneId].store(seq, q);
+
+        // reports may arrive out of order; keep the newest
+        DroneState& d = drones_[droneId];
+        if (!d.known || seq > d.seq) {
+            d.state = q;
+            d.seq = seq;
+            d.known = true;
+        }
+        return true;
+    }
+
+    // latest reconstructed state of a drone (nullptr if never heard from)
+    const DroneState* state(std::uint32_t droneId) const {
+        return droneId < drones_.size() && drones_[droneId].known ? &drones_[droneId] : nullptr;
+    }
+
+    std::uint64_t missingBase() const { return missingBase_; }
+
+private:
+    std::vector<DroneState> drones_;
+    std::vector<ReportHistory> history_;
+    std::uint64_t missingBase_ = 0;
+};
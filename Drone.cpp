@@ -7,7 +7,7 @@
  *
  * The drone starts with:
  * - Given ID and physical parameters
- * - Start position (x, y)
+ * - Start position
  * - Zero velocity
  * - Zero thrust
  *
@@ -19,12 +19,13 @@
  *         Initial world-space position.
  */
 
-Drone::Drone(int id, const DroneParams& parameters, const Vector2& startPos)
+template <std::size_t N>
+BasicDrone<N>::BasicDrone(int id, const DroneParams& parameters, const Vec& startPos)
     : mId(id),
     mParameters(parameters),
     mPosition(startPos),
-    mVelocity(0.0, 0.0),
-    mThrust(0.0, 0.0) {
+    mVelocity(),
+    mThrust() {
 }
 
 /*
@@ -38,8 +39,9 @@ Drone::Drone(int id, const DroneParams& parameters, const Vector2& startPos)
  *         The desired thrust direction.
  */
 
-void Drone::setThrustDirection(const Vector2& direction) {
-    Vector2 dirNorm = direction.normalized();
+template <std::size_t N>
+void BasicDrone<N>::setThrustDirection(const Vec& direction) {
+    Vec dirNorm = direction.normalized();
     mThrust = dirNorm * mParameters.maxThrust;
 }
 
@@ -48,13 +50,14 @@ void Drone::setThrustDirection(const Vector2& direction) {
  *         Directly applies a thrust force vector.
  *
  * If |force| ? maxThrust, it is used directly.
- * Otherwise, it is scaled down (clamped) to the drones maximum allowed thrust.
+ * Otherwise, it is scaled down (clamped) to the drone’s maximum allowed thrust.
  *
  * @param: force 
  *         Force vector to apply, in Newtons.
  */
 
-void Drone::setThrustForce(const Vector2& force) {
+template <std::size_t N>
+void BasicDrone<N>::setThrustForce(const Vec& force) {
     double mag = force.length();
     if (mag == 0.0 || mag <= mParameters.maxThrust) {
         mThrust = force;
@@ -70,8 +73,9 @@ void Drone::setThrustForce(const Vector2& force) {
            Removes all thrust, leaving gravity as the only active force.
  */
 
-void Drone::clearThrust() {
-    mThrust = Vector2(0.0, 0.0);
+template <std::size_t N>
+void BasicDrone<N>::clearThrust() {
+    mThrust = Vec();
 }
 
 /*
@@ -92,13 +96,14 @@ void Drone::clearThrust() {
  *         Reference to global world settings (gravity, bounds).
  */
 
-void Drone::update(double dt, const World& world) {
+template <std::size_t N>
+void BasicDrone<N>::update(double dt, const BasicWorld<N>& world) {
     // Total force = thrust + gravity * mass
-    Vector2 gravityForce = world.gravity * mParameters.mass;
-    Vector2 totalForce = mThrust + gravityForce;
+    Vec gravityForce = world.gravity * mParameters.mass;
+    Vec totalForce = mThrust + gravityForce;
 
     // a = F / m
-    Vector2 acceleration = totalForce * (1.0 / mParameters.mass);
+    Vec acceleration = totalForce * (1.0 / mParameters.mass);
 
     // Semi-implicit Euler integrtation: v += a*dt, x += v*dt
     mVelocity += acceleration * dt;
@@ -110,9 +115,12 @@ void Drone::update(double dt, const World& world) {
     // Position update
     mPosition += mVelocity * dt;
 
-    // Boundary conditions
-    if (mPosition.x < 0.0) { mPosition.x = 0.0; mVelocity.x = 0.0; }
-    if (mPosition.y < 0.0) { mPosition.y = 0.0; mVelocity.y = 0.0; }
-    if (mPosition.x > world.width) { mPosition.x = world.width;  mVelocity.x = 0.0; }
-    if (mPosition.y > world.height) { mPosition.y = world.height; mVelocity.y = 0.0; }
+    // Boundary conditions (per axis; unrolled for the fixed N)
+    for (std::size_t axis = 0; axis < N; ++axis) {
+        if (mPosition[axis] < 0.0) { mPosition[axis] = 0.0; mVelocity[axis] = 0.0; }
+        if (mPosition[axis] > world.extent(axis)) { mPosition[axis] = world.extent(axis); mVelocity[axis] = 0.0; }
+    }
 }
+
+template class BasicDrone<2>;
+template class BasicDrone<3>;
@@ -1,7 +1,9 @@
 #ifndef DRONE_H
 #define DRONE_H
 
+#include <cstddef>
 #include "Vector2.h"
+#include "Vector3.h"
 #include "World.h"
 
 /*
@@ -11,7 +13,7 @@
  *          Physical and performance parameters used to configure a drone.
  *
  * These values define the core physical behavior of each drone:
- * - mass        : Used for Newtonian integration (F = ma)
+ * - mass        : Used for Newtonian integration (F = m·a)
  * - maxThrust   : Maximum force the drone can apply in any direction
  * - maxSpeed    : Optional speed clamp (0 = unlimited)
  */
@@ -24,9 +26,10 @@ struct DroneParams {
 
 /*
  * @class:
- *         Drone
+ *         BasicDrone<N>
  * @brief:
- *         Represents a single physical drone in the 2D simulation.
+ *         Represents a single physical drone in the N-dimensional simulation
+ *         (Drone = 2D, Drone3 = 3D).
  *
  * A Drone tracks its:
  * - Position and velocity
@@ -36,14 +39,20 @@ struct DroneParams {
  * Responsibilities:
  * - Accept thrust direction or full thrust force commands.
  * - Clamp thrust to safe limits defined in DroneParams.
- * - Integrate motion using Newtons laws (F = ma) in update().
+ * - Integrate motion using Newton’s laws (F = m·a) in update().
  *
  * The Simulator owns and updates Drone objects each timestep.
+ *
+ * The member functions are defined in Drone.cpp and instantiated there for
+ * N = 2 and N = 3 only.
  */
 
-class Drone {
+template <std::size_t N>
+class BasicDrone {
 public:
 
+    using Vec = Vector<N>;
+
     /*
      * @brief: 
      *         Constructs a drone with a unique ID, parameter set, and start position.
@@ -56,7 +65,7 @@ public:
      *         Initial position in world coordinates.
      */
 
-    Drone(int id, const DroneParams& parameters, const Vector2& startPos);
+    BasicDrone(int id, const DroneParams& parameters, const Vec& startPos);
 
     /**
      * @brief: 
@@ -68,7 +77,7 @@ public:
      * @param: direction
      *         Direction in which thrust is applied.
      */
-    void setThrustDirection(const Vector2& direction);
+    void setThrustDirection(const Vec& direction);
 
     /*
      * @brief: 
@@ -81,7 +90,7 @@ public:
      *        Thrust force vector in Newtons.
      */
 
-    void setThrustForce(const Vector2& force);
+    void setThrustForce(const Vec& force);
 
     /*
      * @brief:
@@ -92,10 +101,10 @@ public:
 
     /*
      * @brief: 
-     *         Advances the drones physics state by dt seconds.
+     *         Advances the drone’s physics state by dt seconds.
      *
      * Applies Newtonian physics:
-     * - Compute acceleration = (thrust + gravitymass) / mass
+     * - Compute acceleration = (thrust + gravity·mass) / mass
      * - Integrate velocity and clamp to maxSpeed if necessary
      * - Update position
      *
@@ -105,10 +114,10 @@ public:
      *         Global world settings (gravity, bounds).
      */
 
-    void update(double dt, const World& world);
+    void update(double dt, const BasicWorld<N>& world);
 
     /*
-     * @return: Drones unique identifier.
+     * @return: Drone’s unique identifier.
      */
 
     int getId() const { return mId; }
@@ -117,22 +126,28 @@ public:
      * @return: Current position of the drone.
      */
 
-    const Vector2& getPosition() const { return mPosition; }
+    const Vec& getPosition() const { return mPosition; }
 
     /*
      * @return: Current velocity of the drone.
      */
 
-    const Vector2& getVelocity() const { return mVelocity; }
+    const Vec& getVelocity() const { return mVelocity; }
 
 private:
     int mId;                 // Unique drone ID
     DroneParams mParameters; // Physical parameters 
 
-    Vector2 mPosition;       // Current world postion
-    Vector2 mVelocity;       // Current velocity
+    Vec mPosition;           // Current world postion
+    Vec mVelocity;           // Current velocity
 
-    Vector2 mThrust;         // thrust force in world coordinates (N)
+    Vec mThrust;             // thrust force in world coordinates (N)
 };
 
+using Drone = BasicDrone<2>;
+using Drone3 = BasicDrone<3>;
+
+extern template class BasicDrone<2>;
+extern template class BasicDrone<3>;
+
 #endif // DRONE_H
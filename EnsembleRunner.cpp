@@ -0,0 +1,188 @@
+#include "EnsembleRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include "Profiler.h"
+#include "WorkerPool.h"
+#include "WorldBatch.h"
+
+namespace {
+
+    // pooled latency histogram: 1 ms bins up to 10 s, plus an overflow bin
+    constexpr double kLatencyBinWidth = 1e-3;
+    constexpr std::size_t kLatencyBins = 10000;
+
+    double binnedPercentile(const std::vector<std::uint64_t>& bins, std::uint64_t total, double p, double max) {
+        if (total == 0) return 0.0;
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total)));
+        if (rank == 0) rank = 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bins.size(); ++i) {
+            seen += bins[i];
+            if (seen >= rank) return i + 1 < bins.size() ? std::min(max, (i + 1) * kLatencyBinWidth) : max;
+        }
+        return max;
+    }
+}
+
+EnsembleRunner::EnsembleRunner(const EnsembleParams& params)
+    : mParams(params)
+{
+}
+
+void EnsembleRunner::setRunCallback(std::function<void(const EnsembleRun&)> callback) {
+    mCallback = std::move(callback);
+}
+
+/*
+ * @brief:
+ *         Draws the perturbed parameters of one run from its own generator.
+ */
+
+EnsembleRun EnsembleRunner::drawRun(std::size_t index) const {
+    std::mt19937_64 rng(runSeed(mParams.seed, index));
+    const NetworkParams& base = mParams.base.network;
+
+    EnsembleRun run;
+    run.index = index;
+    run.seed = rng() | 1;   // never 0 (= nondeterministic)
+
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    run.dropProbability = std::clamp(base.dropProbability + mParams.dropSpread * unit(rng), 0.0, 1.0);
+    run.jitter = std::max(0.0, base.jitter + mParams.jitterSpread * unit(rng));
+    return run;
+}
+
+/*
+ * @brief:
+ *         The base scenario with a run's perturbations applied, logs and
+ *         console output off.
+ */
+
+ScenarioParams EnsembleRunner::scenarioFor(const EnsembleRun& run) const {
+    ScenarioParams scenario = mParams.base;
+    scenario.network.seed = run.seed;
+    scenario.network.dropProbability = run.dropProbability;
+    scenario.network.jitter = run.jitter;
+    scenario.network.logPath.clear();
+    scenario.network.printEvents = false;
+
+    if (mParams.startSigma > 0.0) {
+        std::mt19937_64 rng(run.seed);
+        std::normal_distribution<double> offset(0.0, mParams.startSigma);
+        for (Vector2& p : scenario.startPositions) {
+            p.x = std::clamp(p.x + offset(rng), 0.0, scenario.world.width);
+            p.y = std::clamp(p.y + offset(rng), 0.0, scenario.world.height);
+        }
+    }
+    return scenario;
+}
+
+/*
+ * @brief:
+ *         Builds every run's scenario, runs them on the pool (one run per
+ *         task, or one WorldBatch per task in batch mode) and returns the
+ *         aggregated statistics.
+ */
+
+EnsembleSummary EnsembleRunner::run() {
+    mRuns.clear();
+    mRuns.reserve(mParams.runs);
+    mLatencyBins.assign(kLatencyBins + 1, 0);
+    mLatencyMax = 0.0;
+
+    WorkerPool pool(mParams.threads);
+    std::vector<std::vector<double>> latencies(pool.size());
+
+    auto start = std::chrono::steady_clock::now();
+    if (mParams.batchWorlds > 0) {
+        const std::size_t width = mParams.batchWorlds;
+        pool.run((mParams.runs + width - 1) / width, [&](std::size_t task, std::size_t) {
+            PROFILE_SCOPE("ensemble.batch");
+            const std::size_t first = task * width;
+            const std::size_t count = std::min(width, mParams.runs - first);
+            std::vector<EnsembleRun> runs(count);
+            std::vector<ScenarioParams> scenarios(count);
+            std::vector<ScenarioResult> results(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                runs[i] = drawRun(first + i);
+                scenarios[i] = scenarioFor(runs[i]);
+            }
+            runScenarioBatch(scenarios.data(), count, results.data(), width);
+
+            const std::vector<double> noLatencies;
+            for (std::size_t i = 0; i < count; ++i) {
+                runs[i].result = results[i];
+                record(runs[i], noLatencies);
+            }
+        });
+    }
+    else {
+        pool.run(mParams.runs, [&](std::size_t task, std::size_t worker) {
+            PROFILE_SCOPE("ensemble.run");
+            EnsembleRun run = drawRun(task);
+            run.result = runScenario(scenarioFor(run), latencies[worker]);
+            record(run, latencies[worker]);
+        });
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(mRuns.begin(), mRuns.end(),
+        [](const EnsembleRun& a, const EnsembleRun& b) { return a.index < b.index; });
+    return summarize(wallSeconds);
+}
+
+/*
+ * @brief:
+ *         Folds one finished run into the aggregate and hands it to the
+ *         callback.
+ */
+
+void EnsembleRunner::record(const EnsembleRun& run, const std::vector<double>& latencies) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRuns.push_back(run);
+    for (double latency : latencies) {
+        std::size_t bin = latency > 0.0 ? static_cast<std::size_t>(latency / kLatencyBinWidth) : 0;
+        ++mLatencyBins[std::min(bin, kLatencyBins)];
+        mLatencyMax = std::max(mLatencyMax, latency);
+    }
+    if (mCallback) mCallback(run);
+}
+
+EnsembleSummary EnsembleRunner::summarize(double wallSeconds) const {
+    EnsembleSummary summary;
+    summary.runs = mRuns.size();
+    summary.wallSeconds = wallSeconds;
+    if (mRuns.empty()) return summary;
+
+    std::vector<double> times;
+    double deliverySum = 0.0;
+    summary.deliveryMin = 1.0;
+    for (const EnsembleRun& run : mRuns) {
+        if (run.result.converged()) times.push_back(run.result.convergenceTime);
+        double ratio = run.result.deliveryRatio();
+        deliverySum += ratio;
+        summary.deliveryMin = std::min(summary.deliveryMin, ratio);
+        summary.deliveryMax = std::max(summary.deliveryMax, ratio);
+    }
+    summary.deliveryMean = deliverySum / static_cast<double>(mRuns.size());
+
+    summary.converged = times.size();
+    if (!times.empty()) {
+        std::sort(times.begin(), times.end());
+        double sum = 0.0;
+        for (double t : times) sum += t;
+        summary.convergenceMean = sum / static_cast<double>(times.size());
+        summary.convergenceP50 = sortedPercentile(times, 0.50);
+        summary.convergenceP90 = sortedPercentile(times, 0.90);
+        summary.convergenceMax = times.back();
+    }
+
+    for (std::uint64_t n : mLatencyBins) summary.deliveries += n;
+    summary.latencyP50 = binnedPercentile(mLatencyBins, summary.deliveries, 0.50, mLatencyMax);
+    summary.latencyP90 = binnedPercentile(mLatencyBins, summary.deliveries, 0.90, mLatencyMax);
+    summary.latencyP99 = binnedPercentile(mLatencyBins, summary.deliveries, 0.99, mLatencyMax);
+    summary.latencyMax = mLatencyMax;
+    return summary;
+}
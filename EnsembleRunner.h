@@ -0,0 +1,150 @@
+#ifndef ENSEMBLE_RUNNER_H
+#define ENSEMBLE_RUNNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "Scenario.h"
+
+/*
+ * @class:
+ *         EnsembleParams
+ * @brief:
+ *         Base scenario, number of runs and how each run is perturbed.
+ *
+ * Run k draws its parameters from a generator seeded with (seed, k), so a
+ * given (seed, k) always reproduces the same run, whatever the thread
+ * count or completion order.
+ */
+
+struct EnsembleParams {
+    ScenarioParams base = demoScenario();
+    std::size_t runs = 100;
+    std::uint64_t seed = 1;
+
+    // uniform perturbations around the base values (clamped to valid ranges)
+    double dropSpread = 0.10;       // drop probability +/- this
+    double jitterSpread = 0.10;     // jitter (s) +/- this
+    double startSigma = 2.0;        // start positions + N(0, sigma^2) per axis (m)
+
+    std::size_t threads = 0;        // 0 = one per hardware thread
+
+    // > 0: dynamics only, this many worlds per WorldBatch (SIMD lanes);
+    // the network is not simulated, so delivery/latency stay 0
+    std::size_t batchWorlds = 0;
+};
+
+/*
+ * @class:
+ *         EnsembleRun
+ * @brief:
+ *         Parameters drawn for one run and its result.
+ */
+
+struct EnsembleRun {
+    std::size_t index = 0;
+    std::uint64_t seed = 0;         // network RNG seed of the run
+    double dropProbability = 0.0;
+    double jitter = 0.0;
+    ScenarioResult result;
+};
+
+/*
+ * @class:
+ *         EnsembleSummary
+ * @brief:
+ *         Statistics over all runs of an ensemble.
+ */
+
+struct EnsembleSummary {
+    std::size_t runs = 0;
+    std::size_t converged = 0;
+
+    // convergence time over converged runs (s)
+    double convergenceMean = 0.0;
+    double convergenceP50 = 0.0;
+    double convergenceP90 = 0.0;
+    double convergenceMax = 0.0;
+
+    // per-run delivery ratio
+    double deliveryMean = 0.0;
+    double deliveryMin = 0.0;
+    double deliveryMax = 0.0;
+
+    // latency of every delivery of every run, pooled (1 ms resolution)
+    std::uint64_t deliveries = 0;
+    double latencyP50 = 0.0;
+    double latencyP90 = 0.0;
+    double latencyP99 = 0.0;
+    double latencyMax = 0.0;
+
+    double wallSeconds = 0.0;
+};
+
+/*
+ * @class:
+ *         EnsembleRunner
+ * @brief:
+ *         Runs many independent, perturbed copies of a scenario in
+ *         parallel (WorkerPool) and aggregates their results.
+ *
+ * Every run owns its Simulator and network; the only state a worker keeps
+ * between runs is its latency buffer, so runs share nothing but the global
+ * metrics counters. Comms logs and console output are switched off for the
+ * runs. Results are folded into the summary as each run finishes, and can
+ * be streamed out through the run callback (e.g. to a CSV).
+ *
+ * With batchWorlds set, runs are grouped into WorldBatch instances instead
+ * (dynamics only), which for tiny swarms is many times faster.
+ */
+
+class EnsembleRunner {
+public:
+    explicit EnsembleRunner(const EnsembleParams& params);
+
+    /*
+     * @brief:
+     *         Called once per finished run, in completion order, never
+     *         concurrently.
+     */
+
+    void setRunCallback(std::function<void(const EnsembleRun&)> callback);
+
+    /*
+     * @brief:
+     *         Parameters of run 'index' (without running it).
+     */
+
+    EnsembleRun drawRun(std::size_t index) const;
+
+    /*
+     * @brief:
+     *         Runs all runs and returns the summary.
+     */
+
+    EnsembleSummary run();
+
+    /*
+     * @brief:
+     *         All runs of the last run(), ordered by index.
+     */
+
+    const std::vector<EnsembleRun>& runs() const { return mRuns; }
+
+private:
+    ScenarioParams scenarioFor(const EnsembleRun& run) const;
+    void record(const EnsembleRun& run, const std::vector<double>& latencies);
+    EnsembleSummary summarize(double wallSeconds) const;
+
+    EnsembleParams mParams;
+    std::function<void(const EnsembleRun&)> mCallback;
+
+    std::mutex mMutex;                      // guards everything below
+    std::vector<EnsembleRun> mRuns;
+    std::vector<std::uint64_t> mLatencyBins;    // 1 ms bins, last = overflow
+    double mLatencyMax = 0.0;
+};
+
+#endif // ENSEMBLE_RUNNER_H
@@ -0,0 +1,179 @@
+#include "FormationController.h"
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+/*
+ * @brief:
+ *         Constructs an empty controller with the given deadband radius.
+ *
+ * @param: stopRadius
+ *         Distance considered "close enough" to the target.
+ */
+
+template <std::size_t N>
+BasicFormationController<N>::BasicFormationController(double stopRadius)
+    : mStopRadius(stopRadius) {
+}
+
+/*
+ * @brief:
+ *         Appends a drone to every per-slot array.
+ *
+ * The target is stored once as an absolute position so the control loop
+ * never has to recombine formation center and offset.
+ */
+
+template <std::size_t N>
+std::size_t BasicFormationController<N>::addDrone(int droneId, const Vec& target,
+    double kP, double kD, double mass) {
+    mDroneIds.push_back(droneId);
+    for (std::size_t axis = 0; axis < N; ++axis) mTarget[axis].push_back(target[axis]);
+    mKp.push_back(kP);
+    mKd.push_back(kD);
+    mMass.push_back(mass);
+
+    std::size_t n = mDroneIds.size();
+    for (std::size_t axis = 0; axis < N; ++axis) {
+        mPos[axis].resize(n);
+        mVel[axis].resize(n);
+        mThrust[axis].resize(n);
+    }
+    mDistance.resize(n);
+
+    return n - 1;
+}
+
+/*
+ * @brief:
+ *         Replaces the target of a single slot.
+ */
+
+template <std::size_t N>
+void BasicFormationController<N>::setTarget(std::size_t slot, const Vec& target) {
+    for (std::size_t axis = 0; axis < N; ++axis) mTarget[axis][slot] = target[axis];
+}
+
+/*
+ * @brief:
+ *         Swap-and-pop of every per-slot array.
+ */
+
+template <std::size_t N>
+void BasicFormationController<N>::removeDrone(std::size_t slot) {
+    const std::size_t last = mDroneIds.size() - 1;
+    if (slot != last) {
+        mDroneIds[slot] = mDroneIds[last];
+        mKp[slot] = mKp[last];
+        mKd[slot] = mKd[last];
+        mMass[slot] = mMass[last];
+        for (std::size_t axis = 0; axis < N; ++axis) mTarget[axis][slot] = mTarget[axis][last];
+    }
+    mDroneIds.pop_back();
+    mKp.pop_back();
+    mKd.pop_back();
+    mMass.pop_back();
+    for (std::size_t axis = 0; axis < N; ++axis) {
+        mTarget[axis].pop_back();
+        mPos[axis].pop_back();
+        mVel[axis].pop_back();
+        mThrust[axis].pop_back();
+    }
+    mDistance.pop_back();
+}
+
+/*
+ * @brief:
+ *         Gathers positions and velocities into the SoA buffers and runs
+ *         the PD kernel.
+ *
+ * @param: drones
+ *         Drone list indexed by drone ID.
+ * @param: gravity
+ *         World gravity vector.
+ */
+
+template <std::size_t N>
+void BasicFormationController<N>::compute(const std::vector<BasicDrone<N>>& drones, const Vec& gravity) {
+    const std::size_t n = mDroneIds.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const BasicDrone<N>& d = drones[mDroneIds[i]];
+        for (std::size_t axis = 0; axis < N; ++axis) {
+            mPos[axis][i] = d.getPosition()[axis];
+            mVel[axis][i] = d.getVelocity()[axis];
+        }
+    }
+
+    computeKernel(gravity);
+}
+
+/*
+ * @brief:
+ *         Computes thrust for all slots.
+ *
+ * The arithmetic is performed in the same order as the original per-drone
+ * controller so both paths produce identical results:
+ *   acc   = toTarget * kP - vel * kD
+ *   force = acc * mass - gravity * mass
+ * Slots inside stopRadius get zero thrust. The axis loops have a constant
+ * trip count N and are fully unrolled, so the 2D kernel is the same code as
+ * a hand-written x/y version.
+ */
+
+template <std::size_t N>
+void BasicFormationController<N>::computeKernel(const Vec& gravity) {
+    const std::size_t n = mDroneIds.size();
+    std::size_t i = 0;
+
+#if defined(__AVX__)
+    const __m256d vRadius = _mm256_set1_pd(mStopRadius);
+    __m256d vG[N];
+    for (std::size_t axis = 0; axis < N; ++axis) vG[axis] = _mm256_set1_pd(gravity[axis]);
+
+    for (; i + 4 <= n; i += 4) {
+        __m256d d[N];
+        for (std::size_t axis = 0; axis < N; ++axis) {
+            d[axis] = _mm256_sub_pd(_mm256_loadu_pd(&mTarget[axis][i]), _mm256_loadu_pd(&mPos[axis][i]));
+        }
+        __m256d sq = _mm256_mul_pd(d[0], d[0]);
+        for (std::size_t axis = 1; axis < N; ++axis) sq = _mm256_add_pd(sq, _mm256_mul_pd(d[axis], d[axis]));
+        __m256d dist = _mm256_sqrt_pd(sq);
+
+        __m256d kP = _mm256_loadu_pd(&mKp[i]);
+        __m256d kD = _mm256_loadu_pd(&mKd[i]);
+        __m256d m = _mm256_loadu_pd(&mMass[i]);
+
+        // Deadband: keep the force only where dist > stopRadius
+        __m256d active = _mm256_cmp_pd(dist, vRadius, _CMP_GT_OQ);
+        for (std::size_t axis = 0; axis < N; ++axis) {
+            __m256d a = _mm256_sub_pd(_mm256_mul_pd(d[axis], kP), _mm256_mul_pd(_mm256_loadu_pd(&mVel[axis][i]), kD));
+            __m256d f = _mm256_sub_pd(_mm256_mul_pd(a, m), _mm256_mul_pd(vG[axis], m));
+            _mm256_storeu_pd(&mThrust[axis][i], _mm256_and_pd(f, active));
+        }
+        _mm256_storeu_pd(&mDistance[i], dist);
+    }
+#endif
+
+    // Scalar path (also the tail of the vector loop). Written branch-free so
+    // compilers can auto-vectorize it when AVX is not enabled.
+    for (; i < n; ++i) {
+        double d[N];
+        for (std::size_t axis = 0; axis < N; ++axis) d[axis] = mTarget[axis][i] - mPos[axis][i];
+        double sq = d[0] * d[0];
+        for (std::size_t axis = 1; axis < N; ++axis) sq += d[axis] * d[axis];
+        double dist = std::sqrt(sq);
+
+        double active = (dist > mStopRadius) ? 1.0 : 0.0;
+        for (std::size_t axis = 0; axis < N; ++axis) {
+            double a = d[axis] * mKp[i] - mVel[axis][i] * mKd[i];
+            double f = a * mMass[i] - gravity[axis] * mMass[i];
+            mThrust[axis][i] = f * active;
+        }
+        mDistance[i] = dist;
+    }
+}
+
+template class BasicFormationController<2>;
+template class BasicFormationController<3>;
@@ -0,0 +1,186 @@
+#ifndef FORMATION_CONTROLLER_H
+#define FORMATION_CONTROLLER_H
+
+#include <cstddef>
+#include <vector>
+#include "Drone.h"
+#include "Vector2.h"
+#include "Vector3.h"
+
+/*
+ * @class:
+ *         BasicFormationController<N>
+ * @brief:
+ *         Batched proportional-derivative controller that steers a group of
+ *         drones toward fixed formation targets (FormationController = 2D,
+ *         FormationController3 = 3D).
+ *
+ * All per-drone data (targets, gains, masses, gathered state and output
+ * thrust) is stored as structure-of-arrays, one array per axis, so that the
+ * whole swarm is processed in one vectorized pass with four drones per AVX
+ * register whatever N is:
+ *
+ *   toTarget = target - pos
+ *   force    = (toTarget * kP - vel * kD) * mass - gravity * mass
+ *
+ * Drones closer to their target than stopRadius receive zero thrust
+ * (deadband), which matches Drone::clearThrust().
+ *
+ * Typical usage per step:
+ *   controller.compute(sim.getDrones(), world.gravity);
+ *   sim.setDroneThrustForces(controller.droneIds(), controller.thrustX(),
+ *                            controller.thrustY(), controller.size());
+ */
+
+template <std::size_t N>
+class BasicFormationController {
+public:
+
+    using Vec = Vector<N>;
+
+    /*
+     * @brief:
+     *         Constructs an empty controller.
+     *
+     * @param: stopRadius
+     *         Distance to target below which thrust is switched off.
+     */
+
+    explicit BasicFormationController(double stopRadius);
+
+    /*
+     * @brief:
+     *         Registers a drone with its formation target and control gains.
+     *
+     * @param: droneId
+     *         ID of the drone in the Simulator.
+     * @param: target
+     *         Absolute target position in world coordinates.
+     * @param: kP
+     *         Proportional gain.
+     * @param: kD
+     *         Derivative gain.
+     * @param: mass
+     *         Drone mass used to convert acceleration into force.
+     * @return: Slot index of the drone inside the controller.
+     */
+
+    std::size_t addDrone(int droneId, const Vec& target,
+        double kP, double kD, double mass);
+
+    /*
+     * @brief:
+     *         Moves the target of a single controller slot.
+     */
+
+    void setTarget(std::size_t slot, const Vec& target);
+
+    /*
+     * @brief:
+     *         Points a slot at another drone index, e.g. after
+     *         Simulator::removeDrone() moved its drone.
+     */
+
+    void setDroneId(std::size_t slot, int droneId) { mDroneIds[slot] = droneId; }
+
+    /*
+     * @brief:
+     *         Removes a slot in O(1): the last slot moves into its place.
+     */
+
+    void removeDrone(std::size_t slot);
+
+    /*
+     * @brief:
+     *         Gathers the current drone state and computes thrust commands
+     *         for every registered drone in a single SIMD pass.
+     *
+     * @param: drones
+     *         Drone list as returned by Simulator::getDrones().
+     * @param: gravity
+     *         World gravity vector (compensated by the controller).
+     */
+
+    void compute(const std::vector<BasicDrone<N>>& drones, const Vec& gravity);
+
+    /*
+     * @return: Number of drones managed by the controller.
+     */
+
+    std::size_t size() const { return mDroneIds.size(); }
+
+    /*
+     * @return: Simulator drone IDs, one per slot.
+     */
+
+    const int* droneIds() const { return mDroneIds.data(); }
+
+    /*
+     * @return: Thrust components along an axis produced by the last compute().
+     */
+
+    const double* thrust(std::size_t axis) const { return mThrust[axis].data(); }
+
+    /*
+     * @return: Thrust x-components produced by the last compute().
+     */
+
+    const double* thrustX() const { return mThrust[0].data(); }
+
+    /*
+     * @return: Thrust y-components produced by the last compute().
+     */
+
+    const double* thrustY() const { return mThrust[1].data(); }
+
+    /*
+     * @return: Target position of the given slot.
+     */
+
+    Vec target(std::size_t slot) const {
+        Vec t;
+        for (std::size_t axis = 0; axis < N; ++axis) t[axis] = mTarget[axis][slot];
+        return t;
+    }
+
+    /*
+     * @return: Distance to target measured during the last compute().
+     */
+
+    double distanceToTarget(std::size_t slot) const { return mDistance[slot]; }
+
+private:
+
+    /*
+     * @brief:
+     *         PD kernel over contiguous arrays. Processes four drones per
+     *         iteration when AVX is available, with a scalar tail.
+     */
+
+    void computeKernel(const Vec& gravity);
+
+    double mStopRadius;
+
+    // Per-drone configuration
+    std::vector<int> mDroneIds;
+    std::vector<double> mTarget[N];
+    std::vector<double> mKp;
+    std::vector<double> mKd;
+    std::vector<double> mMass;
+
+    // Gathered state (refreshed every compute())
+    std::vector<double> mPos[N];
+    std::vector<double> mVel[N];
+
+    // Outputs
+    std::vector<double> mThrust[N];
+    std::vector<double> mDistance;
+};
+
+using FormationController = BasicFormationController<2>;
+using FormationController3 = BasicFormationController<3>;
+
+extern template class BasicFormationController<2>;
+extern template class BasicFormationController<3>;
+
+#endif // FORMATION_CONTROLLER_H
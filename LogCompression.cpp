@@ -0,0 +1,427 @@
+#include "LogCompression.h"
+#include "Profiler.h"
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+    constexpr int kHashBits = 16;
+    constexpr std::size_t kMinMatch = 4;
+    constexpr std::size_t kMaxOffset = 65535;
+    constexpr std::size_t kMaxQueuedBlocks = 4;
+
+    std::uint32_t read32(const unsigned char* p) {
+        std::uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    std::uint32_t hash32(std::uint32_t v) {
+        return (v * 2654435761u) >> (32 - kHashBits);
+    }
+
+    // lengths >= 15 continue in 255-valued extension bytes
+    void putLength(std::string& out, std::size_t extra) {
+        while (extra >= 255) {
+            out.push_back(static_cast<char>(255));
+            extra -= 255;
+        }
+        out.push_back(static_cast<char>(extra));
+    }
+
+    void putSequence(std::string& out, const unsigned char* literals, std::size_t literalCount,
+        std::size_t offset, std::size_t matchLength)
+    {
+        std::size_t litNibble = literalCount < 15 ? literalCount : 15;
+        std::size_t matchCode = matchLength ? matchLength - kMinMatch : 0;
+        std::size_t matchNibble = matchCode < 15 ? matchCode : 15;
+        out.push_back(static_cast<char>((litNibble << 4) | matchNibble));
+        if (litNibble == 15) putLength(out, literalCount - 15);
+        out.append(reinterpret_cast<const char*>(literals), literalCount);
+        if (matchLength == 0) return;   // last sequence: literals only
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (matchNibble == 15) putLength(out, matchCode - 15);
+    }
+
+    bool getLength(const unsigned char*& p, const unsigned char* end, std::size_t& length) {
+        for (;;) {
+            if (p >= end) return false;
+            unsigned char b = *p++;
+            length += b;
+            if (b != 255) return true;
+        }
+    }
+
+    // --- TelemetryColumns filter -------------------------------------------
+
+    struct ColumnLayout {
+        std::size_t frames;
+        std::size_t drones;
+        std::size_t steps;     // offset of steps[frames]
+        std::size_t times;     // offset of times[frames]
+        std::size_t columns;   // offset of x[frames][drones], then y, vx, vy
+    };
+
+    bool columnLayout(const std::string& block, ColumnLayout& layout) {
+        if (block.size() < 8) return false;
+        std::uint32_t frames, drones;
+        std::memcpy(&frames, block.data(), 4);
+        std::memcpy(&drones, block.data() + 4, 4);
+        layout.frames = frames;
+        layout.drones = drones;
+        layout.steps = 8;
+        layout.times = layout.steps + 8 * layout.frames;
+        layout.columns = layout.times + 8 * layout.frames + 4 * layout.drones;
+        return block.size() == layout.columns + 4 * 8 * layout.frames * layout.drones;
+    }
+
+    // XOR each value with the value 'stride' entries before it
+    void xorForward(char* base, std::size_t frames, std::size_t stride) {
+        for (std::size_t k = frames; k-- > 1;) {
+            for (std::size_t d = 0; d < stride; ++d) {
+                std::uint64_t cur, prev;
+                std::memcpy(&cur, base + 8 * (k * stride + d), 8);
+                std::memcpy(&prev, base + 8 * ((k - 1) * stride + d), 8);
+                cur ^= prev;
+                std::memcpy(base + 8 * (k * stride + d), &cur, 8);
+            }
+        }
+    }
+
+    void xorInverse(char* base, std::size_t frames, std::size_t stride) {
+        for (std::size_t k = 1; k < frames; ++k) {
+            for (std::size_t d = 0; d < stride; ++d) {
+                std::uint64_t cur, prev;
+                std::memcpy(&cur, base + 8 * (k * stride + d), 8);
+                std::memcpy(&prev, base + 8 * ((k - 1) * stride + d), 8);
+                cur ^= prev;
+                std::memcpy(base + 8 * (k * stride + d), &cur, 8);
+            }
+        }
+    }
+
+    void shuffle(char* base, std::size_t count, std::string& scratch) {
+        scratch.assign(base, 8 * count);
+        for (std::size_t i = 0; i < count; ++i) {
+            for (std::size_t b = 0; b < 8; ++b) base[b * count + i] = scratch[i * 8 + b];
+        }
+    }
+
+    void unshuffle(char* base, std::size_t count, std::string& scratch) {
+        scratch.assign(base, 8 * count);
+        for (std::size_t i = 0; i < count; ++i) {
+            for (std::size_t b = 0; b < 8; ++b) base[i * 8 + b] = scratch[b * count + i];
+        }
+    }
+
+    void transformColumns(std::string& block, const ColumnLayout& l, bool forward) {
+        std::string scratch;
+        char* p = &block[0];
+        struct Section { std::size_t offset; std::size_t stride; };
+        const std::size_t columnBytes = 8 * l.frames * l.drones;
+        const Section sections[] = {
+            { l.steps, 1 },
+            { l.times, 1 },
+            { l.columns, l.drones },
+            { l.columns + columnBytes, l.drones },
+            { l.columns + 2 * columnBytes, l.drones },
+            { l.columns + 3 * columnBytes, l.drones },
+        };
+        for (const Section& s : sections) {
+            std::size_t count = l.frames * s.stride;
+            if (forward) {
+                xorForward(p + s.offset, l.frames, s.stride);
+                shuffle(p + s.offset, count, scratch);
+            }
+            else {
+                unshuffle(p + s.offset, count, scratch);
+                xorInverse(p + s.offset, l.frames, s.stride);
+            }
+        }
+    }
+}
+
+namespace LogCompression {
+
+    /*
+     * @brief:
+     *         Greedy single-probe LZ77: one hash table slot per 4-byte
+     *         prefix, skipping ahead faster through incompressible data.
+     */
+
+    void compress(const char* data, std::size_t size, std::string& out) {
+        out.clear();
+        out.reserve(size + size / 255 + 16);
+        const unsigned char* src = reinterpret_cast<const unsigned char*>(data);
+
+        std::size_t anchor = 0;
+        if (size > 12) {
+            std::vector<std::uint32_t> table(std::size_t(1) << kHashBits, 0);   // position + 1
+            const std::size_t limit = size - 12;   // keep the tail as literals
+            std::size_t ip = 0;
+            while (ip < limit) {
+                std::uint32_t seq = read32(src + ip);
+                std::uint32_t& slot = table[hash32(seq)];
+                std::size_t ref = slot;
+                slot = static_cast<std::uint32_t>(ip + 1);
+
+                if (ref == 0 || ip - (ref - 1) > kMaxOffset || read32(src + ref - 1) != seq) {
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+                --ref;
+
+                std::size_t length = kMinMatch;
+                while (ip + length < size && src[ref + length] == src[ip + length]) ++length;
+
+                putSequence(out, src + anchor, ip - anchor, ip - ref, length);
+                ip += length;
+                anchor = ip;
+            }
+        }
+        putSequence(out, src + anchor, size - anchor, 0, 0);
+    }
+
+    bool decompress(const char* data, std::size_t size, std::size_t rawSize, std::string& out) {
+        out.resize(rawSize);
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+        const unsigned char* end = p + size;
+        std::size_t op = 0;
+
+        while (p < end) {
+            unsigned char token = *p++;
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !getLength(p, end, literals)) return false;
+            if (literals > static_cast<std::size_t>(end - p) || literals > rawSize - op) return false;
+            std::memcpy(&out[op], p, literals);
+            p += literals;
+            op += literals;
+            if (p == end) break;   // last sequence
+
+            if (end - p < 2) return false;
+            std::size_t offset = static_cast<std::size_t>(p[0]) | (static_cast<std::size_t>(p[1]) << 8);
+            p += 2;
+            std::size_t length = token & 0x0F;
+            if (length == 15 && !getLength(p, end, length)) return false;
+            length += kMinMatch;
+            if (offset == 0 || offset > op || length > rawSize - op) return false;
+
+            // byte by byte: the match may overlap the bytes it produces
+            for (std::size_t i = 0; i < length; ++i, ++op) out[op] = out[op - offset];
+        }
+        return op == rawSize;
+    }
+
+    bool applyFilter(BlockFilter filter, std::string& block) {
+        if (filter == BlockFilter::None) return true;
+        ColumnLayout layout;
+        if (filter != BlockFilter::TelemetryColumns || !columnLayout(block, layout)) return false;
+        transformColumns(block, layout, true);
+        return true;
+    }
+
+    bool removeFilter(BlockFilter filter, std::string& block) {
+        if (filter == BlockFilter::None) return true;
+        ColumnLayout layout;
+        if (filter != BlockFilter::TelemetryColumns || !columnLayout(block, layout)) return false;
+        transformColumns(block, layout, false);
+        return true;
+    }
+}
+
+/*
+ * @brief:
+ *         Opens the file, writes the file header and starts the worker.
+ */
+
+CompressedLogWriter::CompressedLogWriter(const std::string& path, std::size_t blockSize)
+    : mFile(path, std::ios::binary),
+    mBlockSize(blockSize ? blockSize : 1),
+    mRawBytes(&MetricsRegistry::global().counter("log.compress_raw_bytes")),
+    mStoredBytes(&MetricsRegistry::global().counter("log.compress_stored_bytes")),
+    mWaitNs(&MetricsRegistry::global().counter("log.compress_wait_ns"))
+{
+    if (!mFile) {
+        mError = "could not open " + path + " for writing";
+        return;
+    }
+
+    char header[LogCompression::kFileHeaderSize] = {};
+    std::memcpy(header, &LogCompression::kMagic, 4);
+    std::memcpy(header + 4, &LogCompression::kVersion, 2);
+    mFile.write(header, sizeof(header));
+
+    mPending.reserve(mBlockSize);
+    mOpen = true;
+    mWorker = std::thread(&CompressedLogWriter::workerLoop, this);
+}
+
+CompressedLogWriter::~CompressedLogWriter() {
+    close();
+}
+
+void CompressedLogWriter::write(const char* data, std::size_t size) {
+    if (!mOpen) return;
+    while (size > 0) {
+        std::size_t take = mBlockSize - mPending.size();
+        if (take > size) take = size;
+        mPending.append(data, take);
+        data += take;
+        size -= take;
+        if (mPending.size() == mBlockSize) {
+            submit(std::move(mPending), LogCompression::BlockFilter::None);
+            mPending = std::string();
+            mPending.reserve(mBlockSize);
+        }
+    }
+}
+
+void CompressedLogWriter::writeBlock(std::string&& block, LogCompression::BlockFilter filter) {
+    if (!mOpen) return;
+    if (!mPending.empty()) {
+        submit(std::move(mPending), LogCompression::BlockFilter::None);
+        mPending = std::string();
+    }
+    submit(std::move(block), filter);
+}
+
+/*
+ * @brief:
+ *         Queues a block, waiting while the worker is kMaxQueuedBlocks
+ *         behind.
+ */
+
+void CompressedLogWriter::submit(std::string&& data, LogCompression::BlockFilter filter) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mQueue.size() >= kMaxQueuedBlocks) {
+        PROFILE_SCOPE("log.compress_wait");
+        auto start = std::chrono::steady_clock::now();
+        mHasRoom.wait(lock, [this] { return mQueue.size() < kMaxQueuedBlocks; });
+        mWaitNs->add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    }
+    mQueue.push_back(Job{ std::move(data), filter });
+    lock.unlock();
+    mHasWork.notify_one();
+}
+
+void CompressedLogWriter::workerLoop() {
+    std::string compressed;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mHasWork.wait(lock, [this] { return mStop || !mQueue.empty(); });
+            if (mQueue.empty()) return;   // stopped and drained
+            job = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+        mHasRoom.notify_one();
+
+        const std::uint32_t rawSize = static_cast<std::uint32_t>(job.data.size());
+        if (!LogCompression::applyFilter(job.filter, job.data)) {
+            job.filter = LogCompression::BlockFilter::None;   // wrong layout: keep it unfiltered
+        }
+        LogCompression::compress(job.data.data(), job.data.size(), compressed);
+
+        std::uint8_t codec = 1;
+        const std::string* payload = &compressed;
+        if (compressed.size() >= job.data.size()) {
+            codec = 0;   // incompressible: store
+            payload = &job.data;
+        }
+
+        char header[LogCompression::kBlockHeaderSize] = {};
+        header[0] = static_cast<char>(job.filter);
+        header[1] = static_cast<char>(codec);
+        std::uint32_t size = static_cast<std::uint32_t>(payload->size());
+        std::memcpy(header + 4, &rawSize, 4);
+        std::memcpy(header + 8, &size, 4);
+        mFile.write(header, sizeof(header));
+        mFile.write(payload->data(), static_cast<std::streamsize>(payload->size()));
+
+        mRawBytes->add(rawSize);
+        mStoredBytes->add(sizeof(header) + payload->size());
+    }
+}
+
+void CompressedLogWriter::close() {
+    if (!mOpen) return;
+    if (!mPending.empty()) {
+        submit(std::move(mPending), LogCompression::BlockFilter::None);
+        mPending = std::string();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mHasWork.notify_one();
+    mWorker.join();
+    mFile.close();
+    mOpen = false;
+}
+
+/*
+ * @brief:
+ *         Opens a compressed log and checks its file header.
+ */
+
+CompressedLogReader::CompressedLogReader(const std::string& path)
+    : mFile(path, std::ios::binary)
+{
+    char header[LogCompression::kFileHeaderSize];
+    if (!mFile || !mFile.read(header, sizeof(header))) {
+        mError = "could not read " + path;
+        return;
+    }
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::memcpy(&magic, header, 4);
+    std::memcpy(&version, header + 4, 2);
+    if (magic != LogCompression::kMagic || version != LogCompression::kVersion) {
+        mError = path + ": not a compressed log";
+        return;
+    }
+    mOpen = true;
+}
+
+bool CompressedLogReader::nextBlock(std::string& block, LogCompression::BlockFilter& filter) {
+    if (!mOpen) return false;
+
+    char header[LogCompression::kBlockHeaderSize];
+    if (!mFile.read(header, sizeof(header))) {
+        if (mFile.gcount() != 0) mError = "truncated block header";
+        return false;
+    }
+
+    std::uint32_t rawSize, size;
+    std::memcpy(&rawSize, header + 4, 4);
+    std::memcpy(&size, header + 8, 4);
+    filter = static_cast<LogCompression::BlockFilter>(header[0]);
+    std::uint8_t codec = static_cast<std::uint8_t>(header[1]);
+
+    mStored.resize(size);
+    if (size > 0 && !mFile.read(&mStored[0], size)) {
+        mError = "truncated block";
+        return false;
+    }
+
+    if (codec == 0) {
+        if (size != rawSize) {
+            mError = "corrupt stored block";
+            return false;
+        }
+        block.swap(mStored);
+    }
+    else if (codec != 1 || !LogCompression::decompress(mStored.data(), mStored.size(), rawSize, block)) {
+        mError = "corrupt compressed block";
+        return false;
+    }
+
+    if (!LogCompression::removeFilter(filter, block)) {
+        mError = "block does not match its filter";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,206 @@
+#ifndef LOG_COMPRESSION_H
+#define LOG_COMPRESSION_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Metrics.h"
+
+/*
+ * @brief:
+ *         Dependency-free block compression for the log outputs.
+ *
+ * A compressed log (".lz") is a 16-byte file header followed by
+ * independent blocks:
+ *
+ *   file header                     block header (12 bytes)
+ *   0   4  magic "DSLZ"             0   1  filter   (BlockFilter)
+ *   4   2  version 1                1   1  codec    0 = stored, 1 = LZ
+ *   6   10 reserved (0)             2   2  reserved (0)
+ *                                   4   4  rawSize  bytes after decoding
+ *                                   8   4  size     bytes that follow
+ *
+ * The codec is a byte-oriented LZ77 in the LZ4 style: each sequence is a
+ * token (literal count, match length - 4), the literals, a 16-bit offset
+ * into the last 64 KB and optional length extension bytes. A block is
+ * stored verbatim when compression does not make it smaller.
+ *
+ * Filters are applied before compression and undone after decoding.
+ * TelemetryColumns expects the block layout written by
+ * CompressedTelemetrySink: each value is XORed with the same drone's value
+ * in the previous frame (slowly changing doubles then differ only in their
+ * low mantissa bytes) and each column is byte-shuffled (all first bytes,
+ * then all second bytes, ...), which turns the unchanged high bytes into
+ * long runs the LZ stage removes.
+ */
+
+namespace LogCompression {
+
+    constexpr std::uint32_t kMagic = 0x5A4C5344;   // "DSLZ" in little-endian byte order
+    constexpr std::uint16_t kVersion = 1;
+    constexpr std::size_t kFileHeaderSize = 16;
+    constexpr std::size_t kBlockHeaderSize = 12;
+
+    enum class BlockFilter : std::uint8_t {
+        None = 0,
+        TelemetryColumns = 1
+    };
+
+    /*
+     * @brief:
+     *         LZ-compresses 'size' bytes, replacing the contents of 'out'.
+     */
+
+    void compress(const char* data, std::size_t size, std::string& out);
+
+    /*
+     * @brief:
+     *         Decodes an LZ block that expands to exactly 'rawSize' bytes.
+     *
+     * @return:
+     *         false if the input is malformed.
+     */
+
+    bool decompress(const char* data, std::size_t size, std::size_t rawSize, std::string& out);
+
+    /*
+     * @brief:
+     *         Applies / removes a filter in place.
+     *
+     * @return:
+     *         false if the block does not have the filter's layout.
+     */
+
+    bool applyFilter(BlockFilter filter, std::string& block);
+
+    bool removeFilter(BlockFilter filter, std::string& block);
+}
+
+/*
+ * @class:
+ *         CompressedLogWriter
+ * @brief:
+ *         Writes a compressed log, compressing on a background thread.
+ *
+ * write() only copies into the current block; full blocks are queued to a
+ * worker thread that filters, compresses and writes them in order. If the
+ * worker falls more than a few blocks behind, write() waits for it, so
+ * memory stays bounded.
+ */
+
+class CompressedLogWriter {
+public:
+
+    /*
+     * @param: path
+     *         Output file (truncated).
+     * @param: blockSize
+     *         Bytes of input per block for write().
+     */
+
+    explicit CompressedLogWriter(const std::string& path, std::size_t blockSize = 1 << 20);
+
+    ~CompressedLogWriter();
+
+    CompressedLogWriter(const CompressedLogWriter&) = delete;
+    CompressedLogWriter& operator=(const CompressedLogWriter&) = delete;
+
+    bool isOpen() const { return mOpen; }
+
+    const std::string& error() const { return mError; }
+
+    /*
+     * @brief:
+     *         Appends bytes to the log (unfiltered blocks).
+     */
+
+    void write(const char* data, std::size_t size);
+
+    /*
+     * @brief:
+     *         Queues one complete block with a filter, after any bytes
+     *         pending from write().
+     */
+
+    void writeBlock(std::string&& block, LogCompression::BlockFilter filter);
+
+    /*
+     * @brief:
+     *         Compresses everything still pending, waits for the worker and
+     *         closes the file.
+     */
+
+    void close();
+
+private:
+    struct Job {
+        std::string data;
+        LogCompression::BlockFilter filter;
+    };
+
+    void submit(std::string&& data, LogCompression::BlockFilter filter);
+
+    void workerLoop();
+
+    bool mOpen = false;
+    std::string mError;
+    std::ofstream mFile;
+    std::size_t mBlockSize;
+    std::string mPending;
+
+    std::thread mWorker;
+    std::mutex mMutex;
+    std::condition_variable mHasWork;
+    std::condition_variable mHasRoom;
+    std::deque<Job> mQueue;
+    bool mStop = false;
+
+    Counter* mRawBytes;
+    Counter* mStoredBytes;
+    Counter* mWaitNs;
+};
+
+/*
+ * @class:
+ *         CompressedLogReader
+ * @brief:
+ *         Reads a compressed log back block by block.
+ */
+
+class CompressedLogReader {
+public:
+    explicit CompressedLogReader(const std::string& path);
+
+    bool isOpen() const { return mOpen; }
+
+    /*
+     * @brief:
+     *         Set when a block is corrupt or truncated.
+     */
+
+    const std::string& error() const { return mError; }
+
+    /*
+     * @brief:
+     *         Decodes the next block (filter already removed).
+     *
+     * @return:
+     *         false at the end of the file or on error().
+     */
+
+    bool nextBlock(std::string& block, LogCompression::BlockFilter& filter);
+
+private:
+    bool mOpen = false;
+    std::string mError;
+    std::ifstream mFile;
+    std::string mStored;
+};
+
+#endif // LOG_COMPRESSION_H
@@ -0,0 +1,195 @@
+#pragma once
+#include "Metrics.h"
+#include "RadioLinks.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// AODV-style on-demand routing over the radio neighbor graph.
+//
+// Every node keeps a route cache (destination -> next hop, hop count).
+// nextHop() answers from the cache when the cached next hop is still within
+// radio range and the route fits the message's remaining hop budget;
+// otherwise it runs a route discovery: a breadth-first flood (RREQ) over
+// RadioLinkModel::neighbors() bounded by that budget. The path found
+// installs forward routes towards the destination and reverse routes back to
+// the origin on every node along it.
+//
+// Invalidation is incremental. When nodes cross a grid cell the Network
+// passes them to onTopologyChange(), which drops only those nodes' own
+// caches. Routes elsewhere that relied on a moved node are caught lazily:
+// the next-hop link is range-checked on every use, and a broken hop counts
+// as a route error and triggers a local re-discovery from that node.
+// A removed node is different: its index may be handed to a newcomer, so
+// forgetNode() purges every route to or through it right away.
+class MeshRouter {
+public:
+    MeshRouter(const RadioLinkModel& links, int maxHops)
+        : links_(links), maxHops_(maxHops)
+    {
+        MetricsRegistry& metrics = MetricsRegistry::global();
+        discoveries_ = &metrics.counter("mesh.route_discoveries");
+        rreqTransmissions_ = &metrics.counter("mesh.rreq_transmissions");
+        routeErrors_ = &metrics.counter("mesh.route_errors");
+        noRoute_ = &metrics.counter("mesh.no_route");
+        cacheHits_ = &metrics.counter("mesh.cache_hits");
+        invalidations_ = &metrics.counter("mesh.cache_invalidations");
+        hopCount_ = &metrics.histogram("mesh.hops");
+    }
+
+    // next hop from 'node' towards 'dest' on a route of at most 'hopBudget'
+    // hops (default and upper bound: maxHops), or -1 when no such route exists
+    int nextHop(int node, int dest, int hopBudget = -1) {
+        if (node == dest) return dest;
+        ensureNode(node > dest ? node : dest);
+        int budget = hopBudget < 0 || hopBudget > maxHops_ ? maxHops_ : hopBudget;
+
+        auto& cache = routes_[node];
+        auto it = cache.find(dest);
+        if (it != cache.end()) {
+            // a hop that lost its position has left the network
+            if (!links_.hasPosition(it->second.nextHop) || !links_.inRange(node, it->second.nextHop)) {
+                // cached hop moved out of range: route error, repair locally
+                routeErrors_->add();
+                cache.erase(it);
+            }
+            else if (it->second.hops <= budget) {
+                cacheHits_->add();
+                return it->second.nextHop;
+            }
+            // else: longer than the message may still travel, look for a
+            // shorter route
+        }
+
+        return discover(node, dest, budget);
+    }
+
+    // called once per tick with the nodes that changed grid cell
+    void onTopologyChange(const std::vector<int>& movedNodes) {
+        for (int node : movedNodes) {
+            if (node < static_cast<int>(routes_.size()) && !routes_[node].empty()) {
+                invalidations_->add(routes_[node].size());
+                routes_[node].clear();
+            }
+        }
+    }
+
+    // called when a node leaves the network (its index may be reused): drops
+    // its own cache and every cached route to it or through it. Scans all
+    // route caches, O(total cached routes).
+    void forgetNode(int node) {
+        if (node >= static_cast<int>(routes_.size())) return;
+        std::uint64_t dropped = routes_[node].size();
+        routes_[node].clear();
+        for (auto& cache : routes_) {
+            for (auto it = cache.begin(); it != cache.end(); ) {
+                if (it->first == node || it->second.nextHop == node) {
+                    it = cache.erase(it);
+                    ++dropped;
+                }
+                else ++it;
+            }
+        }
+        if (dropped > 0) invalidations_->add(dropped);
+    }
+
+    // number of cached routes (over all nodes) that lead to or through 'node'
+    std::size_t routesVia(int node) const {
+        std::size_t count = 0;
+        for (const auto& cache : routes_) {
+            for (const auto& entry : cache) {
+                if (entry.first == node || entry.second.nextHop == node) ++count;
+            }
+        }
+        return count;
+    }
+
+    // number of routes cached at 'node'
+    std::size_t cachedRoutes(int node) const {
+        return node < static_cast<int>(routes_.size()) ? routes_[node].size() : 0;
+    }
+
+    // record the hop count of a message that reached its destination
+    void recordDelivery(int hops) {
+        hopCount_->observe(static_cast<std::uint64_t>(hops));
+    }
+
+    int maxHops() const { return maxHops_; }
+
+private:
+    struct RouteEntry {
+        int nextHop;
+        int hops;
+    };
+
+    void ensureNode(int node) {
+        if (node >= static_cast<int>(routes_.size())) routes_.resize(node + 1);
+    }
+
+    // RREQ flood from 'origin' up to 'budget' hops; installs routes along
+    // the path found
+    int discover(int origin, int dest, int budget) {
+        discoveries_->add();
+
+        parent_.assign(routes_.size(), -1);
+        depth_.assign(routes_.size(), -1);
+        frontier_.clear();
+        frontier_.push_back(origin);
+        depth_[origin] = 0;
+
+        bool found = false;
+        for (size_t head = 0; head < frontier_.size() && !found; ++head) {
+            int node = frontier_[head];
+            if (depth_[node] >= budget) continue;
+
+            rreqTransmissions_->add();   // node rebroadcasts the RREQ
+            links_.neighbors(node, neighbors_);
+            for (int next : neighbors_) {
+                if (next >= static_cast<int>(depth_.size())) {
+                    ensureNode(next);
+                    parent_.resize(routes_.size(), -1);
+                    depth_.resize(routes_.size(), -1);
+                }
+                if (depth_[next] >= 0) continue;
+                depth_[next] = depth_[node] + 1;
+                parent_[next] = node;
+                if (next == dest) { found = true; break; }
+                frontier_.push_back(next);
+            }
+        }
+
+        if (!found) {
+            noRoute_->add();
+            return -1;
+        }
+
+        // walk back dest -> origin, installing forward and reverse routes
+        int total = depth_[dest];
+        int child = dest;
+        for (int node = parent_[dest]; node >= 0; child = node, node = parent_[node]) {
+            routes_[node][dest] = { child, total - depth_[node] };
+            routes_[child][origin] = { node, depth_[child] };
+        }
+        return routes_[origin][dest].nextHop;
+    }
+
+    const RadioLinkModel& links_;
+    int maxHops_;
+
+    // per-node route cache: destination -> entry
+    std::vector<std::unordered_map<int, RouteEntry>> routes_;
+
+    // discovery scratch
+    std::vector<int> parent_;
+    std::vector<int> depth_;
+    std::vector<int> frontier_;
+    std::vector<int> neighbors_;
+
+    Counter* discoveries_;
+    Counter* rreqTransmissions_;
+    Counter* routeErrors_;
+    Counter* noRoute_;
+    Counter* cacheHits_;
+    Counter* invalidations_;
+    Histogram* hopCount_;
+};
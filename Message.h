@@ -1,14 +1,47 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
 
 struct Message {
     int id;
     std::string from;
     std::string to;
-    std::string payload;      // plaintext (used at endpoints)
-    std::string cipherText;   // what travels over the network
+    std::string payload;      // plaintext at the sender
+
+    // what travels over the network: immutable and reference-counted, so
+    // every recipient of a broadcast/multicast shares one encrypted buffer
+    std::shared_ptr<const std::string> cipherText;
+    std::uint64_t nonceId = 0;  // nonce the buffer was encrypted with
+
+    // plaintext decrypted at the destination; recipients of one shared
+    // cipherText also share one decrypted buffer
+    std::shared_ptr<const std::string> plainText;
+
     double sendTime = 0.0;
     double deliverTime = 0.0;
     bool delivered = false;
     bool dropped = false;
+
+    // node the message arrives at on this hop (-1 = unknown)
+    int atNode = -1;
+
+    // mesh routing state (node indices; -1 = direct single-hop delivery)
+    int destNode = -1;        // final destination
+    int hops = 0;             // hops taken so far
+
+    // generations of atNode / destNode when the hop was sent; indices are
+    // reused after Network::removeNode, so a mismatch means the node left
+    std::uint32_t atGeneration = 0;
+    std::uint32_t destGeneration = 0;
+
+    // passed the receiving node's radio queue on this hop (bandwidth model)
+    bool received = false;
+};
+
+// one entry of a batched send (Network::sendMessages)
+struct OutgoingMessage {
+    std::string from;
+    std::string to;
+    std::string payload;
 };
@@ -0,0 +1,378 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// Compact binary payloads for Network messages.
+//
+// A frame is a magic byte, a message type byte, then the fields of the
+// message struct in schema order:
+//   - integers: LEB128 varints (signed types zigzag-encoded first)
+//   - reals:    fixed-point, round(value * scale) as a zigzag varint
+//   - text:     varint length followed by the bytes
+//
+// Encoding fails (nothing is appended) if a real is NaN or infinite, or if
+// value * scale does not fit in 64 bits. Decoding fails on truncated
+// frames and on bytes after the last field.
+//
+// Every message struct lists its fields once, in a static constexpr
+// schema() tuple. encode()/MessageView::decode() are generated from that
+// tuple at compile time (a fold over the fields), so there is no
+// hand-written per-message serialization code.
+//
+// Decoding does not copy the buffer: MessageView wraps the delivered
+// payload and text fields decode to std::string_view into it, valid for as
+// long as the payload string lives.
+namespace codec {
+
+    constexpr std::uint8_t kMagic = 0xD5;
+
+    enum class MessageType : std::uint8_t {
+        Status = 1,
+        Command = 2,
+        Ack = 3,
+        Heartbeat = 4,
+        StatusDelta = 5
+    };
+
+    // fixed-point scale of telemetry positions/velocities (1 unit = 1 mm)
+    constexpr double kTelemetryScale = 1000.0;
+
+    // primitive encodings
+
+    inline void putVarint(std::string& out, std::uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<char>(v));
+    }
+
+    inline std::uint64_t zigzag(std::int64_t v) {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    inline std::int64_t unzigzag(std::uint64_t v) {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    // round(value * scale) as int64; false if it is NaN or out of range
+    inline bool toFixed(double value, double scale, std::int64_t& out) {
+        const double scaled = value * scale;
+        const double limit = 9223372036854775808.0;   // 2^63
+        if (!(scaled >= -limit && scaled < limit)) return false;
+        out = std::llround(scaled);
+        return true;
+    }
+
+    // bounds-checked cursor over an encoded buffer; on overrun it stops
+    // advancing, returns zeros and ok() turns false
+    class Reader {
+    public:
+        explicit Reader(std::string_view buffer)
+            : p_(reinterpret_cast<const unsigned char*>(buffer.data())),
+            end_(p_ + buffer.size()) {
+        }
+
+        bool ok() const { return ok_; }
+        std::size_t remaining() const { return static_cast<std::size_t>(end_ - p_); }
+
+        std::uint64_t varint() {
+            std::uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                if (p_ == end_) break;
+                std::uint8_t b = *p_++;
+                v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            ok_ = false;
+            return 0;
+        }
+
+        std::string_view text() {
+            std::uint64_t n = varint();
+            if (!ok_ || n > remaining()) {
+                ok_ = false;
+                return {};
+            }
+            std::string_view s(reinterpret_cast<const char*>(p_), static_cast<std::size_t>(n));
+            p_ += n;
+            return s;
+        }
+
+    private:
+        const unsigned char* p_;
+        const unsigned char* end_;
+        bool ok_ = true;
+    };
+
+    // field descriptors (schema building blocks)
+
+    template <typename S, typename T>
+    struct VarintField { T S::* member; };
+
+    template <typename S>
+    struct FixedField { double S::* member; double scale; };
+
+    template <typename S, typename T>
+    struct TextField { T S::* member; };
+
+    template <typename S, typename T>
+    constexpr VarintField<S, T> varint(T S::* member) { return { member }; }
+
+    template <typename S>
+    constexpr FixedField<S> fixed(double S::* member, double scale) { return { member, scale }; }
+
+    template <typename S, typename T>
+    constexpr TextField<S, T> text(T S::* member) { return { member }; }
+
+    template <typename S, typename T>
+    bool put(std::string& out, const S& msg, const VarintField<S, T>& f) {
+        if constexpr (std::is_signed_v<T>) putVarint(out, zigzag(static_cast<std::int64_t>(msg.*f.member)));
+        else putVarint(out, static_cast<std::uint64_t>(msg.*f.member));
+        return true;
+    }
+
+    template <typename S>
+    bool put(std::string& out, const S& msg, const FixedField<S>& f) {
+        std::int64_t units = 0;
+        if (!toFixed(msg.*f.member, f.scale, units)) return false;
+        putVarint(out, zigzag(units));
+        return true;
+    }
+
+    template <typename S, typename T>
+    bool put(std::string& out, const S& msg, const TextField<S, T>& f) {
+        std::string_view s = msg.*f.member;
+        putVarint(out, s.size());
+        out.append(s.data(), s.size());
+        return true;
+    }
+
+    template <typename S, typename T>
+    void get(Reader& in, S& msg, const VarintField<S, T>& f) {
+        if constexpr (std::is_signed_v<T>) msg.*f.member = static_cast<T>(unzigzag(in.varint()));
+        else msg.*f.member = static_cast<T>(in.varint());
+    }
+
+    template <typename S>
+    void get(Reader& in, S& msg, const FixedField<S>& f) {
+        msg.*f.member = static_cast<double>(unzigzag(in.varint())) / f.scale;
+    }
+
+    template <typename S, typename T>
+    void get(Reader& in, S& msg, const TextField<S, T>& f) {
+        msg.*f.member = T(in.text());
+    }
+
+    // message types
+
+    // drone -> HQ telemetry; positions/velocities in millimetres
+    struct StatusMsg {
+        static constexpr MessageType kType = MessageType::Status;
+        std::uint32_t droneId = 0;
+        std::uint32_t seq = 0;
+        double x = 0.0, y = 0.0;
+        double vx = 0.0, vy = 0.0;
+
+        static constexpr auto schema() {
+            return std::make_tuple(
+                varint(&StatusMsg::droneId), varint(&StatusMsg::seq),
+                fixed(&StatusMsg::x, kTelemetryScale), fixed(&StatusMsg::y, kTelemetryScale),
+                fixed(&StatusMsg::vx, kTelemetryScale), fixed(&StatusMsg::vy, kTelemetryScale));
+        }
+    };
+
+    // drone -> HQ telemetry relative to the acknowledged report 'baseSeq';
+    // deltas are integer telemetry units (see DeltaTelemetry.h)
+    struct StatusDeltaMsg {
+        static constexpr MessageType kType = MessageType::StatusDelta;
+        std::uint32_t droneId = 0;
+        std::uint32_t seq = 0;
+        std::uint32_t baseSeq = 0;
+        std::int64_t dx = 0, dy = 0;
+        std::int64_t dvx = 0, dvy = 0;
+
+        static constexpr auto schema() {
+            return std::make_tuple(
+                varint(&StatusDeltaMsg::droneId), varint(&StatusDeltaMsg::seq),
+                varint(&StatusDeltaMsg::baseSeq),
+                varint(&StatusDeltaMsg::dx), varint(&StatusDeltaMsg::dy),
+                varint(&StatusDeltaMsg::dvx), varint(&StatusDeltaMsg::dvy));
+        }
+    };
+
+    // HQ -> drones; 'text' is a view (into the caller's string when
+    // encoding, into the delivered payload when decoding)
+    struct CommandMsg {
+        static constexpr MessageType kType = MessageType::Command;
+        std::uint32_t seq = 0;
+        std::uint32_t opcode = 0;
+        double targetX = 0.0, targetY = 0.0;
+        std::string_view text;
+
+        static constexpr auto schema() {
+            return std::make_tuple(
+                varint(&CommandMsg::seq), varint(&CommandMsg::opcode),
+                fixed(&CommandMsg::targetX, 1000.0), fixed(&CommandMsg::targetY, 1000.0),
+                codec::text(&CommandMsg::text));
+        }
+    };
+
+    // acknowledges message 'seq' received by 'nodeId'
+    struct AckMsg {
+        static constexpr MessageType kType = MessageType::Ack;
+        std::uint32_t nodeId = 0;
+        std::uint32_t seq = 0;
+
+        static constexpr auto schema() {
+            return std::make_tuple(varint(&AckMsg::nodeId), varint(&AckMsg::seq));
+        }
+    };
+
+    // liveness beacon; uptime in milliseconds
+    struct HeartbeatMsg {
+        static constexpr MessageType kType = MessageType::Heartbeat;
+        std::uint32_t nodeId = 0;
+        std::uint32_t seq = 0;
+        std::uint64_t uptimeMs = 0;
+
+        static constexpr auto schema() {
+            return std::make_tuple(
+                varint(&HeartbeatMsg::nodeId), varint(&HeartbeatMsg::seq),
+                varint(&HeartbeatMsg::uptimeMs));
+        }
+    };
+
+    // generated encoders
+
+    // appends the frame to 'out'; false (and 'out' unchanged) if a real
+    // field cannot be encoded
+    template <typename Msg>
+    bool encodeTo(std::string& out, const Msg& msg) {
+        const std::size_t start = out.size();
+        out.push_back(static_cast<char>(kMagic));
+        out.push_back(static_cast<char>(Msg::kType));
+        bool ok = std::apply([&](const auto&... field) { return (put(out, msg, field) && ...); }, Msg::schema());
+        if (!ok) out.resize(start);
+        return ok;
+    }
+
+    // the frame, or an empty string if a real field cannot be encoded
+    template <typename Msg>
+    std::string encode(const Msg& msg) {
+        std::string out;
+        out.reserve(32);
+        encodeTo(out, msg);
+        return out;
+    }
+
+    inline bool isFrame(std::string_view payload) {
+        return payload.size() >= 2 && static_cast<std::uint8_t>(payload[0]) == kMagic;
+    }
+
+    // zero-copy view over a delivered payload
+    class MessageView {
+    public:
+        explicit MessageView(std::string_view payload) : payload_(payload) {}
+
+        bool valid() const { return isFrame(payload_); }
+
+        MessageType type() const {
+            return static_cast<MessageType>(static_cast<std::uint8_t>(payload_[1]));
+        }
+
+        // fields after the two-byte header
+        std::string_view body() const { return payload_.substr(2); }
+
+        // false if the frame is not a Msg, is truncated or has bytes left
+        // over after the last field
+        template <typename Msg>
+        bool decode(Msg& out) const {
+            if (!valid() || type() != Msg::kType) return false;
+            Reader in(body());
+            std::apply([&](const auto&... field) { (get(in, out, field), ...); }, Msg::schema());
+            return in.ok() && in.remaining() == 0;
+        }
+
+    private:
+        std::string_view payload_;
+    };
+
+    // text field on one line: backslash and control bytes as C escapes
+    inline void putEscaped(std::ostream& os, std::string_view text) {
+        static const char hex[] = "0123456789abcdef";
+        for (char c : text) {
+            const auto byte = static_cast<unsigned char>(c);
+            if (c == '\\') os << "\\\\";
+            else if (c == '\n') os << "\\n";
+            else if (c == '\r') os << "\\r";
+            else if (c == '\t') os << "\\t";
+            else if (byte < 0x20 || byte == 0x7f) os << "\\x" << hex[byte >> 4] << hex[byte & 15];
+            else os << c;
+        }
+    }
+
+    // human-readable rendering of a frame (for logs and console output)
+    inline void describe(std::ostream& os, std::string_view payload) {
+        MessageView view(payload);
+        std::ios_base::fmtflags flags = os.flags();
+        std::streamsize precision = os.precision();
+        os << std::fixed << std::setprecision(2);
+
+        StatusMsg status;
+        StatusDeltaMsg delta;
+        CommandMsg command;
+        AckMsg ack;
+        HeartbeatMsg heartbeat;
+        if (view.decode(status)) {
+            os << "STATUS drone=" << status.droneId << " seq=" << status.seq
+                << " pos=(" << status.x << "," << status.y << ")"
+                << " vel=(" << status.vx << "," << status.vy << ")";
+        }
+        else if (view.decode(delta)) {
+            os << "STATUS_DELTA drone=" << delta.droneId << " seq=" << delta.seq
+                << " base=" << delta.baseSeq
+                << " dpos=(" << delta.dx << "," << delta.dy << ")"
+                << " dvel=(" << delta.dvx << "," << delta.dvy << ")";
+        }
+        else if (view.decode(command)) {
+            os << "CMD seq=" << command.seq << " op=" << command.opcode
+                << " target=(" << command.targetX << "," << command.targetY << ")"
+                << " text=";
+            putEscaped(os, command.text);
+        }
+        else if (view.decode(ack)) {
+            os << "ACK node=" << ack.nodeId << " seq=" << ack.seq;
+        }
+        else if (view.decode(heartbeat)) {
+            os << "HEARTBEAT node=" << heartbeat.nodeId << " seq=" << heartbeat.seq
+                << " uptimeMs=" << heartbeat.uptimeMs;
+        }
+        else {
+            os << "<BINARY len=" << payload.size() << ">";
+        }
+
+        os.flags(flags);
+        os.precision(precision);
+    }
+
+    // stream adaptor: frames are described, text payloads written as-is
+    struct Printable {
+        std::string_view payload;
+    };
+
+    inline Printable printable(std::string_view payload) { return { payload }; }
+
+    inline std::ostream& operator<<(std::ostream& os, Printable p) {
+        if (isFrame(p.payload)) describe(os, p.payload);
+        else os << p.payload;
+        return os;
+    }
+}
@@ -0,0 +1,199 @@
+#include "Metrics.h"
+#include <ostream>
+
+namespace {
+
+    // Number of significant bits in v (0 for v == 0).
+    int bitWidth(std::uint64_t v) {
+        int width = 0;
+        while (v) {
+            ++width;
+            v >>= 1;
+        }
+        return width;
+    }
+
+    std::uint64_t bucketUpperBound(int bucket) {
+        if (bucket == 0) return 0;
+        if (bucket >= 64) return UINT64_MAX;
+        return (std::uint64_t{ 1 } << bucket) - 1;
+    }
+}
+
+/*
+ * @brief:
+ *         Records one sample.
+ */
+
+void Histogram::observe(std::uint64_t v) {
+    mBuckets[bitWidth(v)].fetch_add(1, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(v, std::memory_order_relaxed);
+
+    std::uint64_t prev = mMax.load(std::memory_order_relaxed);
+    while (v > prev && !mMax.compare_exchange_weak(prev, v, std::memory_order_relaxed)) {
+    }
+}
+
+/*
+ * @brief:
+ *         Walks the buckets until the cumulative count reaches q * count.
+ */
+
+std::uint64_t Histogram::percentile(double q) const {
+    std::uint64_t total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(total));
+    if (rank >= total) rank = total - 1;
+
+    std::uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+        seen += mBuckets[b].load(std::memory_order_relaxed);
+        if (seen > rank) {
+            std::uint64_t bound = bucketUpperBound(b);
+            std::uint64_t observedMax = max();
+            return bound < observedMax ? bound : observedMax;
+        }
+    }
+    return max();
+}
+
+/*
+ * @brief:
+ *         Process-wide registry used by Simulator, Network and main().
+ */
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+void* MetricsRegistry::find(const std::string& name, Kind kind) const {
+    for (const auto& e : mEntries) {
+        if (e.kind == kind && e.name == name) {
+            return e.metric;
+        }
+    }
+    return nullptr;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (void* existing = find(name, Kind::Counter)) {
+        return *static_cast<Counter*>(existing);
+    }
+    mCounters.emplace_back();
+    mEntries.push_back({ name, Kind::Counter, &mCounters.back() });
+    return mCounters.back();
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (void* existing = find(name, Kind::Gauge)) {
+        return *static_cast<Gauge*>(existing);
+    }
+    mGauges.emplace_back();
+    mEntries.push_back({ name, Kind::Gauge, &mGauges.back() });
+    return mGauges.back();
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (void* existing = find(name, Kind::Histogram)) {
+        return *static_cast<Histogram*>(existing);
+    }
+    mHistograms.emplace_back();
+    mEntries.push_back({ name, Kind::Histogram, &mHistograms.back() });
+    return mHistograms.back();
+}
+
+std::size_t MetricsRegistry::size() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+void MetricsRegistry::writeHeader(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    out << "time";
+    for (const auto& e : mEntries) {
+        if (e.kind == Kind::Histogram) {
+            out << "," << e.name << ".count"
+                << "," << e.name << ".p50"
+                << "," << e.name << ".p99"
+                << "," << e.name << ".max";
+        }
+        else {
+            out << "," << e.name;
+        }
+    }
+    out << "\n";
+}
+
+void MetricsRegistry::writeRow(std::ostream& out, double simTime) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    out << simTime;
+    for (const auto& e : mEntries) {
+        switch (e.kind) {
+        case Kind::Counter:
+            out << "," << static_cast<const Counter*>(e.metric)->value();
+            break;
+        case Kind::Gauge:
+            out << "," << static_cast<const Gauge*>(e.metric)->value();
+            break;
+        case Kind::Histogram: {
+            const auto* h = static_cast<const Histogram*>(e.metric);
+            out << "," << h->count()
+                << "," << h->percentile(0.50)
+                << "," << h->percentile(0.99)
+                << "," << h->max();
+            break;
+        }
+        }
+    }
+    out << "\n";
+}
+
+/*
+ * @brief:
+ *         Opens the snapshot file. The first snapshot is due after one
+ *         interval of simulation time.
+ */
+
+MetricsSnapshotWriter::MetricsSnapshotWriter(const std::string& path, double interval,
+    const MetricsRegistry& registry)
+    : mRegistry(registry),
+    mFile(path),
+    mInterval(interval),
+    mNextTime(interval) {
+}
+
+void MetricsSnapshotWriter::maybeWrite(double simTime) {
+    if (mInterval <= 0.0) {
+        write(simTime);
+        return;
+    }
+    if (simTime + 1e-9 < mNextTime) {
+        return;
+    }
+    write(simTime);
+    while (mNextTime <= simTime + 1e-9) {
+        mNextTime += mInterval;
+    }
+}
+
+void MetricsSnapshotWriter::write(double simTime) {
+    if (!mFile.is_open()) {
+        return;
+    }
+
+    std::size_t size = mRegistry.size();
+    if (size != mHeaderSize) {
+        mRegistry.writeHeader(mFile);
+        mHeaderSize = size;
+    }
+    mRegistry.writeRow(mFile, simTime);
+    mFile.flush();
+}
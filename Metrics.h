@@ -0,0 +1,205 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+/*
+ * @class:
+ *         Counter
+ * @brief:
+ *         Monotonic event counter. Updated with a relaxed atomic add, so it
+ *         is safe to bump from any thread on a hot path.
+ */
+
+class Counter {
+public:
+    void add(std::uint64_t n = 1) { mValue.fetch_add(n, std::memory_order_relaxed); }
+
+    std::uint64_t value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::uint64_t> mValue{ 0 };
+};
+
+/*
+ * @class:
+ *         Gauge
+ * @brief:
+ *         Last-value metric (queue depth, drone count, ...).
+ */
+
+class Gauge {
+public:
+    void set(double v) { mValue.store(v, std::memory_order_relaxed); }
+
+    double value() const { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> mValue{ 0.0 };
+};
+
+/*
+ * @class:
+ *         Histogram
+ * @brief:
+ *         Lock-free histogram with power-of-two buckets.
+ *
+ * Bucket b holds samples v with bit_width(v) == b, i.e. 0, 1, 2-3, 4-7, ...
+ * Percentiles are reported as the upper bound of the bucket that contains
+ * them, which is accurate to a factor of two and costs three relaxed atomic
+ * adds per sample.
+ */
+
+class Histogram {
+public:
+    static constexpr int kBuckets = 65;
+
+    void observe(std::uint64_t v);
+
+    std::uint64_t count() const { return mCount.load(std::memory_order_relaxed); }
+
+    std::uint64_t sum() const { return mSum.load(std::memory_order_relaxed); }
+
+    std::uint64_t max() const { return mMax.load(std::memory_order_relaxed); }
+
+    /*
+     * @brief:
+     *         Approximate percentile from the bucket counts.
+     * @param: q
+     *         Quantile in [0, 1].
+     * @return: Upper bound of the bucket holding the q-th sample.
+     */
+
+    std::uint64_t percentile(double q) const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBuckets> mBuckets{};
+    std::atomic<std::uint64_t> mCount{ 0 };
+    std::atomic<std::uint64_t> mSum{ 0 };
+    std::atomic<std::uint64_t> mMax{ 0 };
+};
+
+/*
+ * @class:
+ *         MetricsRegistry
+ * @brief:
+ *         Named collection of counters, gauges and histograms.
+ *
+ * Registration takes a mutex and returns a reference that stays valid for
+ * the lifetime of the registry; callers cache it and update it lock-free
+ * afterwards. Registering the same name twice returns the same metric.
+ *
+ * A process-wide instance is available through global().
+ */
+
+class MetricsRegistry {
+public:
+    static MetricsRegistry& global();
+
+    Counter& counter(const std::string& name);
+    Gauge& gauge(const std::string& name);
+    Histogram& histogram(const std::string& name);
+
+    /*
+     * @brief:
+     *         Number of registered metrics (all kinds).
+     */
+
+    std::size_t size() const;
+
+    /*
+     * @brief:
+     *         Writes the CSV header matching writeRow().
+     *
+     * Counters and gauges get one column each; histograms get
+     * name.count, name.p50, name.p99 and name.max.
+     */
+
+    void writeHeader(std::ostream& out) const;
+
+    /*
+     * @brief:
+     *         Writes one CSV row with the current value of every metric.
+     *
+     * Values are read with relaxed loads, so the row is not an atomic
+     * snapshot across metrics, but each value is consistent on its own.
+     */
+
+    void writeRow(std::ostream& out, double simTime) const;
+
+private:
+    enum class Kind { Counter, Gauge, Histogram };
+
+    struct Entry {
+        std::string name;
+        Kind kind;
+        void* metric;
+    };
+
+    void* find(const std::string& name, Kind kind) const;
+
+    mutable std::mutex mMutex;
+    std::deque<Counter> mCounters;
+    std::deque<Gauge> mGauges;
+    std::deque<Histogram> mHistograms;
+    std::deque<Entry> mEntries;
+};
+
+/*
+ * @class:
+ *         MetricsSnapshotWriter
+ * @brief:
+ *         Appends periodic registry snapshots to a compact CSV file so long
+ *         runs can be watched while they execute.
+ *
+ * A header line is written before the first row, and again whenever new
+ * metrics have been registered since the previous header. Rows are flushed
+ * immediately so the file can be tailed.
+ */
+
+class MetricsSnapshotWriter {
+public:
+
+    /*
+     * @param: path
+     *         Output file path (truncated on open).
+     * @param: interval
+     *         Simulation seconds between snapshots.
+     * @param: registry
+     *         Registry to snapshot.
+     */
+
+    MetricsSnapshotWriter(const std::string& path, double interval,
+        const MetricsRegistry& registry = MetricsRegistry::global());
+
+    bool isOpen() const { return mFile.is_open(); }
+
+    /*
+     * @brief:
+     *         Writes a snapshot if at least one interval has elapsed.
+     */
+
+    void maybeWrite(double simTime);
+
+    /*
+     * @brief:
+     *         Writes a snapshot unconditionally (e.g. at the end of a run).
+     */
+
+    void write(double simTime);
+
+private:
+    const MetricsRegistry& mRegistry;
+    std::ofstream mFile;
+    double mInterval;
+    double mNextTime;
+    std::size_t mHeaderSize = 0;
+};
+
+#endif // METRICS_H
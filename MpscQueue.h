@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Lock-free multi-producer / single-consumer queue.
+//
+// Producers push with a CAS on the list head (Treiber stack), so any number
+// of threads can stage items concurrently without a lock. The single consumer
+// takes the whole list with one atomic exchange and reverses it, which
+// yields the items in push order per producer thread.
+//
+// Intended for "stage during the tick, drain at the tick boundary" use:
+// drain() must only be called from one thread at a time.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    ~MpscQueue() {
+        std::vector<T> discard;
+        drain(discard);
+    }
+
+    void push(T value) {
+        Cell* cell = new Cell{ std::move(value), head_.load(std::memory_order_relaxed) };
+        while (!head_.compare_exchange_weak(cell->next, cell,
+            std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Moves every staged item into 'out' (appended, oldest first).
+    // Returns the number of items drained.
+    size_t drain(std::vector<T>& out) {
+        Cell* list = head_.exchange(nullptr, std::memory_order_acquire);
+
+        // reverse LIFO list into FIFO order
+        Cell* fifo = nullptr;
+        while (list) {
+            Cell* next = list->next;
+            list->next = fifo;
+            fifo = list;
+            list = next;
+        }
+
+        size_t count = 0;
+        while (fifo) {
+            Cell* next = fifo->next;
+            out.push_back(std::move(fifo->value));
+            delete fifo;
+            fifo = next;
+            ++count;
+        }
+        return count;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Cell {
+        T value;
+        Cell* next;
+    };
+
+    std::atomic<Cell*> head_{ nullptr };
+};
@@ -1,219 +1,1072 @@
 #pragma once
+#include "ChaCha20.h"
+#include "CommsObserver.h"
+#include "CsvFormat.h"
+#include "LogCompression.h"
 #include "Message.h"
+#include "MessageCodec.h"
 #include "Node.h"
+#include "MeshRouter.h"
+#include "Metrics.h"
+#include "MpscQueue.h"
+#include "Profiler.h"
+#include "RadioLinks.h"
+#include "RadioQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <fstream>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include <random>
 #include <iostream>
+#include <sstream>
+#include <string_view>
 #include <iomanip>
 #include <string>
 
+// link model, RNG seed and outputs of one Network
+struct NetworkParams {
+    double baseLatency = 0.5;       // s
+    double jitter = 0.2;            // latency is baseLatency +/- jitter (uniform)
+    double dropProbability = 0.15;
+    std::uint64_t seed = 0;         // 0 = nondeterministic (std::random_device)
+    std::string logPath = "comms_log.csv";  // "" = no comms log file
+    bool printEvents = true;        // echo sends/deliveries/drops to stdout
+};
+
 class Network {
 public:
     Network(double baseLatency, double jitter, double dropProbability)
-        : baseLatency_(baseLatency),
-        jitter_(jitter),
-        dropProb_(dropProbability),
-        rng_(std::random_device{}()),
+        : Network(NetworkParams{ baseLatency, jitter, dropProbability })
+    {
+    }
+
+    explicit Network(const NetworkParams& params)
+        : baseLatency_(params.baseLatency),
+        jitter_(params.jitter),
+        dropProb_(params.dropProbability),
+        logPath_(params.logPath),
+        printEvents_(params.printEvents),
         uniform01_(0.0, 1.0),
-        jitterDist_(-jitter, jitter)
+        jitterDist_(-params.jitter, params.jitter)
     {
-        logFile_.open("comms_log.csv");
-        logFile_ << "event,time,id,from,to,latency,dropped,payload\n";
+        if (params.seed) {
+            std::seed_seq seq{ static_cast<std::uint32_t>(params.seed), static_cast<std::uint32_t>(params.seed >> 32) };
+            rng_.seed(seq);
+        }
+        else {
+            rng_.seed(std::random_device{}());
+        }
+
+        if (!logPath_.empty()) logFile_.open(logPath_, std::ios::binary);
+        logBuffer_ = "event,time,id,from,to,latency,dropped,payload\n";
+
+        MetricsRegistry& metrics = MetricsRegistry::global();
+        sentCounter_ = &metrics.counter("net.messages_sent");
+        droppedCounter_ = &metrics.counter("net.messages_dropped");
+        deliveredCounter_ = &metrics.counter("net.messages_delivered");
+        deliveredPerStep_ = &metrics.histogram("net.delivered_per_step");
+        inFlightGauge_ = &metrics.gauge("net.in_flight");
+        logBytesCounter_ = &metrics.counter("log.comms_bytes_written");
+        postedCounter_ = &metrics.counter("net.messages_posted");
+        cipherBytesCounter_ = &metrics.counter("crypto.bytes");
+        cipherNanosCounter_ = &metrics.counter("crypto.ns");
+        unreachableCounter_ = &metrics.counter("net.unreachable");
+        relayCounter_ = &metrics.counter("mesh.relay_transmissions");
+        ttlCounter_ = &metrics.counter("mesh.ttl_drops");
+        txDepthHist_ = &metrics.histogram("net.tx_queue_depth");
+        txDelayHist_ = &metrics.histogram("net.tx_queue_delay_us");
+        rxDepthHist_ = &metrics.histogram("net.rx_queue_depth");
+        rxDelayHist_ = &metrics.histogram("net.rx_queue_delay_us");
+        overflowCounter_ = &metrics.counter("net.queue_overflows");
+        airtimeCounter_ = &metrics.counter("net.airtime_bytes");
+        unknownGroupCounter_ = &metrics.counter("net.multicast_unknown_group");
     }
 
     ~Network() {
+        flushLog();
         if (logFile_.is_open()) {
             logFile_.close();
         }
+        if (compressedLog_) {
+            compressedLog_->close();
+        }
     }
 
+    // reuses the index of a removed node if there is one (newest first)
     Node& addNode(const std::string& name) {
-        nodes_.emplace_back(name);
-        nodeIndex_[name] = static_cast<int>(nodes_.size()) - 1;
-        return nodes_.back();
+        int index;
+        if (!freeIndices_.empty()) {
+            index = freeIndices_.back();
+            freeIndices_.pop_back();
+            nodes_[index] = Node(name);
+            removed_[index] = 0;
+        }
+        else {
+            index = static_cast<int>(nodes_.size());
+            nodes_.emplace_back(name);
+            removed_.push_back(0);
+            generation_.push_back(0);
+            departedName_.emplace_back();
+            nodeGroups_.emplace_back();
+        }
+        nodeIndex_[name] = index;
+        return nodes_[index];
+    }
+
+    // take a node out of the network (e.g. a crashed drone). It leaves the
+    // broadcast set, every multicast group and the radio grid, its name
+    // becomes unknown and its inbox and radio queues are released. The
+    // index is recycled by a later addNode() under a new generation: in-
+    // flight messages addressed to or relayed through the old node are
+    // still dropped on arrival ("drop_removed"), never delivered to the
+    // newcomer. Cached mesh routes to or through the node are purged.
+    // Cost: the sizes of the node's own multicast groups, plus a scan of
+    // all cached routes when mesh routing is enabled.
+    bool removeNode(const std::string& name) {
+        int index = indexOf(name);
+        if (index < 0) return false;
+        nodeIndex_.erase(name);
+        departedName_[index] = name;
+        removed_[index] = 1;
+        ++generation_[index];
+        ++removedCount_;
+        freeIndices_.push_back(index);
+        nodes_[index] = Node(name);   // drops the inbox
+        for (const std::string& group : nodeGroups_[index]) {
+            auto& members = groups_[group];
+            members.erase(std::remove(members.begin(), members.end(), index), members.end());
+        }
+        nodeGroups_[index].clear();
+        if (links_) links_->clearPosition(index);
+        if (router_) router_->forgetNode(index);
+        if (index < static_cast<int>(txQueues_.size())) txQueues_[index] = RadioQueue();
+        if (index < static_cast<int>(rxQueues_.size())) rxQueues_[index] = RadioQueue();
+        return true;
     }
 
+    bool isRemoved(int index) const { return removed_[index] != 0; }
+
     Node* getNode(const std::string& name) {
         auto it = nodeIndex_.find(name);
         if (it == nodeIndex_.end()) return nullptr;
         return &nodes_[it->second];
     }
 
+    // node by index (see indexOf)
+    Node& nodeAt(int index) { return nodes_[index]; }
+
+    // index of a node (as used by the radio link model), -1 if unknown
+    int indexOf(const std::string& name) const {
+        auto it = nodeIndex_.find(name);
+        return it == nodeIndex_.end() ? -1 : it->second;
+    }
+
+    // switch from all-to-all delivery to range-limited radio links;
+    // connectivity then follows the positions given to setNodePosition()
+    void enableRadioLinks(const RadioLinkParams& params) {
+        links_ = std::make_unique<RadioLinkModel>(params);
+    }
+
+    RadioLinkModel* radioLinks() { return links_.get(); }
+
+    // route unicast messages hop by hop over the radio neighbor graph
+    // (requires enableRadioLinks); broadcast/multicast stay single-hop
+    void enableMeshRouting(int maxHops = 16) {
+        if (links_) router_ = std::make_unique<MeshRouter>(*links_, maxHops);
+    }
+
+    MeshRouter* meshRouter() { return router_.get(); }
+
+    // give every node a finite-bandwidth radio: frames (cipherText plus
+    // frameOverhead) queue FIFO per node, are shaped by a token bucket on
+    // the transmit side and serialized at lineRate on both sides
+    void enableBandwidthLimits(const BandwidthParams& params) {
+        bandwidth_ = params;
+        bandwidthLimited_ = true;
+    }
+
+    // observers see every event logged to comms_log.csv, as it is logged
+    void addObserver(CommsObserver& observer) {
+        observers_.push_back(&observer);
+    }
+
+    void removeObserver(CommsObserver& observer) {
+        observers_.erase(std::remove(observers_.begin(), observers_.end(), &observer), observers_.end());
+    }
+
+    // write <logPath>.lz (LogCompression.h) instead of the plain log;
+    // rows logged so far are kept, so call it before the first step
+    bool enableLogCompression() {
+        if (compressedLog_) return true;
+        if (logPath_.empty()) return false;
+        auto writer = std::make_unique<CompressedLogWriter>(logPath_ + ".lz");
+        if (!writer->isOpen()) return false;
+        logFile_.close();
+        std::remove(logPath_.c_str());
+        compressedLog_ = std::move(writer);
+        return true;
+    }
+
+    // update a node's position (no-op unless radio links are enabled)
+    void setNodePosition(int node, const Vector2& pos) {
+        if (links_) links_->setPosition(node, pos);
+    }
+
+    // define (or redefine) a multicast group; unknown node names are skipped
+    void createGroup(const std::string& group, const std::vector<std::string>& members) {
+        std::vector<int>& indices = groups_[group];
+        for (int index : indices) {
+            auto& memberOf = nodeGroups_[index];
+            memberOf.erase(std::remove(memberOf.begin(), memberOf.end(), group), memberOf.end());
+        }
+        indices.clear();
+        for (const auto& name : members) {
+            auto it = nodeIndex_.find(name);
+            if (it != nodeIndex_.end() && !removed_[it->second]) {
+                indices.push_back(it->second);
+                nodeGroups_[it->second].push_back(group);
+            }
+        }
+    }
+
+    // send one payload to every member of 'group' (except the sender).
+    // The payload is encrypted once and the buffer is shared by all
+    // recipients; latency and drops are still sampled per recipient.
+    void multicast(const std::string& from,
+        const std::string& group,
+        const std::string& payload,
+        double currentTime)
+    {
+        PROFILE_SCOPE("Network::multicast");
+        auto it = groups_.find(group);
+        if (it == groups_.end()) {
+            unknownGroupCounter_->add();
+            if (printEvents_) {
+                std::cout << std::fixed << std::setprecision(3)
+                    << "[t=" << currentTime << "] "
+                    << "[MULTICAST FAILED] unknown group " << group << "\n";
+            }
+            return;
+        }
+        fanOut("multicast", from, group, it->second, payload, currentTime);
+    }
+
+    // send one payload to every other node in the network
+    void broadcast(const std::string& from,
+        const std::string& payload,
+        double currentTime)
+    {
+        PROFILE_SCOPE("Network::broadcast");
+        allNodes_.clear();
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            if (!removed_[i]) allNodes_.push_back(static_cast<int>(i));
+        }
+        fanOut("broadcast", from, "*", allNodes_, payload, currentTime);
+    }
+
     // schedule a message from 'from' to 'to' at simulation time 't'
+    // (tick thread only; concurrent senders use postMessage)
     void sendMessage(const std::string& from,
         const std::string& to,
         const std::string& payload,
         double currentTime)
     {
-        Message msg;
-        msg.id = nextMessageId_++;
-        msg.from = from;
-        msg.to = to;
-        msg.payload = payload;
-        msg.sendTime = currentTime;
-
-        // Encrypt payload before placing it "on the wire"
-        msg.cipherText = xorCipher(payload, encryptionKey_);
-
-        bool drop = (uniform01_(rng_) < dropProb_);
-        if (drop) {
-            msg.dropped = true;
-            msg.deliverTime = currentTime + sampleLatency();
-            droppedMessages_.push_back(msg);
+        PROFILE_SCOPE("Network::sendMessage");
+        transmit(nextMessageId_.fetch_add(1, std::memory_order_relaxed),
+            from, to, payload, currentTime);
+    }
 
-            std::cout << std::fixed << std::setprecision(3)
-                << "[t=" << currentTime << "] "
-                << "[DROP SCHEDULED] " << from << " -> " << to
-                << "  msgId=" << msg.id
-                << "  payload=<ENCRYPTED len=" << msg.cipherText.size() << ">\n";
+    // thread-safe send: stages the message in a lock-free queue. Staged
+    // messages go on the wire at the start of the next step(), sorted by
+    // (sendTime, from, to, payload) and numbered in that order, so ids
+    // (and nonces), drop/latency sampling and logging do not depend on
+    // thread scheduling.
+    void postMessage(const std::string& from,
+        const std::string& to,
+        const std::string& payload,
+        double currentTime)
+    {
+        posted_.push({ from, to, payload, currentTime });
+        postedCounter_->add();
+    }
 
-            // LOG: record drop event
-            logFile_ << "drop_scheduled,"
-                << currentTime << ","
-                << msg.id << ","
-                << msg.from << ","
-                << msg.to << ","
-                << 0.0 << ","      // latency N/A at scheduling
-                << 1 << ","        // dropped = 1
-                << "\"" << payload << "\""
-                << "\n";
+    // send a whole batch (e.g. every drone's report for one tick); all
+    // payloads are encrypted together in one ChaCha20 batch pass
+    void sendMessages(const std::vector<OutgoingMessage>& batch, double currentTime)
+    {
+        PROFILE_SCOPE("Network::sendMessages");
+        wireBatch_.clear();
+        wireBatch_.reserve(batch.size());
+        for (const auto& out : batch) {
+            Message msg;
+            msg.id = nextMessageId_.fetch_add(1, std::memory_order_relaxed);
+            msg.from = out.from;
+            msg.to = out.to;
+            msg.payload = out.payload;
+            msg.sendTime = currentTime;
+            wireBatch_.push_back(std::move(msg));
         }
-        else {
-            msg.dropped = false;
-            msg.deliverTime = currentTime + sampleLatency();
-            inTransit_.push_back(msg);
 
-            std::cout << std::fixed << std::setprecision(3)
-                << "[t=" << currentTime << "] "
-                << "[SEND] " << from << " -> " << to
-                << "  msgId=" << msg.id
-                << "  payload=<ENCRYPTED len=" << msg.cipherText.size() << ">\n";
-
-            // LOG: record send event
-            logFile_ << "send,"
-                << currentTime << ","
-                << msg.id << ","
-                << msg.from << ","
-                << msg.to << ","
-                << 0.0 << ","      // latency N/A at send
-                << 0 << ","        // dropped = 0
-                << "\"" << payload << "\""
-                << "\n";
+        encryptBatch(wireBatch_);
+        for (auto& msg : wireBatch_) {
+            putOnWire(msg);
         }
     }
 
     // advance simulation by dt
     void step(double currentTime) {
-        // deliver messages whose time has come
-        std::vector<Message> remaining;
-        remaining.reserve(inTransit_.size());
+        PROFILE_SCOPE("Network::step");
+        // topology changes since last tick: invalidate affected routes
+        if (links_) {
+            if (router_) router_->onTopologyChange(links_->movedNodes());
+            links_->clearMoved();
+        }
 
-        for (auto& msg : inTransit_) {
-            if (msg.deliverTime <= currentTime) {
-                deliver(msg, currentTime);
-            }
-            else {
-                remaining.push_back(msg);
-            }
+        // tick boundary: put messages staged by other threads on the wire
+        flushPosted();
+
+        // receptions and relays up to now, in time order
+        int deliveredBefore = deliveredCount_;
+        advance(currentTime);
+
+        wireBatch_.clear();
+        for (auto& msg : arrived_) {
+            // the receiver may have left since the message arrived
+            if (removedCount_ > 0 && arrivesAtRemoved(msg)) continue;
+            wireBatch_.push_back(std::move(msg));
+        }
+        arrived_.clear();
+
+        // Decrypt everything arriving this step in one batch
+        decryptBatch(wireBatch_);
+        for (auto& msg : wireBatch_) {
+            deliver(msg, currentTime);
         }
 
-        inTransit_.swap(remaining);
+        // metrics: per-step delivery count, queue depth, log volume
+        deliveredPerStep_->observe(static_cast<std::uint64_t>(deliveredCount_ - deliveredBefore));
+        inFlightGauge_->set(static_cast<double>(inTransit_.size()));
+        flushLog();
     }
 
+    int deliveredCount() const { return deliveredCount_; }
+
+    std::size_t droppedCount() const { return droppedIds_.size(); }
+
     // print summary at end
     void printSummary(double finalTime) const {
         std::cout << "\n=== Simulation Summary (t=" << finalTime << ") ===\n";
         std::cout << "Delivered messages: " << deliveredCount_ << "\n";
-        std::cout << "Dropped messages:   " << droppedMessages_.size() << "\n";
+        std::cout << "Dropped messages:   " << droppedIds_.size() << "\n";
 
         if (deliveredCount_ > 0) {
             double avgLatency = totalLatency_ / deliveredCount_;
             std::cout << "Average latency:    " << avgLatency << " s\n";
         }
 
+        if (cipherNanos_ > 0) {
+            std::cout << "Cipher throughput:  "
+                << static_cast<double>(cipherBytes_) / static_cast<double>(cipherNanos_)
+                << " GB/s (" << cipherBytes_ << " bytes, ChaCha20"
+                << (ChaCha20::hasSimdBatch() ? " AVX2 batch" : " scalar") << ")\n";
+        }
+
+        if (bandwidthLimited_) {
+            printQueueStats("Tx queue", txStats_);
+            printQueueStats("Rx queue", rxStats_);
+        }
+
         std::cout << "\nPer-node inbox contents:\n";
-        for (const auto& node : nodes_) {
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            if (removed_[i]) continue;   // free index, inbox released
+            const Node& node = nodes_[i];
             std::cout << "Node " << node.name() << ":\n";
             for (const auto& rm : node.inbox()) {
                 std::cout << "  at t=" << rm.timeReceived
                     << "  from=" << rm.from
                     << "  id=" << rm.id
                     << "  latency=" << rm.latency
-                    << "  payload=\"" << rm.payload << "\"\n";
+                    << "  payload=\"" << codec::printable(rm.payload()) << "\"\n";
             }
         }
     }
 
 private:
+    // message staged by postMessage(), waiting for the tick boundary
+    struct PostedMessage {
+        std::string from;
+        std::string to;
+        std::string payload;
+        double sendTime;
+    };
+
+    void flushPosted() {
+        if (posted_.empty()) return;
+
+        postedBatch_.clear();
+        posted_.drain(postedBatch_);
+
+        // deterministic order regardless of which thread staged what
+        std::sort(postedBatch_.begin(), postedBatch_.end(),
+            [](const PostedMessage& a, const PostedMessage& b) {
+                if (a.sendTime != b.sendTime) return a.sendTime < b.sendTime;
+                if (a.from != b.from) return a.from < b.from;
+                if (a.to != b.to) return a.to < b.to;
+                return a.payload < b.payload;
+            });
+
+        wireBatch_.clear();
+        wireBatch_.reserve(postedBatch_.size());
+        int firstId = nextMessageId_.fetch_add(static_cast<int>(postedBatch_.size()), std::memory_order_relaxed);
+        for (auto& pm : postedBatch_) {
+            Message msg;
+            msg.id = firstId++;
+            msg.from = std::move(pm.from);
+            msg.to = std::move(pm.to);
+            msg.payload = std::move(pm.payload);
+            msg.sendTime = pm.sendTime;
+            wireBatch_.push_back(std::move(msg));
+        }
+
+        encryptBatch(wireBatch_);
+        for (auto& msg : wireBatch_) {
+            putOnWire(msg);
+        }
+    }
+
+    // shared part of multicast()/broadcast(): one id block, one encrypted
+    // buffer, then a small per-recipient header with its own drop/latency
+    void fanOut(const char* event,
+        const std::string& from,
+        const std::string& label,
+        const std::vector<int>& recipients,
+        const std::string& payload,
+        double currentTime)
+    {
+        auto senderIt = nodeIndex_.find(from);
+        int sender = senderIt == nodeIndex_.end() ? -1 : senderIt->second;
+
+        int count = 0;
+        for (int idx : recipients) {
+            if (idx != sender) ++count;
+        }
+        if (count == 0) return;
+
+        int firstId = nextMessageId_.fetch_add(count, std::memory_order_relaxed);
+
+        // encrypt once (nonce = first id of the block)
+        auto buffer = std::make_shared<std::string>(payload.size(), '\0');
+        cipherJobs_.clear();
+        cipherJobs_.push_back({
+            reinterpret_cast<const std::uint8_t*>(payload.data()),
+            reinterpret_cast<std::uint8_t*>(&(*buffer)[0]),
+            payload.size(),
+            static_cast<std::uint64_t>(firstId) });
+        runCipherJobs();
+        std::shared_ptr<const std::string> shared = std::move(buffer);
+
+        // one radio transmission reaches every recipient
+        if (bandwidthLimited_) advance(currentTime);
+        double departure = transmitFrame(sender, currentTime, shared->size());
+        bool overflow = departure < 0.0;
+        if (overflow) departure = currentTime;
+
+        int id = firstId;
+        fanOutDrops_.clear();
+        for (int idx : recipients) {
+            if (idx == sender) continue;
+
+            Message msg;
+            msg.id = id++;
+            msg.from = from;
+            msg.to = nodes_[idx].name();
+            msg.atNode = idx;
+            msg.atGeneration = generation_[idx];
+            msg.cipherText = shared;
+            msg.nonceId = static_cast<std::uint64_t>(firstId);
+            msg.sendTime = currentTime;
+            sentCounter_->add();
+
+            double latency = 0.0;
+            msg.dropped = overflow || sampleLink(sender, idx, latency);
+            msg.deliverTime = departure + latency;
+            if (msg.dropped) {
+                droppedCounter_->add();
+                droppedIds_.push_back(msg.id);
+                fanOutDrops_.push_back(idx);
+            }
+            else {
+                schedule(msg);
+            }
+        }
+
+        size_t dropped = fanOutDrops_.size();
+
+        if (printEvents_) {
+            std::cout << std::fixed << std::setprecision(3)
+                << "[t=" << currentTime << "] "
+                << "[" << event << "] " << from << " -> " << label
+                << "  msgIds=" << firstId << ".." << (id - 1)
+                << "  recipients=" << count
+                << "  dropped=" << dropped
+                << "  payload=<ENCRYPTED len=" << shared->size() << ">\n";
+        }
+
+        // LOG: one line for the whole fan-out (id = first id of the block)
+        logRow(event, currentTime, firstId, from, label, 0.0, dropped, payload);
+
+        // LOG: per-recipient drops as headers only (payload logged above)
+        const std::size_t firstDrop = droppedIds_.size() - dropped;
+        for (size_t i = 0; i < dropped; ++i) {
+            logRow(overflow ? "drop_queue" : "drop_scheduled", currentTime,
+                droppedIds_[firstDrop + i], from, nodes_[fanOutDrops_[i]].name(), 0.0, 1, "");
+        }
+    }
+
+    // encrypt a single message and put it on the wire
+    void transmit(int id,
+        const std::string& from,
+        const std::string& to,
+        const std::string& payload,
+        double currentTime)
+    {
+        Message msg;
+        msg.id = id;
+        msg.from = from;
+        msg.to = to;
+        msg.payload = payload;
+        msg.sendTime = currentTime;
+
+        // Encrypt payload before placing it "on the wire"
+        auto start = std::chrono::steady_clock::now();
+        msg.nonceId = static_cast<std::uint64_t>(id);
+        msg.cipherText = std::make_shared<const std::string>(
+            ChaCha20::apply(cipherKey_, msg.nonceId, payload));
+        countCipher(payload.size(), start);
+
+        putOnWire(msg);
+    }
+
+    // encrypt payload -> cipherText for a batch (nonce = message id)
+    void encryptBatch(std::vector<Message>& batch) {
+        cipherJobs_.clear();
+        for (auto& msg : batch) {
+            auto buffer = std::make_shared<std::string>(msg.payload.size(), '\0');
+            msg.nonceId = static_cast<std::uint64_t>(msg.id);
+            cipherJobs_.push_back({
+                reinterpret_cast<const std::uint8_t*>(msg.payload.data()),
+                reinterpret_cast<std::uint8_t*>(&(*buffer)[0]),
+                msg.payload.size(),
+                msg.nonceId });
+            msg.cipherText = std::move(buffer);
+        }
+        runCipherJobs();
+    }
+
+    // decrypt cipherText -> plainText for a batch at the destination.
+    // A buffer shared by several recipients is decrypted only once, and
+    // they all get the same plaintext buffer.
+    void decryptBatch(std::vector<Message>& batch) {
+        cipherJobs_.clear();
+        sharedSeen_.clear();
+        for (auto& msg : batch) {
+            const bool shared = msg.cipherText.use_count() > 1;
+            if (shared) {
+                auto seen = sharedSeen_.find(msg.cipherText.get());
+                if (seen != sharedSeen_.end()) {
+                    msg.plainText = seen->second;
+                    continue;
+                }
+            }
+            auto buffer = std::make_shared<std::string>(msg.cipherText->size(), '\0');
+            cipherJobs_.push_back({
+                reinterpret_cast<const std::uint8_t*>(msg.cipherText->data()),
+                reinterpret_cast<std::uint8_t*>(&(*buffer)[0]),
+                msg.cipherText->size(),
+                msg.nonceId });
+            msg.plainText = std::move(buffer);
+            if (shared) sharedSeen_.emplace(msg.cipherText.get(), msg.plainText);
+        }
+        runCipherJobs();
+        sharedSeen_.clear();
+    }
+
+    void runCipherJobs() {
+        if (cipherJobs_.empty()) return;
+        PROFILE_SCOPE("crypto.batch");
+
+        std::size_t bytes = 0;
+        for (const auto& job : cipherJobs_) bytes += job.length;
+
+        auto start = std::chrono::steady_clock::now();
+        ChaCha20::xorBatch(cipherKey_, cipherJobs_.data(), cipherJobs_.size());
+        countCipher(bytes, start);
+    }
+
+    void countCipher(std::size_t bytes, std::chrono::steady_clock::time_point start) {
+        auto nanos = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        cipherBytes_ += bytes;
+        cipherNanos_ += nanos;
+        cipherBytesCounter_->add(bytes);
+        cipherNanosCounter_->add(nanos);
+    }
+
+    // sample drop/latency for an encrypted message, log it, and queue it
+    void putOnWire(Message& msg) {
+        const double currentTime = msg.sendTime;
+        sentCounter_->add();
+
+        // radio queues must see this frame after everything that happened
+        // before it was sent
+        if (bandwidthLimited_) advance(currentTime);
+
+        int from = indexOf(msg.from);
+        int to = indexOf(msg.to);
+        int hop = to;
+        bool routed = true;
+        bool unknown = to < 0;   // never added, or removed
+        if (!unknown && router_ && links_->hasPosition(from) && links_->hasPosition(to)) {
+            hop = router_->nextHop(from, to);
+            msg.destNode = to;
+            msg.destGeneration = generation_[to];
+            msg.hops = 1;
+            routed = hop >= 0;
+        }
+        if (hop >= 0) {
+            msg.atNode = hop;
+            msg.atGeneration = generation_[hop];
+        }
+
+        double latency = 0.0;
+        double departure = currentTime;
+        const char* dropEvent = "drop_scheduled";
+        bool drop;
+        if (unknown) {
+            drop = true;   // no such node (e.g. it left the network)
+            dropEvent = "drop_unknown";
+        }
+        else if (!routed) {
+            drop = true;   // no route to destination
+            unreachableCounter_->add();
+        }
+        else if ((departure = transmitFrame(from, currentTime, msg.cipherText->size())) < 0.0) {
+            drop = true;   // sender's transmit queue is full
+            dropEvent = "drop_queue";
+            departure = currentTime;
+        }
+        else {
+            drop = links_ ? sampleLink(from, hop, latency) : sampleLink(-1, -1, latency);
+        }
+        if (drop) {
+            msg.dropped = true;
+            msg.deliverTime = departure + latency;
+            droppedIds_.push_back(msg.id);
+            droppedCounter_->add();
+
+            if (printEvents_) {
+                std::cout << std::fixed << std::setprecision(3)
+                    << "[t=" << currentTime << "] "
+                    << "[DROP SCHEDULED] " << msg.from << " -> " << msg.to
+                    << "  msgId=" << msg.id
+                    << "  payload=<ENCRYPTED len=" << msg.cipherText->size() << ">\n";
+            }
+
+            // LOG: record drop event
+            logRow(dropEvent, currentTime, msg.id, msg.from, msg.to,
+                0.0,    // latency N/A at scheduling
+                1,      // dropped = 1
+                msg.payload);
+        }
+        else {
+            msg.dropped = false;
+            msg.deliverTime = departure + latency;
+
+            if (printEvents_) {
+                std::cout << std::fixed << std::setprecision(3)
+                    << "[t=" << currentTime << "] "
+                    << "[SEND] " << msg.from << " -> " << msg.to
+                    << "  msgId=" << msg.id
+                    << "  payload=<ENCRYPTED len=" << msg.cipherText->size() << ">\n";
+            }
+
+            // LOG: record send event
+            logRow("send", currentTime, msg.id, msg.from, msg.to,
+                0.0,    // latency N/A at send
+                0,      // dropped = 0
+                msg.payload);
+
+            schedule(msg);
+        }
+    }
+
     double sampleLatency() {
         return baseLatency_ + jitterDist_(rng_);
     }
 
-    std::string xorCipher(const std::string& text, const std::string& key) {
-        std::string out = text;
-        for (size_t i = 0; i < text.size(); ++i) {
-            out[i] = text[i] ^ key[i % key.size()];
+    // draws the drop decision and latency for one hop from node index
+    // 'from' to 'to' (-1 = unknown). With radio links the drop probability
+    // and latency depend on distance, and out-of-range pairs always drop.
+    // Draw order (drop, then latency) matches the original model.
+    bool sampleLink(int from, int to, double& latency) {
+        double dropP = dropProb_;
+        double extra = 0.0;
+        if (links_ && from >= 0 && to >= 0) {
+            dropP = links_->dropProbability(from, to, dropProb_);
+            extra = links_->extraLatency(from, to);
+            // only out-of-range links; an in-range link whose distance-scaled
+            // drop probability saturates at 1 is a (certain) drop, not unreachable
+            if (!links_->inRange(from, to)) unreachableCounter_->add();
         }
-        return out;
+        bool drop = (uniform01_(rng_) < dropP);
+        latency = sampleLatency() + extra;
+        return drop;
     }
 
-    void deliver(Message& msg, double currentTime) {
-        Node* dest = getNode(msg.to);
-        if (!dest) {
-            std::cout << std::fixed << std::setprecision(3)
-                << "[t=" << currentTime << "] "
-                << "[DELIVERY FAILED] unknown node " << msg.to
-                << " for msgId=" << msg.id << "\n";
-            return;
+    // drops a message arriving at a node that was removed since the hop
+    // was sent, or whose final destination was; true if it was dropped
+    bool arrivesAtRemoved(Message& msg) {
+        int node = msg.atNode;
+        bool atGone = node >= 0 && generation_[node] != msg.atGeneration;
+        bool destGone = msg.destNode >= 0 && generation_[msg.destNode] != msg.destGeneration;
+        if (!atGone && !destGone) return false;
+
+        msg.dropped = true;
+        droppedCounter_->add();
+
+        // LOG: receiver gone (latency = time spent in flight); a relay's
+        // name is blank if its index has since been removed again
+        std::string_view gone = msg.to;
+        if (atGone && msg.destNode >= 0 && node != msg.destNode) {
+            bool removedOnce = generation_[node] == msg.atGeneration + 1;
+            gone = removedOnce ? std::string_view(departedName_[node]) : std::string_view();
         }
+        logRow("drop_removed", msg.deliverTime, msg.id, msg.from, msg.to,
+            msg.deliverTime - msg.sendTime, 1, gone);
+
+        droppedIds_.push_back(msg.id);
+        return true;
+    }
+
+    // forward a message that reached an intermediate node; true if it is
+    // back in flight towards the next hop (msg updated), false if it was
+    // dropped at the relay.
+    // msg.hops is the TTL: a message that used maxHops hops without
+    // arriving is dropped ("drop_ttl"), so stale caches pointing at each
+    // other cannot bounce it forever.
+    bool relay(Message& msg) {
+        const double arrival = msg.deliverTime;
+        const int hopsLeft = router_->maxHops() - msg.hops;
+        int hop = hopsLeft > 0 ? router_->nextHop(msg.atNode, msg.destNode, hopsLeft) : -1;
+
+        double latency = 0.0;
+        double departure = arrival;
+        const char* dropEvent = "drop_relay";
+        bool drop = true;
+        if (hopsLeft <= 0) {
+            dropEvent = "drop_ttl";
+            ttlCounter_->add();
+        }
+        else if (hop < 0) {
+            unreachableCounter_->add();
+        }
+        else if ((departure = transmitFrame(msg.atNode, arrival, msg.cipherText->size())) < 0.0) {
+            dropEvent = "drop_queue";   // relay's transmit queue is full
+            departure = arrival;
+        }
+        else {
+            drop = sampleLink(msg.atNode, hop, latency);
+        }
+
+        if (drop) {
+            msg.dropped = true;
+            droppedCounter_->add();
+
+            // LOG: dropped at relay node (latency = time spent in the mesh)
+            logRow(dropEvent, arrival, msg.id, msg.from, msg.to,
+                arrival - msg.sendTime, 1, nodes_[msg.atNode].name());
+
+            droppedIds_.push_back(msg.id);
+            return false;
+        }
+
+        relayCounter_->add();
+        msg.atNode = hop;
+        msg.atGeneration = generation_[hop];
+        msg.hops++;
+        msg.received = false;
+        msg.deliverTime = departure + latency;
+        return true;
+    }
+
+    // inTransit_ heap order: the earliest event (deliverTime, then id) on top
+    static bool laterEvent(const Message& a, const Message& b) {
+        if (a.deliverTime != b.deliverTime) return a.deliverTime > b.deliverTime;
+        return a.id > b.id;
+    }
+
+    void schedule(Message& msg) {
+        inTransit_.push_back(std::move(msg));
+        std::push_heap(inTransit_.begin(), inTransit_.end(), laterEvent);
+    }
+
+    // processes in-flight events up to 'time' in time order, so every radio
+    // queue sees its frames in arrival order (FIFO service, overflow
+    // decisions and depth/delay statistics depend on it). A frame fully
+    // received, or relayed, becomes a new event at its new time; messages
+    // that reached their destination wait in arrived_ for step().
+    void advance(double time) {
+        while (!inTransit_.empty() && inTransit_.front().deliverTime <= time) {
+            std::pop_heap(inTransit_.begin(), inTransit_.end(), laterEvent);
+            Message msg = std::move(inTransit_.back());
+            inTransit_.pop_back();
+
+            if (removedCount_ > 0 && arrivesAtRemoved(msg)) continue;
+            if (bandwidthLimited_ && !msg.received) {
+                // frame reached the receiver's radio: wait for its turn
+                if (receiveFrame(msg)) schedule(msg);
+                continue;
+            }
+            if (msg.destNode >= 0 && msg.atNode != msg.destNode) {
+                if (relay(msg)) schedule(msg);   // intermediate hop
+                continue;
+            }
+            arrived_.push_back(std::move(msg));
+        }
+    }
+
+    // queueing statistics of one direction (printed by printSummary)
+    struct QueueStats {
+        std::uint64_t frames = 0;
+        std::uint64_t overflows = 0;
+        double totalDelay = 0.0;
+        double maxDelay = 0.0;
+        std::size_t maxDepth = 0;
+    };
+
+    // pass a frame through one of 'node's radio queues starting at 'now';
+    // returns when its last byte is on air (-1 if the queue is full)
+    double queueFrame(std::vector<RadioQueue>& queues, QueueStats& stats,
+        Histogram* depthHist, Histogram* delayHist,
+        int node, double now, std::size_t payloadBytes, bool shaped)
+    {
+        if (node >= static_cast<int>(queues.size())) queues.resize(node + 1);
+
+        double bytes = static_cast<double>(payloadBytes) + bandwidth_.frameOverhead;
+        RadioQueue::Frame frame = queues[node].push(now, bytes, bandwidth_, shaped);
+        depthHist->observe(frame.depth);
+        if (frame.depth > stats.maxDepth) stats.maxDepth = frame.depth;
+        if (!frame.accepted) {
+            stats.overflows++;
+            overflowCounter_->add();
+            return -1.0;
+        }
+
+        double delay = frame.start - now;
+        delayHist->observe(static_cast<std::uint64_t>(delay * 1e6 + 0.5));
+        stats.frames++;
+        stats.totalDelay += delay;
+        if (delay > stats.maxDelay) stats.maxDelay = delay;
+        if (shaped) airtimeCounter_->add(static_cast<std::uint64_t>(bytes));
+        return frame.done;
+    }
+
+    // transmit side; unlimited bandwidth (or unknown sender) sends instantly
+    double transmitFrame(int node, double now, std::size_t payloadBytes) {
+        if (!bandwidthLimited_ || node < 0) return now;
+        return queueFrame(txQueues_, txStats_, txDepthHist_, txDelayHist_,
+            node, now, payloadBytes, true);
+    }
+
+    // receive side: delays msg.deliverTime until the receiver's radio has
+    // taken the whole frame; false (message dropped) if its queue is full
+    bool receiveFrame(Message& msg) {
+        msg.received = true;
+        int node = msg.atNode;
+        if (node < 0) return true;
+
+        double arrival = msg.deliverTime;
+        double done = queueFrame(rxQueues_, rxStats_, rxDepthHist_, rxDelayHist_,
+            node, arrival, msg.cipherText->size(), false);
+        if (done >= 0.0) {
+            msg.deliverTime = done;
+            return true;
+        }
+
+        msg.dropped = true;
+        droppedCounter_->add();
+
+        // LOG: receiver queue overflow
+        logRow("drop_queue", arrival, msg.id, msg.from, msg.to,
+            arrival - msg.sendTime, 1, nodes_[node].name());
+
+        droppedIds_.push_back(msg.id);
+        return false;
+    }
+
+    void printQueueStats(const char* label, const QueueStats& stats) const {
+        std::cout << label << ":           " << stats.frames << " frames, avg delay "
+            << (stats.frames > 0 ? stats.totalDelay / stats.frames : 0.0)
+            << " s, max delay " << stats.maxDelay
+            << " s, max depth " << stats.maxDepth
+            << ", overflows " << stats.overflows << "\n";
+    }
+
+    // msg.plainText holds the plaintext decrypted by decryptBatch(); the
+    // inbox keeps a reference to it, not a copy. The log row and the
+    // stdout echo still format the payload once per recipient.
+    void deliver(const Message& msg, double currentTime) {
+        Node* dest = &nodes_[msg.atNode];
 
         double latency = msg.deliverTime - msg.sendTime;
+        if (router_ && msg.destNode >= 0) router_->recordDelivery(msg.hops);
         deliveredCount_++;
+        deliveredCounter_->add();
         totalLatency_ += latency;
 
-        // Decrypt at the destination
-        std::string plaintext = xorCipher(msg.cipherText, encryptionKey_);
+        const std::string& plaintext = *msg.plainText;
 
-        dest->onMessageReceived(msg.id, msg.from, plaintext,
+        dest->onMessageReceived(msg.id, msg.from, msg.plainText,
             msg.deliverTime, latency);
 
-        std::cout << std::fixed << std::setprecision(3)
-            << "[t=" << currentTime << "] "
-            << "[DELIVER] " << msg.from << " -> " << msg.to
-            << "  msgId=" << msg.id
-            << "  latency=" << latency
-            << "  payload=\"" << plaintext << "\"\n";
+        if (printEvents_) {
+            std::cout << std::fixed << std::setprecision(3)
+                << "[t=" << currentTime << "] "
+                << "[DELIVER] " << msg.from << " -> " << msg.to
+                << "  msgId=" << msg.id
+                << "  latency=" << latency
+                << "  payload=\"" << codec::printable(plaintext) << "\"\n";
+        }
 
         // LOG: record delivery event
-        logFile_ << "deliver,"
-            << currentTime << ","
-            << msg.id << ","
-            << msg.from << ","
-            << msg.to << ","
-            << latency << ","
-            << 0 << ","              // not dropped
-            << "\"" << plaintext << "\""
-            << "\n";
+        logRow("deliver", currentTime, msg.id, msg.from, msg.to, latency,
+            0,      // not dropped
+            plaintext);
+    }
+
+    // one comms_log.csv row into logBuffer_ (numbers via to_chars, same
+    // text as the default ofstream formatting); frames are described, and
+    // quotes inside the quoted payload field are doubled (RFC 4180)
+    void logRow(std::string_view event, double time, long long id,
+        std::string_view from, std::string_view to,
+        double latency, std::uint64_t dropped, std::string_view payload) {
+        if (logPath_.empty() && observers_.empty()) return;
+        logBuffer_.append(event);
+        logBuffer_ += ',';
+        CsvFormat::appendReal(logBuffer_, time);
+        logBuffer_ += ',';
+        CsvFormat::appendInt(logBuffer_, id);
+        logBuffer_ += ',';
+        logBuffer_.append(from);
+        logBuffer_ += ',';
+        logBuffer_.append(to);
+        logBuffer_ += ',';
+        CsvFormat::appendReal(logBuffer_, latency);
+        logBuffer_ += ',';
+        CsvFormat::appendInt(logBuffer_, dropped);
+        logBuffer_ += ",\"";
+        std::string_view text = payload;
+        if (codec::isFrame(payload)) {
+            frameText_.str(std::string());
+            codec::describe(frameText_, payload);
+            frameString_ = frameText_.str();
+            text = frameString_;
+        }
+        for (std::size_t begin = 0; begin <= text.size(); ) {
+            std::size_t quote = text.find('"', begin);
+            if (quote == std::string_view::npos) {
+                logBuffer_.append(text.substr(begin));
+                break;
+            }
+            logBuffer_.append(text.substr(begin, quote + 1 - begin));
+            logBuffer_ += '"';
+            begin = quote + 1;
+        }
+
+        if (!observers_.empty()) {
+            CommsEvent e;
+            e.event = event;
+            e.time = time;
+            e.id = id;
+            e.from = from;
+            e.to = to;
+            e.latency = latency;
+            e.dropped = dropped;
+            e.payload = text;
+            for (CommsObserver* observer : observers_) observer->onCommsEvent(e);
+        }
+        logBuffer_ += "\"\n";
+    }
+
+    // one write per step
+    void flushLog() {
+        if (logBuffer_.empty()) return;
+        if (compressedLog_) compressedLog_->write(logBuffer_.data(), logBuffer_.size());
+        else if (logFile_.is_open()) logFile_.write(logBuffer_.data(), static_cast<std::streamsize>(logBuffer_.size()));
+        else {
+            logBuffer_.clear();   // observers only
+            return;
+        }
+        logBytesCounter_->add(logBuffer_.size());
+        logBuffer_.clear();
     }
 
     std::ofstream logFile_;
+    std::unique_ptr<CompressedLogWriter> compressedLog_;
+    std::vector<CommsObserver*> observers_;
+    std::string logBuffer_;
+    std::ostringstream frameText_;
+    std::string frameString_;
 
     // network parameters
     double baseLatency_;
     double jitter_;
     double dropProb_;
+    std::string logPath_;
+    bool printEvents_;
 
     // nodes
     std::vector<Node> nodes_;
     std::unordered_map<std::string, int> nodeIndex_;
+    std::vector<char> removed_;     // per node index: free (removeNode)
+    std::vector<std::uint32_t> generation_;   // per node index, bumped by removeNode
+    std::vector<std::string> departedName_;   // per node index: last removed node
+    std::vector<int> freeIndices_;  // removed indices, reused by addNode
+    std::size_t removedCount_ = 0;  // removals so far (fast path when 0)
+
+    // range-limited radio model (null = all-to-all)
+    std::unique_ptr<RadioLinkModel> links_;
+    std::unique_ptr<MeshRouter> router_;
+
+    // per-node radio queues (enableBandwidthLimits)
+    bool bandwidthLimited_ = false;
+    BandwidthParams bandwidth_;
+    std::vector<RadioQueue> txQueues_;
+    std::vector<RadioQueue> rxQueues_;
+    QueueStats txStats_;
+    QueueStats rxStats_;
+
+    // multicast groups (node indices)
+    std::unordered_map<std::string, std::vector<int>> groups_;
+    std::vector<std::vector<std::string>> nodeGroups_;   // per node index: groups it is in
+    std::vector<int> allNodes_;
 
     // in-flight and dropped messages
-    std::vector<Message> inTransit_;
-    std::vector<Message> droppedMessages_;
+    std::vector<Message> inTransit_;    // heap, see laterEvent()
+    std::vector<Message> arrived_;      // at their destination, delivered by step()
+    std::vector<int> droppedIds_;      // ids of dropped messages
+    std::vector<int> fanOutDrops_;     // recipients dropped by the current fanOut()
 
-    int nextMessageId_ = 1;
+    // concurrent send path (postMessage -> flushPosted)
+    MpscQueue<PostedMessage> posted_;
+    std::vector<PostedMessage> postedBatch_;
+
+    std::atomic<int> nextMessageId_{ 1 };
     int deliveredCount_ = 0;
     double totalLatency_ = 0.0;
 
@@ -222,6 +1075,33 @@ private:
     std::uniform_real_distribution<double> uniform01_;
     std::uniform_real_distribution<double> jitterDist_;
 
-    // "encryption"
+    // encryption (ChaCha20, key derived from the passphrase)
     std::string encryptionKey_ = "USMC-COMMS-KEY";
+    ChaCha20::Key cipherKey_ = ChaCha20::deriveKey(encryptionKey_);
+    std::vector<ChaCha20::Job> cipherJobs_;
+    std::vector<Message> wireBatch_;
+    std::unordered_map<const std::string*, std::shared_ptr<const std::string>> sharedSeen_;
+    std::uint64_t cipherBytes_ = 0;
+    std::uint64_t cipherNanos_ = 0;
+
+    // runtime metrics (registered in MetricsRegistry::global())
+    Counter* sentCounter_ = nullptr;
+    Counter* droppedCounter_ = nullptr;
+    Counter* deliveredCounter_ = nullptr;
+    Histogram* deliveredPerStep_ = nullptr;
+    Gauge* inFlightGauge_ = nullptr;
+    Counter* logBytesCounter_ = nullptr;
+    Counter* postedCounter_ = nullptr;
+    Counter* cipherBytesCounter_ = nullptr;
+    Counter* cipherNanosCounter_ = nullptr;
+    Counter* unreachableCounter_ = nullptr;
+    Counter* relayCounter_ = nullptr;
+    Counter* ttlCounter_ = nullptr;
+    Histogram* txDepthHist_ = nullptr;
+    Histogram* txDelayHist_ = nullptr;
+    Histogram* rxDepthHist_ = nullptr;
+    Histogram* rxDelayHist_ = nullptr;
+    Counter* overflowCounter_ = nullptr;
+    Counter* airtimeCounter_ = nullptr;
+    Counter* unknownGroupCounter_ = nullptr;
 };
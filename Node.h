@@ -1,13 +1,16 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <vector>
 
 struct ReceivedMessage {
     int id;
     std::string from;
-    std::string payload;
+    std::shared_ptr<const std::string> body;   // shared by all recipients of a fan-out
     double timeReceived;
     double latency;
+
+    const std::string& payload() const { return *body; }
 };
 
 class Node {
@@ -18,11 +21,11 @@ public:
 
     void onMessageReceived(int id,
         const std::string& from,
-        const std::string& payload,
+        std::shared_ptr<const std::string> payload,
         double timeReceived,
         double latency)
     {
-        inbox_.push_back({ id, from, payload, timeReceived, latency });
+        inbox_.push_back({ id, from, std::move(payload), timeReceived, latency });
     }
 
     const std::vector<ReceivedMessage>& inbox() const { return inbox_; }
@@ -0,0 +1,183 @@
+#include "ParameterSweep.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include "CsvFormat.h"
+#include "Profiler.h"
+#include "WorkerPool.h"
+#include "WorldBatch.h"
+
+ParameterSweep::ParameterSweep(const SweepParams& params)
+    : mParams(params)
+{
+}
+
+namespace {
+
+    // written as !(x > 0) so that NaN is rejected too
+    std::string checkScenario(const ScenarioParams& scenario) {
+        if (!(scenario.dt > 0.0)) return "dt must be positive";
+        if (!(scenario.duration >= 0.0)) return "duration must not be negative";
+        if (!(scenario.stopRadius >= 0.0)) return "stopRadius must not be negative";
+        return std::string();
+    }
+}
+
+std::string ParameterSweep::validate() const {
+    if (mParams.ranges.empty()) return "no parameter ranges";
+    std::string problem = checkScenario(mParams.base);
+    if (!problem.empty()) return "base scenario: " + problem;
+
+    // each check bounds a single parameter: valid ends make a valid range
+    for (const SweepRange& range : mParams.ranges) {
+        ScenarioParams probe = mParams.base;
+        if (!setScenarioParameter(probe, range.name, range.min)) return "unknown parameter '" + range.name + "'";
+        if (!(range.min <= range.max)) return "range '" + range.name + "': min > max";
+        problem = checkScenario(probe);
+        setScenarioParameter(probe, range.name, range.max);
+        if (problem.empty()) problem = checkScenario(probe);
+        if (!problem.empty()) return "range '" + range.name + "': " + problem;
+    }
+    return std::string();
+}
+
+/*
+ * @brief:
+ *         Enumerates the grid (first range varies slowest) or draws the
+ *         Latin hypercube from the sweep seed.
+ */
+
+std::vector<std::vector<double>> ParameterSweep::points() const {
+    const std::size_t dims = mParams.ranges.size();
+    std::vector<std::vector<double>> points;
+    if (dims == 0) return points;
+
+    if (mParams.mode == SweepParams::Mode::Grid) {
+        std::size_t total = 1;
+        for (const SweepRange& range : mParams.ranges) total *= std::max<std::size_t>(range.steps, 1);
+        points.assign(total, std::vector<double>(dims));
+        for (std::size_t p = 0; p < total; ++p) {
+            std::size_t rest = p;
+            for (std::size_t d = dims; d-- > 0;) {
+                const SweepRange& range = mParams.ranges[d];
+                std::size_t steps = std::max<std::size_t>(range.steps, 1);
+                std::size_t k = rest % steps;
+                rest /= steps;
+                points[p][d] = steps == 1 ? range.min
+                    : range.min + (range.max - range.min) * static_cast<double>(k) / static_cast<double>(steps - 1);
+            }
+        }
+        return points;
+    }
+
+    const std::size_t n = mParams.samples;
+    points.assign(n, std::vector<double>(dims));
+    std::mt19937_64 rng(runSeed(mParams.seed, ~std::uint64_t(0)));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::size_t> strata(n);
+    for (std::size_t d = 0; d < dims; ++d) {
+        const SweepRange& range = mParams.ranges[d];
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng);
+        for (std::size_t p = 0; p < n; ++p) {
+            double u = (static_cast<double>(strata[p]) + unit(rng)) / static_cast<double>(n);
+            points[p][d] = range.min + (range.max - range.min) * u;
+        }
+    }
+    return points;
+}
+
+/*
+ * @brief:
+ *         Runs points x repeats tasks on the pool, each into its own result
+ *         slot, then reduces every point's repeats.
+ */
+
+std::vector<SweepPoint> ParameterSweep::run() {
+    const std::vector<std::vector<double>> values = points();
+    const std::size_t repeats = std::max<std::size_t>(mParams.repeats, 1);
+    std::vector<ScenarioResult> outcomes(values.size() * repeats);
+
+    auto scenarioFor = [&](std::size_t task) {
+        ScenarioParams scenario = mParams.base;
+        const std::vector<double>& point = values[task / repeats];
+        for (std::size_t d = 0; d < point.size(); ++d) {
+            setScenarioParameter(scenario, mParams.ranges[d].name, point[d]);
+        }
+        scenario.network.seed = runSeed(mParams.seed, task);
+        scenario.network.logPath.clear();
+        scenario.network.printEvents = false;
+        return scenario;
+    };
+
+    WorkerPool pool(mParams.threads);
+    if (mParams.batchWorlds > 0) {
+        // consecutive tasks share a batch; a dt or duration change inside a
+        // group just splits it (runScenarioBatch)
+        const std::size_t width = mParams.batchWorlds;
+        pool.run((outcomes.size() + width - 1) / width, [&](std::size_t group, std::size_t) {
+            PROFILE_SCOPE("sweep.batch");
+            const std::size_t first = group * width;
+            const std::size_t count = std::min(width, outcomes.size() - first);
+            std::vector<ScenarioParams> scenarios(count);
+            for (std::size_t i = 0; i < count; ++i) scenarios[i] = scenarioFor(first + i);
+            runScenarioBatch(scenarios.data(), count, &outcomes[first], width);
+        });
+    }
+    else {
+        std::vector<std::vector<double>> latencies(pool.size());
+        pool.run(outcomes.size(), [&](std::size_t task, std::size_t worker) {
+            PROFILE_SCOPE("sweep.run");
+            outcomes[task] = runScenario(scenarioFor(task), latencies[worker]);
+        });
+    }
+
+    std::vector<SweepPoint> results(values.size());
+    for (std::size_t p = 0; p < values.size(); ++p) {
+        SweepPoint& point = results[p];
+        point.values = values[p];
+        point.runs = repeats;
+        double convergenceSum = 0.0, deliverySum = 0.0, p50Sum = 0.0, p99Sum = 0.0;
+        for (std::size_t r = 0; r < repeats; ++r) {
+            const ScenarioResult& outcome = outcomes[p * repeats + r];
+            if (outcome.converged()) {
+                ++point.converged;
+                convergenceSum += outcome.convergenceTime;
+            }
+            point.maxOvershoot = std::max(point.maxOvershoot, outcome.maxOvershoot);
+            deliverySum += outcome.deliveryRatio();
+            p50Sum += outcome.latencyP50;
+            p99Sum += outcome.latencyP99;
+        }
+        if (point.converged) point.convergenceTime = convergenceSum / static_cast<double>(point.converged);
+        point.deliveryRatio = deliverySum / static_cast<double>(repeats);
+        point.latencyP50 = p50Sum / static_cast<double>(repeats);
+        point.latencyP99 = p99Sum / static_cast<double>(repeats);
+    }
+    return results;
+}
+
+void ParameterSweep::writeTable(std::ostream& out, const std::vector<SweepPoint>& results) const {
+    std::string text;
+    for (const SweepRange& range : mParams.ranges) {
+        text += range.name;
+        text += ',';
+    }
+    text += "runs,converged,convergence_time,max_overshoot,delivery_ratio,latency_p50,latency_p99\n";
+
+    for (const SweepPoint& point : results) {
+        for (double v : point.values) {
+            CsvFormat::appendReal(text, v);
+            text += ',';
+        }
+        CsvFormat::appendInt(text, point.runs);
+        text += ',';
+        CsvFormat::appendInt(text, point.converged);
+        for (double v : { point.convergenceTime, point.maxOvershoot, point.deliveryRatio, point.latencyP50, point.latencyP99 }) {
+            text += ',';
+            CsvFormat::appendReal(text, v);
+        }
+        text += '\n';
+    }
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
@@ -0,0 +1,125 @@
+#ifndef PARAMETER_SWEEP_H
+#define PARAMETER_SWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Scenario.h"
+
+/*
+ * @class:
+ *         SweepRange
+ * @brief:
+ *         One swept parameter (a setScenarioParameter() name) and its range.
+ */
+
+struct SweepRange {
+    std::string name;
+    double min = 0.0;
+    double max = 0.0;
+    std::size_t steps = 1;      // grid points (grid mode only; 1 = min only)
+};
+
+/*
+ * @class:
+ *         SweepParams
+ * @brief:
+ *         Base scenario, swept ranges and how points are chosen.
+ *
+ * Grid mode evaluates the cartesian product of every range's steps. Latin
+ * hypercube mode draws 'samples' points such that every range, cut into
+ * 'samples' equal strata, has exactly one point per stratum — a few
+ * dozen points cover many parameters where a grid would need thousands.
+ */
+
+struct SweepParams {
+    enum class Mode { Grid, LatinHypercube };
+
+    ScenarioParams base = demoScenario();
+    std::vector<SweepRange> ranges;
+    Mode mode = Mode::Grid;
+    std::size_t samples = 32;   // Latin hypercube points
+    std::size_t repeats = 1;    // runs per point, each with its own network seed
+    std::uint64_t seed = 1;
+    std::size_t threads = 0;    // 0 = one per hardware thread
+
+    // > 0: dynamics only, this many runs per WorldBatch (SIMD lanes); the
+    // network is not simulated, so delivery/latency scores stay 0
+    std::size_t batchWorlds = 0;
+};
+
+/*
+ * @class:
+ *         SweepPoint
+ * @brief:
+ *         Scores of one parameter combination, over its repeats.
+ */
+
+struct SweepPoint {
+    std::vector<double> values;         // one per range, in range order
+    std::size_t runs = 0;
+    std::size_t converged = 0;
+    double convergenceTime = -1.0;      // mean over converged runs, -1 if none
+    double maxOvershoot = 0.0;          // worst run
+    double deliveryRatio = 0.0;         // mean
+    double latencyP50 = 0.0;            // mean of the runs' percentiles
+    double latencyP99 = 0.0;
+};
+
+/*
+ * @class:
+ *         ParameterSweep
+ * @brief:
+ *         Evaluates a scenario over a grid or Latin hypercube of parameter
+ *         values, headless and in parallel (WorkerPool).
+ *
+ * Every (point, repeat) is an independent runScenario() with logs and
+ * console output off and network seed runSeed(seed, task), so a sweep is
+ * reproducible whatever the thread count.
+ */
+
+class ParameterSweep {
+public:
+    explicit ParameterSweep(const SweepParams& params);
+
+    /*
+     * @brief:
+     *         Checks the parameter names, that every range has min <= max,
+     *         and that the base scenario and both ends of every range have
+     *         dt > 0, duration >= 0 and stopRadius >= 0.
+     *
+     * @return:
+     *         Empty if valid, otherwise a message naming the bad range.
+     */
+
+    std::string validate() const;
+
+    /*
+     * @brief:
+     *         Parameter values of every point (one row per point).
+     */
+
+    std::vector<std::vector<double>> points() const;
+
+    /*
+     * @brief:
+     *         Runs every point and returns the scores in point order.
+     */
+
+    std::vector<SweepPoint> run();
+
+    /*
+     * @brief:
+     *         Writes the results as CSV: one column per parameter, then the
+     *         scores.
+     */
+
+    void writeTable(std::ostream& out, const std::vector<SweepPoint>& results) const;
+
+private:
+    SweepParams mParams;
+};
+
+#endif // PARAMETER_SWEEP_H
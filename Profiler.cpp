@@ -0,0 +1,287 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(DRONESIM_PROFILE_RDTSC) && (defined(__x86_64__) || defined(_M_X64))
+#define DRONESIM_USE_RDTSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+namespace {
+
+    // Deepest nesting level tracked for self-time accounting.
+    constexpr int kMaxDepth = 63;
+
+    // Upper bound on trace events kept per thread. Summary statistics keep
+    // accumulating after the trace buffer is full.
+    constexpr std::size_t kMaxTraceEvents = 4u * 1024u * 1024u;
+
+    struct ScopeEvent {
+        const char* name;
+        std::uint64_t start;
+        std::uint64_t end;
+        int depth;
+    };
+
+    // One node of the call tree: a scope name under a given parent node
+    // (index into the same vector, -1 at the root). Parents always come
+    // before their children.
+    struct ScopeStats {
+        const char* name;
+        int parent;
+        std::uint64_t calls;
+        std::uint64_t totalTicks;
+        std::uint64_t selfTicks;
+        std::uint64_t maxTicks;
+    };
+
+    struct ThreadBuffer {
+        int threadIndex = 0;
+        int depth = 0;
+        std::uint64_t childTicks[kMaxDepth + 2] = {};
+        int scopeNodes[kMaxDepth + 1] = {};
+        std::vector<ScopeEvent> events;
+        std::vector<ScopeStats> stats;
+    };
+
+    // Buffers are owned by the registry so they outlive their threads.
+    std::mutex gRegistryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> gBuffers;
+
+    thread_local ThreadBuffer* tBuffer = nullptr;
+
+    std::uint64_t steadyNanoseconds() {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Clock reference captured at startup: used as the trace origin and,
+    // for the TSC clock, to calibrate ticks to nanoseconds.
+    const std::uint64_t gEpochTicks = Profiler::now();
+    const std::uint64_t gEpochNanos = steadyNanoseconds();
+
+    ThreadBuffer& localBuffer() {
+        if (!tBuffer) {
+            std::lock_guard<std::mutex> lock(gRegistryMutex);
+            gBuffers.push_back(std::make_unique<ThreadBuffer>());
+            tBuffer = gBuffers.back().get();
+            tBuffer->threadIndex = static_cast<int>(gBuffers.size());
+            tBuffer->events.reserve(4096);
+        }
+        return *tBuffer;
+    }
+
+    double nanosPerTick() {
+#if defined(DRONESIM_USE_RDTSC)
+        std::uint64_t ticks = Profiler::now() - gEpochTicks;
+        std::uint64_t nanos = steadyNanoseconds() - gEpochNanos;
+        return ticks > 0 ? static_cast<double>(nanos) / static_cast<double>(ticks) : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+
+    // Node for 'name' under 'parent' in a thread's tree, created on first
+    // use. Linear scan: a run has only a handful of distinct scopes.
+    int findNode(std::vector<ScopeStats>& stats, const char* name, int parent) {
+        for (std::size_t i = 0; i < stats.size(); ++i) {
+            if (stats[i].name == name && stats[i].parent == parent) return static_cast<int>(i);
+        }
+        stats.push_back({ name, parent, 0, 0, 0, 0 });
+        return static_cast<int>(stats.size()) - 1;
+    }
+
+    // Prints the children of node 'parent' (visited in 'order', sorted by
+    // total time) and recurses into each of them.
+    void printTree(std::ostream& out, const std::vector<ScopeStats>& stats,
+        const std::vector<int>& order, int parent, int depth, double msPerTick) {
+        if (depth > kMaxDepth) {
+            return;
+        }
+        for (int node : order) {
+            const ScopeStats& s = stats[node];
+            if (s.parent != parent) {
+                continue;
+            }
+            std::string label = std::string(static_cast<std::size_t>(depth) * 2, ' ') + s.name;
+            double total = static_cast<double>(s.totalTicks) * msPerTick;
+            out << std::left << std::setw(32) << label
+                << std::right << std::setw(12) << s.calls
+                << std::setw(14) << total
+                << std::setw(14) << static_cast<double>(s.selfTicks) * msPerTick
+                << std::setw(14) << (s.calls ? total * 1000.0 / static_cast<double>(s.calls) : 0.0)
+                << std::setw(14) << static_cast<double>(s.maxTicks) * msPerTick * 1000.0 << "\n";
+            printTree(out, stats, order, node, depth + 1, msPerTick);
+        }
+    }
+
+    void writeEscaped(std::ostream& out, const char* text) {
+        for (const char* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') out << '\\';
+            out << *c;
+        }
+    }
+}
+
+/*
+ * @brief:
+ *         Reads the profiler clock (TSC or steady_clock nanoseconds).
+ */
+
+std::uint64_t Profiler::now() {
+#if defined(DRONESIM_USE_RDTSC)
+    return __rdtsc();
+#else
+    return steadyNanoseconds();
+#endif
+}
+
+/*
+ * @brief:
+ *         Opens a scope on the calling thread.
+ * @return: Depth of the new scope.
+ */
+
+int Profiler::enter(const char* name) {
+    ThreadBuffer& buf = localBuffer();
+    int depth = buf.depth++;
+    if (depth <= kMaxDepth) {
+        buf.childTicks[depth + 1] = 0;
+        buf.scopeNodes[depth] = findNode(buf.stats, name, depth > 0 ? buf.scopeNodes[depth - 1] : -1);
+    }
+    return depth;
+}
+
+/*
+ * @brief:
+ *         Closes a scope: updates self-time bookkeeping, aggregates the
+ *         statistics of its call-tree node and appends a trace event.
+ */
+
+void Profiler::record(const char* name, std::uint64_t start, std::uint64_t end, int depth) {
+    ThreadBuffer& buf = localBuffer();
+    buf.depth = depth;
+
+    std::uint64_t duration = end - start;
+    std::uint64_t self = duration;
+    if (depth <= kMaxDepth) {
+        std::uint64_t children = buf.childTicks[depth + 1];
+        self = children < duration ? duration - children : 0;
+        buf.childTicks[depth] += duration;
+    }
+
+    // scopes nested deeper than kMaxDepth are folded under the deepest tracked one
+    int node = depth <= kMaxDepth ? buf.scopeNodes[depth] : findNode(buf.stats, name, buf.scopeNodes[kMaxDepth]);
+    ScopeStats* stats = &buf.stats[node];
+    stats->calls++;
+    stats->totalTicks += duration;
+    stats->selfTicks += self;
+    stats->maxTicks = std::max(stats->maxTicks, duration);
+
+    if (buf.events.size() < kMaxTraceEvents) {
+        buf.events.push_back({ name, start, end, depth });
+    }
+}
+
+/*
+ * @brief:
+ *         Writes all trace events as a Chrome trace-event JSON document.
+ *
+ * Timestamps are microseconds relative to program start. Should be called
+ * once worker threads have stopped recording.
+ */
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    const double usPerTick = nanosPerTick() / 1000.0;
+
+    std::lock_guard<std::mutex> lock(gRegistryMutex);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const auto& buf : gBuffers) {
+        for (const auto& e : buf->events) {
+            out << (first ? "\n" : ",\n");
+            first = false;
+            out << "{\"name\":\"";
+            writeEscaped(out, e.name);
+            out << "\",\"cat\":\"sim\",\"ph\":\"X\",\"pid\":1"
+                << ",\"tid\":" << buf->threadIndex
+                << ",\"ts\":" << static_cast<double>(e.start - gEpochTicks) * usPerTick
+                << ",\"dur\":" << static_cast<double>(e.end - e.start) * usPerTick
+                << ",\"args\":{\"depth\":" << e.depth << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+/*
+ * @brief:
+ *         Prints calls, total, self, average and maximum time per scope,
+ *         merged across threads, as a call tree with siblings sorted by
+ *         total time.
+ */
+
+void Profiler::printSummary(std::ostream& out) {
+    // threads are merged by call path: a node maps to the merged node with
+    // the same name under the merged counterpart of its parent
+    std::vector<ScopeStats> merged;
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        std::vector<int> remap;
+        for (const auto& buf : gBuffers) {
+            remap.assign(buf->stats.size(), -1);
+            for (std::size_t i = 0; i < buf->stats.size(); ++i) {
+                const ScopeStats& s = buf->stats[i];
+                int parent = s.parent < 0 ? -1 : remap[s.parent];
+                auto it = std::find_if(merged.begin(), merged.end(),
+                    [&](const ScopeStats& m) { return m.parent == parent && std::strcmp(m.name, s.name) == 0; });
+                remap[i] = static_cast<int>(it - merged.begin());
+                if (it == merged.end()) {
+                    merged.push_back(s);
+                    merged.back().parent = parent;
+                }
+                else {
+                    it->calls += s.calls;
+                    it->totalTicks += s.totalTicks;
+                    it->selfTicks += s.selfTicks;
+                    it->maxTicks = std::max(it->maxTicks, s.maxTicks);
+                }
+            }
+        }
+    }
+
+    std::vector<int> order(merged.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+    std::stable_sort(order.begin(), order.end(),
+        [&](int a, int b) { return merged[a].totalTicks > merged[b].totalTicks; });
+
+    out << "\n=== Profile Summary ===\n";
+    out << std::left << std::setw(32) << "scope"
+        << std::right << std::setw(12) << "calls"
+        << std::setw(14) << "total(ms)"
+        << std::setw(14) << "self(ms)"
+        << std::setw(14) << "avg(us)"
+        << std::setw(14) << "max(us)" << "\n";
+
+    out << std::fixed << std::setprecision(3);
+    printTree(out, merged, order, -1, 0, nanosPerTick() / 1.0e6);
+}
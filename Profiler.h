@@ -0,0 +1,130 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+ * @class:
+ *         Profiler
+ * @brief:
+ *         Low-overhead hierarchical scoped timer.
+ *
+ * Scopes are recorded with the PROFILE_SCOPE("name") macro. Each thread
+ * writes into its own buffer, so recording never takes a lock (a mutex is
+ * only used once per thread to register the buffer). Nesting depth and
+ * self time (duration minus time spent in child scopes) are tracked as
+ * scopes close.
+ *
+ * Timestamps come from std::chrono::steady_clock. Building with
+ * DRONESIM_PROFILE_RDTSC on x86 switches to the time-stamp counter, which
+ * is calibrated against steady_clock when results are written.
+ *
+ * Profiling is compiled out entirely unless DRONESIM_PROFILE is defined;
+ * PROFILE_SCOPE then expands to nothing.
+ *
+ * At the end of a run:
+ * - writeChromeTrace() emits trace-event JSON (chrome://tracing, Perfetto).
+ * - printSummary() prints calls / total / self / avg / max per scope as a
+ *   call tree (a scope is keyed by its call path, so a name used under two
+ *   parents shows up once under each).
+ */
+
+class Profiler {
+public:
+
+    /*
+     * @brief:
+     *         Reads the profiler clock.
+     * @return: Raw ticks (nanoseconds, or TSC cycles with DRONESIM_PROFILE_RDTSC).
+     */
+
+    static std::uint64_t now();
+
+    /*
+     * @brief:
+     *         Records a closed scope in the calling thread's buffer.
+     *
+     * @param: name
+     *         Scope name. Must be a string with static storage duration.
+     * @param: start
+     *         Tick value at scope entry.
+     * @param: end
+     *         Tick value at scope exit.
+     * @param: depth
+     *         Nesting depth of the scope (0 = outermost).
+     */
+
+    static void record(const char* name, std::uint64_t start, std::uint64_t end, int depth);
+
+    /*
+     * @brief:
+     *         Pushes a scope on the calling thread's scope stack.
+     *
+     * @param: name
+     *         Scope name (static storage duration).
+     * @return: Nesting depth of the new scope.
+     */
+
+    static int enter(const char* name);
+
+    /*
+     * @brief:
+     *         Writes every recorded scope as Chrome trace-event JSON.
+     *
+     * @param: path
+     *         Output file path.
+     * @return: true if the file was written.
+     */
+
+    static bool writeChromeTrace(const std::string& path);
+
+    /*
+     * @brief:
+     *         Prints a per-scope call tree aggregated across all threads.
+     *
+     * @param: out
+     *         Destination stream.
+     */
+
+    static void printSummary(std::ostream& out);
+};
+
+/*
+ * @class:
+ *         ProfileScope
+ * @brief:
+ *         RAII helper behind PROFILE_SCOPE. Measures the lifetime of the
+ *         enclosing block.
+ */
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : mName(name), mDepth(Profiler::enter(name)), mStart(Profiler::now()) {
+    }
+
+    ~ProfileScope() {
+        Profiler::record(mName, mStart, Profiler::now(), mDepth);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* mName;
+    int mDepth;
+    std::uint64_t mStart;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(DRONESIM_PROFILE)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,160 @@
+#pragma once
+#include "Vector2.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// parameters of the range-limited radio model
+struct RadioLinkParams {
+    double maxRange = 30.0;          // m, no link beyond this distance
+    double edgeDropProbability = 0.5; // extra drop probability at maxRange (scales with (d/range)^2)
+    double latencyPerMeter = 0.002;   // s/m added on top of base latency + jitter
+};
+
+// Connectivity derived from node positions.
+//
+// Nodes are bucketed into a uniform grid whose cell size equals maxRange, so
+// every neighbor of a node lies in the 3x3 block of cells around it. A node
+// only changes buckets when it crosses a cell boundary; setPosition() for a
+// node that stays inside its cell just stores the new coordinates. Range and
+// link quality between two nodes are evaluated on demand from the stored
+// positions, so link queries never touch more than the two nodes involved.
+//
+// Node indices are the Network's node indices. Nodes without a position
+// (never passed to setPosition) are treated as unconstrained: they reach and
+// are reached by everyone, like the original all-to-all network.
+class RadioLinkModel {
+public:
+    explicit RadioLinkModel(const RadioLinkParams& params)
+        : params_(params),
+        cellSize_(params.maxRange > 0.0 ? params.maxRange : 1.0) {
+    }
+
+    const RadioLinkParams& params() const { return params_; }
+
+    void setPosition(int node, const Vector2& pos) {
+        ensureNode(node);
+        NodeState& ns = nodes_[node];
+        ns.pos = pos;
+
+        std::int64_t key = cellKey(pos);
+        if (ns.placed && key == ns.cell) return;
+
+        if (ns.placed) removeFromCell(node);
+        std::vector<int>& bucket = cells_[key];
+        ns.cell = key;
+        ns.slot = static_cast<int>(bucket.size());
+        ns.placed = true;
+        bucket.push_back(node);
+
+        moved_.push_back(node);
+        ++cellChanges_;
+    }
+
+    // forget a node's position (it becomes unconstrained again)
+    void clearPosition(int node) {
+        if (node < 0 || node >= static_cast<int>(nodes_.size()) || !nodes_[node].placed) return;
+        removeFromCell(node);
+        nodes_[node].placed = false;
+        moved_.push_back(node);
+    }
+
+    bool hasPosition(int node) const {
+        return node >= 0 && node < static_cast<int>(nodes_.size()) && nodes_[node].placed;
+    }
+
+    const Vector2& position(int node) const { return nodes_[node].pos; }
+
+    double distance(int a, int b) const {
+        return (nodes_[a].pos - nodes_[b].pos).length();
+    }
+
+    bool inRange(int a, int b) const {
+        if (!hasPosition(a) || !hasPosition(b)) return true;
+        Vector2 d = nodes_[a].pos - nodes_[b].pos;
+        return d.x * d.x + d.y * d.y <= params_.maxRange * params_.maxRange;
+    }
+
+    // drop probability on the a->b link given the network's base probability;
+    // 1.0 when out of range
+    double dropProbability(int a, int b, double baseDrop) const {
+        if (!hasPosition(a) || !hasPosition(b)) return baseDrop;
+        if (!inRange(a, b)) return 1.0;
+        double r = distance(a, b) / params_.maxRange;
+        double p = baseDrop + (1.0 - baseDrop) * params_.edgeDropProbability * r * r;
+        return p < 1.0 ? p : 1.0;
+    }
+
+    // distance-dependent latency added to the a->b link
+    double extraLatency(int a, int b) const {
+        if (!hasPosition(a) || !hasPosition(b)) return 0.0;
+        return distance(a, b) * params_.latencyPerMeter;
+    }
+
+    // all placed nodes within maxRange of 'node' (excluding itself)
+    void neighbors(int node, std::vector<int>& out) const {
+        out.clear();
+        if (!hasPosition(node)) return;
+        const NodeState& ns = nodes_[node];
+        std::int32_t cx = static_cast<std::int32_t>(ns.cell >> 32);
+        std::int32_t cy = static_cast<std::int32_t>(ns.cell & 0xffffffff);
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                auto it = cells_.find(packCell(cx + dx, cy + dy));
+                if (it == cells_.end()) continue;
+                for (int other : it->second) {
+                    if (other != node && inRange(node, other)) out.push_back(other);
+                }
+            }
+        }
+    }
+
+    // nodes that changed grid cell since the last clearMoved()
+    const std::vector<int>& movedNodes() const { return moved_; }
+    void clearMoved() { moved_.clear(); }
+
+    std::uint64_t cellChanges() const { return cellChanges_; }
+
+private:
+    struct NodeState {
+        Vector2 pos;
+        std::int64_t cell = 0;
+        int slot = -1;      // index inside cells_[cell]
+        bool placed = false;
+    };
+
+    static std::int64_t packCell(std::int32_t cx, std::int32_t cy) {
+        return static_cast<std::int64_t>(
+            (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32)
+            | static_cast<std::uint32_t>(cy));
+    }
+
+    std::int64_t cellKey(const Vector2& pos) const {
+        return packCell(static_cast<std::int32_t>(std::floor(pos.x / cellSize_)),
+            static_cast<std::int32_t>(std::floor(pos.y / cellSize_)));
+    }
+
+    void ensureNode(int node) {
+        if (node >= static_cast<int>(nodes_.size())) nodes_.resize(node + 1);
+    }
+
+    // O(1) swap-remove from the node's current bucket
+    void removeFromCell(int node) {
+        NodeState& ns = nodes_[node];
+        std::vector<int>& bucket = cells_[ns.cell];
+        int last = bucket.back();
+        bucket[ns.slot] = last;
+        nodes_[last].slot = ns.slot;
+        bucket.pop_back();
+        if (bucket.empty()) cells_.erase(ns.cell);
+        ns.slot = -1;
+    }
+
+    RadioLinkParams params_;
+    double cellSize_;
+    std::vector<NodeState> nodes_;
+    std::unordered_map<std::int64_t, std::vector<int>> cells_;
+    std::vector<int> moved_;
+    std::uint64_t cellChanges_ = 0;
+};
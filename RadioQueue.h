@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+
+// parameters of the per-node bandwidth model
+struct BandwidthParams {
+    double lineRate = 250000.0;     // bytes/s on air; sets the serialization delay
+    double tokenRate = 25000.0;     // bytes/s sustained transmit rate (token bucket refill)
+    double bucketBytes = 2048.0;    // transmit burst allowance (token bucket depth)
+    double frameOverhead = 32.0;    // header/MAC bytes added to every frame
+    std::size_t maxQueueDepth = 64; // frames waiting per queue, 0 = unbounded
+};
+
+// One direction (transmit or receive) of a node's radio.
+//
+// Frames are served FIFO, one at a time, each occupying the radio for
+// bytes / lineRate seconds. A shaped queue (the transmit side) must also
+// hold enough tokens before a frame may start: the bucket refills at
+// tokenRate up to bucketBytes, so short bursts go out at line rate and
+// sustained traffic is held to tokenRate.
+//
+// Times are simulation seconds. push() returns when the frame starts and
+// finishes; a full queue (maxQueueDepth frames not yet finished) rejects it.
+class RadioQueue {
+public:
+    struct Frame {
+        double start;       // radio starts sending/receiving the frame
+        double done;        // last byte sent/received
+        std::size_t depth;  // frames ahead of this one when it was queued
+        bool accepted;
+    };
+
+    Frame push(double now, double bytes, const BandwidthParams& params, bool shaped) {
+        while (!pending_.empty() && pending_.front() <= now) pending_.pop_front();
+
+        Frame frame{ now, now, pending_.size(), false };
+        if (params.maxQueueDepth > 0 && pending_.size() >= params.maxQueueDepth) return frame;
+
+        double start = busyUntil_ > now ? busyUntil_ : now;
+        if (shaped && params.tokenRate > 0.0) {
+            if (!primed_) {
+                tokens_ = params.bucketBytes;   // bucket starts full
+                tokenTime_ = start;
+                primed_ = true;
+            }
+            tokens_ += (start - tokenTime_) * params.tokenRate;
+            if (tokens_ > params.bucketBytes) tokens_ = params.bucketBytes;
+
+            // frames larger than the bucket wait for a full bucket and
+            // leave it in debt
+            double need = bytes < params.bucketBytes ? bytes : params.bucketBytes;
+            if (tokens_ < need) {
+                start += (need - tokens_) / params.tokenRate;
+                tokens_ = need;
+            }
+            tokens_ -= bytes;
+            tokenTime_ = start;
+        }
+
+        busyUntil_ = start + bytes / params.lineRate;
+        pending_.push_back(busyUntil_);
+
+        frame.start = start;
+        frame.done = busyUntil_;
+        frame.accepted = true;
+        return frame;
+    }
+
+    // frames queued or in progress at time 'now'
+    std::size_t depth(double now) {
+        while (!pending_.empty() && pending_.front() <= now) pending_.pop_front();
+        return pending_.size();
+    }
+
+private:
+    double busyUntil_ = 0.0;
+    double tokens_ = 0.0;
+    double tokenTime_ = 0.0;
+    bool primed_ = false;
+    std::deque<double> pending_;   // completion time of unfinished frames
+};
@@ -0,0 +1,178 @@
+#include "RealTimePacer.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <time.h>
+#else
+#include <thread>
+#endif
+
+namespace {
+
+    constexpr std::size_t kJitterBins = 10000;   // 10 ms at 1 us, plus one overflow bin
+
+    // monotonic clock in ns (the clock clock_nanosleep() sleeps against)
+    std::int64_t nowNs() {
+#if defined(__linux__)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // absolute-deadline sleep: wake-up time does not depend on when the
+    // call was made, so per-step sleeps never accumulate drift
+    void sleepUntil(std::int64_t deadlineNs) {
+#if defined(__linux__)
+        timespec ts;
+        ts.tv_sec = static_cast<time_t>(deadlineNs / 1000000000);
+        ts.tv_nsec = static_cast<long>(deadlineNs % 1000000000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(deadlineNs))));
+#endif
+    }
+}
+
+RealTimePacer::RealTimePacer(double dt, const PacingParams& params)
+    : mDt(dt),
+    mParams(params),
+    mPeriodNs(std::max<std::int64_t>(1, static_cast<std::int64_t>(dt / params.realTimeFactor * 1e9 + 0.5))),
+    mSpinNs(static_cast<std::int64_t>(params.spinMicros * 1e3)),
+    mJitterBins(kJitterBins + 1, 0),
+    mOverrunCounter(&MetricsRegistry::global().counter("pacing.overruns")),
+    mSkippedCounter(&MetricsRegistry::global().counter("pacing.skipped_ticks")),
+    mOverrunNs(&MetricsRegistry::global().histogram("pacing.overrun_ns")),
+    mBusyNs(&MetricsRegistry::global().histogram("pacing.busy_ns")),
+    mJitterNs(&MetricsRegistry::global().histogram("pacing.wake_jitter_ns"))
+{
+}
+
+void RealTimePacer::start() {
+    mAnchorNs = nowNs();
+    mNextStartNs = mAnchorNs;
+    mStepBeginNs = mAnchorNs;
+}
+
+/*
+ * @brief:
+ *         The step that just ended owned the slot [mNextStartNs,
+ *         mNextStartNs + period). Finishing after the slot is an overrun;
+ *         the policy then picks the next start time, otherwise it is the
+ *         end of the slot.
+ */
+
+void RealTimePacer::wait() {
+    const std::int64_t now = nowNs();
+    const std::int64_t busy = now - mStepBeginNs;
+    ++mStats.steps;
+    mStats.simSeconds += mDt;
+    mBusyTotalNs += busy;
+    mStats.maxBusy = std::max(mStats.maxBusy, busy * 1e-9);
+    mBusyNs->observe(static_cast<std::uint64_t>(busy));
+
+    const std::int64_t deadline = mNextStartNs + mPeriodNs;
+    std::int64_t next = deadline;
+    if (now > deadline) {
+        const std::int64_t late = now - deadline;
+        ++mStats.overruns;
+        mStats.maxOverrun = std::max(mStats.maxOverrun, late * 1e-9);
+        mOverrunCounter->add();
+        mOverrunNs->observe(static_cast<std::uint64_t>(late));
+
+        std::int64_t skipped = 0;
+        switch (mParams.policy) {
+        case OverrunPolicy::CatchUp: {
+            // whole ticks already missed beyond the next one
+            std::int64_t behind = late / mPeriodNs;
+            std::int64_t limit = static_cast<std::int64_t>(mParams.maxCatchUpSteps);
+            if (behind > limit) skipped = behind - limit;
+            next += skipped * mPeriodNs;
+            break;
+        }
+        case OverrunPolicy::Skip:
+            // every tick whose start time has passed
+            skipped = late / mPeriodNs + 1;
+            next += skipped * mPeriodNs;
+            break;
+        case OverrunPolicy::SlowDown:
+            next = now;
+            break;
+        }
+        if (skipped > 0) {
+            mStats.skippedTicks += static_cast<std::uint64_t>(skipped);
+            mSkippedCounter->add(static_cast<std::uint64_t>(skipped));
+        }
+    }
+    mNextStartNs = next;
+
+    if (next > now) {
+        if (next - mSpinNs > now) sleepUntil(next - mSpinNs);
+        std::int64_t woke = nowNs();
+        while (woke < next) woke = nowNs();
+        observeJitter(woke - next);
+        mStepBeginNs = woke;
+    }
+    else {
+        if (next < now) ++mStats.catchUpSteps;
+        mStepBeginNs = now;
+    }
+    mStats.wallSeconds = (mStepBeginNs - mAnchorNs) * 1e-9;
+}
+
+void RealTimePacer::observeJitter(std::int64_t lateNs) {
+    ++mWakeups;
+    mJitterTotalNs += lateNs;
+    mStats.maxJitter = std::max(mStats.maxJitter, lateNs * 1e-9);
+    mJitterNs->observe(static_cast<std::uint64_t>(lateNs));
+    std::size_t bin = static_cast<std::size_t>(lateNs / 1000);
+    ++mJitterBins[std::min(bin, kJitterBins)];
+}
+
+PacingStats RealTimePacer::stats() const {
+    PacingStats s = mStats;
+    if (s.steps) s.meanBusy = static_cast<double>(mBusyTotalNs) * 1e-9 / static_cast<double>(s.steps);
+    if (mWakeups) {
+        s.meanJitter = static_cast<double>(mJitterTotalNs) * 1e-9 / static_cast<double>(mWakeups);
+        std::uint64_t rank = static_cast<std::uint64_t>(0.99 * static_cast<double>(mWakeups));
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b <= kJitterBins; ++b) {
+            seen += mJitterBins[b];
+            if (seen > rank) {
+                s.p99Jitter = b == kJitterBins ? s.maxJitter : static_cast<double>(b + 1) * 1e-6;
+                break;
+            }
+        }
+    }
+    return s;
+}
+
+void RealTimePacer::printSummary(std::ostream& out) const {
+    static const char* const kPolicies[] = { "catch-up", "skip", "slow-down" };
+    PacingStats s = stats();
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1)
+        << "\n=== Real-time pacing (" << 1.0 / (mPeriodNs * 1e-9) << " Hz, x"
+        << std::setprecision(2) << mParams.realTimeFactor << ", "
+        << kPolicies[static_cast<int>(mParams.policy)] << ") ===\n"
+        << "Steps:              " << s.steps << " in " << std::setprecision(3) << s.wallSeconds
+        << " s wall (effective x" << s.effectiveFactor() << ")\n"
+        << "Overruns:           " << s.overruns << " (" << std::setprecision(3) << 100.0 * s.overrunRatio()
+        << "%), max " << s.maxOverrun * 1e6 << " us, skipped ticks " << s.skippedTicks
+        << ", catch-up steps " << s.catchUpSteps << "\n"
+        << "Step busy time:     mean " << s.meanBusy * 1e6 << " us, max " << s.maxBusy * 1e6
+        << " us (budget " << mPeriodNs * 1e-3 << " us)\n"
+        << "Wake-up jitter:     mean " << s.meanJitter * 1e6 << " us, p99 " << s.p99Jitter * 1e6
+        << " us, max " << s.maxJitter * 1e6 << " us\n";
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,154 @@
+#ifndef REAL_TIME_PACER_H
+#define REAL_TIME_PACER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "Metrics.h"
+
+/*
+ * @brief:
+ *         What the pacer does when a step finishes after its deadline.
+ *
+ * - CatchUp  : run the missed steps back to back until the schedule is met
+ *              again (at most maxCatchUpSteps behind; older ones are
+ *              skipped). Simulation time stays locked to wall time.
+ * - Skip     : drop the missed ticks and resume at the next tick of the
+ *              original schedule. The cadence and phase are kept; the
+ *              simulation falls behind wall time by dt per skipped tick.
+ * - SlowDown : move the whole schedule back by the overrun. No burst and
+ *              no lost ticks; the effective real-time factor drops.
+ */
+
+enum class OverrunPolicy { CatchUp, Skip, SlowDown };
+
+/*
+ * @class:
+ *         PacingParams
+ * @brief:
+ *         Real-time factor and overrun handling of a RealTimePacer.
+ */
+
+struct PacingParams {
+    double realTimeFactor = 1.0;    // simulated seconds per wall second
+    OverrunPolicy policy = OverrunPolicy::CatchUp;
+    std::size_t maxCatchUpSteps = 10;
+    double spinMicros = 0.0;        // busy-wait this last part of each wait (wake-up precision)
+};
+
+/*
+ * @class:
+ *         PacingStats
+ * @brief:
+ *         Schedule adherence of a paced run.
+ */
+
+struct PacingStats {
+    std::uint64_t steps = 0;
+    std::uint64_t overruns = 0;         // steps that finished after their deadline
+    std::uint64_t skippedTicks = 0;     // Skip, or CatchUp beyond maxCatchUpSteps
+    std::uint64_t catchUpSteps = 0;     // steps started late without sleeping
+    double maxOverrun = 0.0;            // s past the deadline
+    double meanBusy = 0.0;              // s of work per step (between waits)
+    double maxBusy = 0.0;
+    double meanJitter = 0.0;            // s a wake-up came after its target time
+    double p99Jitter = 0.0;             // 1 us resolution
+    double maxJitter = 0.0;
+    double wallSeconds = 0.0;
+    double simSeconds = 0.0;
+
+    double effectiveFactor() const { return wallSeconds > 0.0 ? simSeconds / wallSeconds : 0.0; }
+
+    double overrunRatio() const { return steps ? static_cast<double>(overruns) / static_cast<double>(steps) : 0.0; }
+};
+
+/*
+ * @class:
+ *         RealTimePacer
+ * @brief:
+ *         Paces a fixed-step loop to wall-clock time.
+ *
+ * Step k is due to start at anchor + k * dt / realTimeFactor. After each
+ * step the loop calls wait(), which sleeps until the next step's start
+ * time with an absolute-deadline sleep (clock_nanosleep(CLOCK_MONOTONIC,
+ * TIMER_ABSTIME) on Linux, so sleeping never adds drift), or applies the
+ * overrun policy if that time has already passed.
+ *
+ * Typical loop:
+ *   RealTimePacer pacer(dt, params);
+ *   pacer.start();
+ *   while (t < duration) { control(); sim.step(dt); t += dt; pacer.wait(); }
+ *
+ * Overruns, per-step busy time and wake-up jitter are also exported as
+ * pacing.* metrics.
+ */
+
+class RealTimePacer {
+public:
+
+    /*
+     * @param: dt
+     *         Simulation step (s).
+     * @param: params
+     *         Real-time factor and overrun policy.
+     */
+
+    RealTimePacer(double dt, const PacingParams& params);
+
+    /*
+     * @brief:
+     *         Anchors the schedule: the first step starts now.
+     */
+
+    void start();
+
+    /*
+     * @brief:
+     *         Ends the current step and blocks until the next one is due
+     *         (or returns at once when behind, per the overrun policy).
+     */
+
+    void wait();
+
+    /*
+     * @return: Statistics up to the last wait().
+     */
+
+    PacingStats stats() const;
+
+    /*
+     * @brief:
+     *         Prints the statistics in a short human-readable block.
+     */
+
+    void printSummary(std::ostream& out) const;
+
+    const PacingParams& params() const { return mParams; }
+
+private:
+    void observeJitter(std::int64_t lateNs);
+
+    double mDt;
+    PacingParams mParams;
+    std::int64_t mPeriodNs;
+    std::int64_t mSpinNs;
+
+    std::int64_t mAnchorNs = 0;
+    std::int64_t mNextStartNs = 0;   // start time of the step in progress
+    std::int64_t mStepBeginNs = 0;   // when the step in progress actually began
+
+    PacingStats mStats;
+    std::int64_t mBusyTotalNs = 0;
+    std::int64_t mJitterTotalNs = 0;
+    std::uint64_t mWakeups = 0;
+    std::vector<std::uint64_t> mJitterBins;   // 1 us bins, last = overflow
+
+    Counter* mOverrunCounter;
+    Counter* mSkippedCounter;
+    Histogram* mOverrunNs;
+    Histogram* mBusyNs;
+    Histogram* mJitterNs;
+};
+
+#endif // REAL_TIME_PACER_H
@@ -0,0 +1,291 @@
+#include "ReplayEngine.h"
+#include "CsvFormat.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <thread>
+
+namespace {
+
+    // frames read per contiguous read of the telemetry CSV
+    constexpr std::uint64_t kWindowFrames = 256;
+
+    // below this many bytes the comms seek scans rows instead of bisecting
+    constexpr std::uint64_t kLinearScanBytes = 4096;
+
+    // A frame's time as the comms log would print it. Index times are exact
+    // while comms rows carry 6 significant digits, so rows are matched to
+    // frames at that precision (10.009999... must take the rows at 10.01).
+    double loggedTime(double t) {
+        char text[CsvFormat::kMaxRealChars + 1];
+        *CsvFormat::putReal(text, t) = '\0';
+        return std::strtod(text, nullptr);
+    }
+}
+
+ReplayEngine::ReplayEngine(const std::string& telemetryPath, const std::string& commsPath)
+    : mTelemetry(telemetryPath)
+{
+    if (!mTelemetry.isOpen()) {
+        mError = mTelemetry.error();
+        return;
+    }
+    mFirstStep = mTelemetry.firstStep();
+    mNextStep = mFirstStep;
+
+    if (!commsPath.empty()) {
+        mComms.open(commsPath, std::ios::binary);
+        std::string header;
+        if (!mComms || !std::getline(mComms, header)) {
+            mError = "could not open " + commsPath;
+            return;
+        }
+        mCommsDataStart = static_cast<std::uint64_t>(mComms.tellg());
+        mComms.seekg(0, std::ios::end);
+        mCommsSize = static_cast<std::uint64_t>(mComms.tellg());
+        mComms.seekg(static_cast<std::streamoff>(mCommsDataStart));
+    }
+    mOpen = true;
+}
+
+void ReplayEngine::addTelemetrySink(TelemetrySink& sink) {
+    mSinks.push_back(&sink);
+}
+
+void ReplayEngine::removeTelemetrySink(TelemetrySink& sink) {
+    mSinks.erase(std::remove(mSinks.begin(), mSinks.end(), &sink), mSinks.end());
+}
+
+void ReplayEngine::addCommsObserver(CommsObserver& observer) {
+    mObservers.push_back(&observer);
+}
+
+void ReplayEngine::removeCommsObserver(CommsObserver& observer) {
+    mObservers.erase(std::remove(mObservers.begin(), mObservers.end(), &observer), mObservers.end());
+}
+
+/*
+ * @brief:
+ *         Changes the pace; the next frame becomes the new pacing anchor so
+ *         the change takes effect without a jump.
+ */
+
+void ReplayEngine::setSpeed(double multiplier) {
+    mSpeed = multiplier > 0.0 ? multiplier : 0.0;
+    mPaceAnchored = false;
+}
+
+/*
+ * @brief:
+ *         Moves both logs to 'step'. Comms rows logged at or before the
+ *         previous frame's time are skipped, so replaying from a seek
+ *         publishes the same events as replaying from the start.
+ */
+
+bool ReplayEngine::seekStep(std::uint64_t step) {
+    if (!mOpen) return false;
+    TelemetryLogIndex::Entry target;
+    if (!mTelemetry.entry(step, target)) return false;
+
+    mNextStep = step;
+    mPaceAnchored = false;
+
+    if (mComms.is_open()) {
+        TelemetryLogIndex::Entry previous;
+        if (step > mFirstStep && mTelemetry.entry(step - 1, previous)) seekComms(loggedTime(previous.time));
+        else seekComms(-std::numeric_limits<double>::infinity());
+    }
+    return true;
+}
+
+bool ReplayEngine::seekTime(double t) {
+    if (!mOpen || mTelemetry.stepCount() == 0) return false;
+    return seekStep(mTelemetry.stepAtTime(t));
+}
+
+/*
+ * @brief:
+ *         Returns the next frame, reading the following window of frames
+ *         when it is not loaded.
+ *
+ * @return:
+ *         nullptr at the end of the log.
+ */
+
+const LoggedFrame* ReplayEngine::peek() {
+    if (!mOpen) return nullptr;
+    if (mNextStep < mWindowFirst || mNextStep - mWindowFirst >= mWindow.size()) {
+        std::uint64_t count = mTelemetry.stepCount();
+        if (mNextStep < mFirstStep || mNextStep - mFirstStep >= count) return nullptr;
+
+        PROFILE_SCOPE("replay.read");
+        std::uint64_t last = std::min(mNextStep + kWindowFrames, mFirstStep + count) - 1;
+        if (!mTelemetry.readRange(mNextStep, last, mWindow)) {
+            mError = mTelemetry.error();
+            mWindow.clear();
+            return nullptr;
+        }
+        mWindowFirst = mNextStep;
+    }
+    return &mWindow[mNextStep - mWindowFirst];
+}
+
+/*
+ * @brief:
+ *         Waits for the frame's deadline (when paced), publishes the comms
+ *         events up to its time and then the frame itself.
+ */
+
+bool ReplayEngine::step() {
+    const LoggedFrame* frame = peek();
+    if (!frame) return false;
+
+    if (mSpeed > 0.0) {
+        auto now = std::chrono::steady_clock::now();
+        if (!mPaceAnchored) {
+            mPaceAnchored = true;
+            mPaceSimTime = frame->time;
+            mPaceWallTime = now;
+        }
+        else {
+            auto deadline = mPaceWallTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>((frame->time - mPaceSimTime) / mSpeed));
+            if (deadline > now) std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    publishCommsUpTo(loggedTime(frame->time));
+
+    TelemetryFrame view = frame->view();
+    for (TelemetrySink* sink : mSinks) sink->publish(view);
+
+    ++mNextStep;
+    return true;
+}
+
+std::uint64_t ReplayEngine::run(double until) {
+    std::uint64_t frames = 0;
+    for (const LoggedFrame* frame = peek(); frame && frame->time <= until; frame = peek()) {
+        step();
+        ++frames;
+    }
+    return frames;
+}
+
+/*
+ * @brief:
+ *         Reads one comms row and its time.
+ *
+ * @return:
+ *         false at the end of the file.
+ */
+
+bool ReplayEngine::readCommsRow(std::string& line, double& time) {
+    if (!std::getline(mComms, line) || line.empty()) return false;
+    if (line.back() == '\r') line.pop_back();
+    std::size_t comma = line.find(',');
+    if (comma == std::string::npos) return false;
+    time = std::strtod(line.c_str() + comma + 1, nullptr);
+    return true;
+}
+
+/*
+ * @brief:
+ *         Splits a row into its seven plain fields and the quoted payload
+ *         (which may itself contain commas). Doubled quotes in the payload
+ *         are collapsed in place, so 'line' is modified; the event's views
+ *         point into it.
+ */
+
+bool ReplayEngine::parseCommsRow(std::string& line, CommsEvent& event) const {
+    std::string_view fields[7];
+    std::size_t begin = 0;
+    for (int f = 0; f < 7; ++f) {
+        std::size_t comma = line.find(',', begin);
+        if (comma == std::string::npos) return false;
+        fields[f] = std::string_view(line).substr(begin, comma - begin);
+        begin = comma + 1;
+    }
+    std::size_t close = line.rfind('"');
+    if (begin >= line.size() || line[begin] != '"' || close <= begin) return false;
+
+    event.event = fields[0];
+    event.time = std::strtod(line.c_str() + (fields[1].data() - line.data()), nullptr);
+    event.id = std::strtoll(line.c_str() + (fields[2].data() - line.data()), nullptr, 10);
+    event.from = fields[3];
+    event.to = fields[4];
+    event.latency = std::strtod(line.c_str() + (fields[5].data() - line.data()), nullptr);
+    event.dropped = std::strtoull(line.c_str() + (fields[6].data() - line.data()), nullptr, 10);
+    // "" -> " inside the payload; the payload is the tail of the row, so
+    // the views to the other fields stay valid
+    std::size_t end = begin + 1;
+    for (std::size_t i = begin + 1; i < close; ++i) {
+        line[end++] = line[i];
+        if (line[i] == '"' && i + 1 < close && line[i + 1] == '"') ++i;
+    }
+    event.payload = std::string_view(line).substr(begin + 1, end - begin - 1);
+    return true;
+}
+
+/*
+ * @brief:
+ *         Positions the comms log at its first row later than 'afterTime'.
+ *
+ * Rows are logged in time order, so this bisects over byte offsets,
+ * resynchronising on the next line start after each probe, and finishes
+ * with a short forward scan.
+ */
+
+void ReplayEngine::seekComms(double afterTime) {
+    mHasPending = false;
+    std::uint64_t lo = mCommsDataStart;   // a row start with time <= afterTime (or the first row)
+    std::uint64_t hi = mCommsSize;
+    std::string line;
+    double time = 0.0;
+
+    while (hi - lo > kLinearScanBytes) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        mComms.clear();
+        mComms.seekg(static_cast<std::streamoff>(mid - 1));
+        mComms.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::uint64_t rowStart = static_cast<std::uint64_t>(mComms.tellg());
+        if (!mComms || rowStart >= hi || !readCommsRow(line, time) || time > afterTime) hi = mid;
+        else lo = rowStart;
+    }
+
+    mComms.clear();
+    mComms.seekg(static_cast<std::streamoff>(lo));
+    while (readCommsRow(line, time)) {
+        if (time > afterTime) {
+            mPendingLine.swap(line);
+            mPendingTime = time;
+            mHasPending = true;
+            return;
+        }
+    }
+}
+
+/*
+ * @brief:
+ *         Publishes the rows logged at or before 'time'; the first later
+ *         row is kept for the next frame.
+ */
+
+void ReplayEngine::publishCommsUpTo(double time) {
+    if (!mComms.is_open()) return;
+    for (;;) {
+        if (!mHasPending) {
+            if (!readCommsRow(mPendingLine, mPendingTime)) return;
+            mHasPending = true;
+        }
+        if (mPendingTime > time) return;
+
+        CommsEvent event;
+        if (parseCommsRow(mPendingLine, event)) {
+            for (CommsObserver* observer : mObservers) observer->onCommsEvent(event);
+            ++mCommsPublished;
+        }
+        mHasPending = false;
+    }
+}
@@ -0,0 +1,157 @@
+#ifndef REPLAY_ENGINE_H
+#define REPLAY_ENGINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "CommsObserver.h"
+#include "TelemetryLogReader.h"
+#include "TelemetrySink.h"
+
+/*
+ * @class:
+ *         ReplayEngine
+ * @brief:
+ *         Re-drives a recorded run (simulation_log.csv + its index, and
+ *         optionally comms_log.csv) through the same TelemetrySink and
+ *         CommsObserver interfaces a live Simulator publishes to.
+ *
+ * Every step publishes the comms events logged up to that frame's time,
+ * then the frame. With speed 1 the frames go out at the pace they were
+ * simulated; higher speeds are proportionally faster, and speed 0 (the
+ * default) runs unthrottled. Pacing sleeps until absolute deadlines
+ * measured from the last seek or speed change, so short sleeps do not add
+ * up to drift.
+ *
+ * Seeking is O(1) on the telemetry side (step index) and a binary search
+ * over byte offsets on the comms side (its rows are in time order), so
+ * nothing is scanned or loaded up front. Decimated logs are replayed as
+ * recorded, with the rows they contain. The comms log must be plain CSV
+ * (unpack a ".lz" log with Tools/LogUnpack first).
+ */
+
+class ReplayEngine {
+public:
+
+    /*
+     * @param: telemetryPath
+     *         CSV written by CsvTelemetrySink (needs "<path>.idx").
+     * @param: commsPath
+     *         comms log to replay alongside, or "" for none.
+     */
+
+    ReplayEngine(const std::string& telemetryPath, const std::string& commsPath);
+
+    bool isOpen() const { return mOpen; }
+
+    const std::string& error() const { return mError; }
+
+    void addTelemetrySink(TelemetrySink& sink);
+
+    void removeTelemetrySink(TelemetrySink& sink);
+
+    void addCommsObserver(CommsObserver& observer);
+
+    void removeCommsObserver(CommsObserver& observer);
+
+    /*
+     * @brief:
+     *         Simulated seconds per wall-clock second; 0 = unthrottled.
+     */
+
+    void setSpeed(double multiplier);
+
+    double speed() const { return mSpeed; }
+
+    std::uint64_t firstStep() const { return mFirstStep; }
+
+    std::uint64_t lastStep() { return mFirstStep + mTelemetry.stepCount() - 1; }
+
+    /*
+     * @brief:
+     *         Step the next call to step() publishes.
+     */
+
+    std::uint64_t currentStep() const { return mNextStep; }
+
+    /*
+     * @brief:
+     *         Positions the replay so the next step() publishes 'step'.
+     *
+     * @return:
+     *         false if the step is not in the log.
+     */
+
+    bool seekStep(std::uint64_t step);
+
+    /*
+     * @brief:
+     *         Seeks to the step closest to simulation time 't'.
+     */
+
+    bool seekTime(double t);
+
+    /*
+     * @brief:
+     *         Publishes the comms events up to the next frame, then the
+     *         frame, waiting first if paced.
+     *
+     * @return:
+     *         false at the end of the log (or on a read error).
+     */
+
+    bool step();
+
+    /*
+     * @brief:
+     *         Calls step() until the end of the log or until the replay
+     *         passes simulation time 'until'.
+     *
+     * @return:
+     *         Number of frames published.
+     */
+
+    std::uint64_t run(double until = 1e300);
+
+    std::uint64_t commsEventsPublished() const { return mCommsPublished; }
+
+private:
+    const LoggedFrame* peek();
+
+    // comms log helpers
+    bool readCommsRow(std::string& line, double& time);
+    bool parseCommsRow(std::string& line, CommsEvent& event) const;
+    void seekComms(double afterTime);
+    void publishCommsUpTo(double time);
+
+    bool mOpen = false;
+    std::string mError;
+    TelemetryLogReader mTelemetry;
+    std::uint64_t mFirstStep = 0;
+    std::uint64_t mNextStep = 0;
+
+    // frames read ahead with one contiguous read
+    std::vector<LoggedFrame> mWindow;
+    std::uint64_t mWindowFirst = 0;
+
+    std::ifstream mComms;
+    std::uint64_t mCommsSize = 0;
+    std::uint64_t mCommsDataStart = 0;   // first byte after the header row
+    std::string mPendingLine;            // row read ahead but not yet due
+    double mPendingTime = 0.0;
+    bool mHasPending = false;
+    std::uint64_t mCommsPublished = 0;
+
+    std::vector<TelemetrySink*> mSinks;
+    std::vector<CommsObserver*> mObservers;
+
+    // pacing
+    double mSpeed = 0.0;
+    bool mPaceAnchored = false;
+    double mPaceSimTime = 0.0;
+    std::chrono::steady_clock::time_point mPaceWallTime;
+};
+
+#endif // REPLAY_ENGINE_H
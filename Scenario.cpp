@@ -0,0 +1,152 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <cmath>
+#include "FormationController.h"
+#include "Simulator.h"
+
+namespace {
+
+    // SplitMix64 finaliser
+    std::uint64_t mix(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // collects the latency of every delivery
+    class LatencyRecorder : public CommsObserver {
+    public:
+        explicit LatencyRecorder(std::vector<double>& latencies) : mLatencies(latencies) {}
+
+        void onCommsEvent(const CommsEvent& event) override {
+            if (event.event == "deliver") mLatencies.push_back(event.latency);
+        }
+
+    private:
+        std::vector<double>& mLatencies;
+    };
+}
+
+ScenarioParams demoScenario() {
+    ScenarioParams scenario;
+    scenario.world = World(Vector2(0.0, -9.8), 100.0, 100.0);
+
+    // Starting position: Corners of the World.
+    scenario.startPositions = {
+        Vector2(10.0, 10.0),
+        Vector2(90.0, 10.0),
+        Vector2(10.0, 90.0),
+        Vector2(90.0, 90.0)
+    };
+
+    // Formation center + per-drone offset
+    Vector2 formationCenter(60.0, 60.0);
+    scenario.targets = {
+        formationCenter + Vector2(-5.0,  0.0),  // Drone 0 target = (55, 60)
+        formationCenter + Vector2(5.0,  0.0),   // Drone 1 target = (65, 60)
+        formationCenter + Vector2(0.0,  5.0),   // Drone 2 target = (60, 65)
+        formationCenter + Vector2(0.0, -5.0)    // Drone 3 target = (60, 55)
+    };
+    return scenario;
+}
+
+ScenarioParams swarmScenario(std::size_t drones) {
+    ScenarioParams scenario = demoScenario();
+    scenario.startPositions.clear();
+    scenario.targets.clear();
+    scenario.startPositions.reserve(drones);
+    scenario.targets.reserve(drones);
+
+    const double pi = std::acos(-1.0);
+    const std::size_t side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(drones))));
+    for (std::size_t i = 0; i < drones; ++i) {
+        scenario.startPositions.push_back(Vector2(
+            10.0 + 80.0 * static_cast<double>(i % side) / static_cast<double>(side),
+            10.0 + 80.0 * static_cast<double>(i / side) / static_cast<double>(side)));
+        double angle = 2.0 * pi * static_cast<double>(i) / static_cast<double>(drones);
+        scenario.targets.push_back(Vector2(50.0 + 30.0 * std::cos(angle), 50.0 + 30.0 * std::sin(angle)));
+    }
+    return scenario;
+}
+
+/*
+ * @brief:
+ *         Same control loop as main(): batched PD control, then one
+ *         simulator step, until the duration is reached.
+ */
+
+ScenarioResult runScenario(const ScenarioParams& scenario, std::vector<double>& latencies) {
+    ScenarioResult result;
+    latencies.clear();
+
+    Simulator sim(scenario.world, scenario.network);
+    LatencyRecorder recorder(latencies);
+    sim.addCommsObserver(recorder);
+
+    const std::size_t count = std::min(scenario.startPositions.size(), scenario.targets.size());
+    FormationController controller(scenario.stopRadius);
+    std::vector<int> droneIds(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        droneIds[i] = sim.droneIndex(sim.addDrone(scenario.drone, scenario.startPositions[i]));
+        controller.addDrone(droneIds[i], scenario.targets[i], scenario.kP, scenario.kD, scenario.drone.mass);
+    }
+
+    std::vector<bool> arrived(count, false);
+    double time = 0.0;
+    while (time < scenario.duration) {
+        controller.compute(sim.getDrones(), scenario.world.gravity);
+        sim.setDroneThrustForces(controller.droneIds(), controller.thrustX(),
+            controller.thrustY(), controller.size());
+        sim.step(scenario.dt);
+        time += scenario.dt;
+        ++result.steps;
+
+        const auto& drones = sim.getDrones();
+        bool allInside = true;
+        for (std::size_t i = 0; i < count; ++i) {
+            const Vector2& p = drones[droneIds[i]].getPosition();
+            double dx = scenario.targets[i].x - p.x;
+            double dy = scenario.targets[i].y - p.y;
+            double dist = std::sqrt(dx * dx + dy * dy);
+            if (dist < scenario.stopRadius) arrived[i] = true;
+            if (arrived[i]) result.maxOvershoot = std::max(result.maxOvershoot, dist);
+            allInside = allInside && dist < scenario.stopRadius + scenario.settleTolerance;
+        }
+        if (!allInside) result.convergenceTime = -1.0;
+        else if (result.convergenceTime < 0.0) result.convergenceTime = time;
+    }
+
+    result.delivered = static_cast<std::uint64_t>(sim.deliveredMessageCount());
+    result.dropped = sim.droppedMessageCount();
+
+    std::sort(latencies.begin(), latencies.end());
+    result.latencyP50 = sortedPercentile(latencies, 0.50);
+    result.latencyP90 = sortedPercentile(latencies, 0.90);
+    result.latencyP99 = sortedPercentile(latencies, 0.99);
+    return result;
+}
+
+bool setScenarioParameter(ScenarioParams& scenario, const std::string& name, double value) {
+    if (name == "kP") scenario.kP = value;
+    else if (name == "kD") scenario.kD = value;
+    else if (name == "stopRadius") scenario.stopRadius = value;
+    else if (name == "settleTolerance") scenario.settleTolerance = value;
+    else if (name == "dt") scenario.dt = value;
+    else if (name == "duration") scenario.duration = value;
+    else if (name == "latency") scenario.network.baseLatency = value;
+    else if (name == "jitter") scenario.network.jitter = value;
+    else if (name == "drop") scenario.network.dropProbability = value;
+    else return false;
+    return true;
+}
+
+std::uint64_t runSeed(std::uint64_t seed, std::uint64_t index) {
+    return mix(seed ^ mix(index)) | 1;
+}
+
+double sortedPercentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[rank ? std::min(rank, sorted.size()) - 1 : 0];
+}
@@ -0,0 +1,137 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Drone.h"
+#include "Network.h"
+#include "Vector2.h"
+#include "World.h"
+
+/*
+ * @class:
+ *         ScenarioParams
+ * @brief:
+ *         Everything that defines one formation-flight run: world, drones,
+ *         targets, PD gains, timing and the network model.
+ *
+ * demoScenario() returns the four-corner formation main() runs by default,
+ * swarmScenario() one of any size (main --drones).
+ */
+
+struct ScenarioParams {
+    World world;
+    DroneParams drone{ 1.0, 40.0, 25.0 };   // mass (kg), max thrust (N), max speed (m/s)
+
+    std::vector<Vector2> startPositions;
+    std::vector<Vector2> targets;           // one per start position
+
+    double kP = 0.4;            // proportional gain
+    double kD = 1.2;            // derivative gain
+    double stopRadius = 1.5;    // distance considered "close enough" to the target
+    double settleTolerance = 0.5;   // converged = within stopRadius + this
+    double dt = 0.01;           // s
+    double duration = 10.0;     // s
+
+    NetworkParams network;
+};
+
+/*
+ * @class:
+ *         ScenarioResult
+ * @brief:
+ *         Outcome of one headless run (runScenario()).
+ */
+
+struct ScenarioResult {
+    // first time after which every drone stayed within stopRadius +
+    // settleTolerance of its target until the end of the run; negative if
+    // it never settled. (The controller cuts thrust inside stopRadius, so
+    // hovering drones sag back to its edge rather than resting inside.)
+    double convergenceTime = -1.0;
+    bool converged() const { return convergenceTime >= 0.0; }
+
+    // largest distance any drone got from its target after first coming
+    // within stopRadius of it (0 if none arrived)
+    double maxOvershoot = 0.0;
+
+    std::uint64_t delivered = 0;
+    std::uint64_t dropped = 0;
+    double deliveryRatio() const {
+        return delivered + dropped ? static_cast<double>(delivered) / static_cast<double>(delivered + dropped) : 0.0;
+    }
+
+    // delivery latency percentiles (s), 0 without deliveries
+    double latencyP50 = 0.0;
+    double latencyP90 = 0.0;
+    double latencyP99 = 0.0;
+
+    std::uint64_t steps = 0;
+};
+
+/*
+ * @brief:
+ *         The demo formation: four drones from the corners of a 100 m world
+ *         to a diamond around (60, 60).
+ */
+
+ScenarioParams demoScenario();
+
+/*
+ * @brief:
+ *         A scalable formation: 'drones' drones start on a square grid over
+ *         the demo world and fly to evenly spaced points of a ring of radius
+ *         30 m around its centre.
+ */
+
+ScenarioParams swarmScenario(std::size_t drones);
+
+/*
+ * @brief:
+ *         Runs a scenario to its duration without any sinks and measures
+ *         convergence and network delivery.
+ *
+ * Uses scenario.network as given, so set logPath = "" and
+ * printEvents = false for batch runs.
+ *
+ * @param: scenario
+ *         Run definition.
+ * @param: latencies
+ *         Receives every delivery latency of the run (cleared first);
+ *         reusing the vector across runs avoids reallocating it.
+ * @return:
+ *         Run outcome.
+ */
+
+ScenarioResult runScenario(const ScenarioParams& scenario, std::vector<double>& latencies);
+
+/*
+ * @brief:
+ *         Sets a scenario parameter by name, e.g. for sweeps and command
+ *         lines: kP, kD, stopRadius, settleTolerance, dt, duration,
+ *         latency, jitter, drop.
+ *
+ * @return:
+ *         false for an unknown name.
+ */
+
+bool setScenarioParameter(ScenarioParams& scenario, const std::string& name, double value);
+
+/*
+ * @brief:
+ *         Seed of run 'index' of a batch seeded with 'seed' (never 0), so
+ *         batch runs are reproducible independently of scheduling.
+ */
+
+std::uint64_t runSeed(std::uint64_t seed, std::uint64_t index);
+
+/*
+ * @brief:
+ *         Nearest-rank percentile of sorted values (0 for an empty range).
+ */
+
+double sortedPercentile(const std::vector<double>& sorted, double p);
+
+#endif // SCENARIO_H
@@ -0,0 +1,87 @@
+#include "Scenario3D.h"
+#include <algorithm>
+#include <cmath>
+#include "FormationController.h"
+
+Scenario3DParams layeredScenario(std::size_t layers, std::size_t dronesPerLayer,
+    double layerSpacing, double baseAltitude, double ringRadius) {
+    Scenario3DParams scenario;
+    const double cx = scenario.world.width * 0.5;
+    const double cy = scenario.world.depth * 0.5;
+    const std::size_t count = layers * dronesPerLayer;
+    const double pi = std::acos(-1.0);
+
+    // Launch pad: a square grid on the ground, 4 m apart, around the centre
+    const std::size_t side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const double padSpacing = 4.0;
+    const double padOrigin = -0.5 * padSpacing * static_cast<double>(side > 0 ? side - 1 : 0);
+
+    for (std::size_t k = 0; k < layers; ++k) {
+        double altitude = baseAltitude + layerSpacing * static_cast<double>(k);
+        for (std::size_t j = 0; j < dronesPerLayer; ++j) {
+            std::size_t i = k * dronesPerLayer + j;
+            scenario.startPositions.push_back(Vector3(
+                cx + padOrigin + padSpacing * static_cast<double>(i % side),
+                cy + padOrigin + padSpacing * static_cast<double>(i / side),
+                0.0));
+
+            // rings are staggered by half a slot so layers don't stack vertically
+            double angle = 2.0 * pi * (static_cast<double>(j) + 0.5 * static_cast<double>(k % 2))
+                / static_cast<double>(dronesPerLayer);
+            scenario.targets.push_back(Vector3(
+                cx + ringRadius * std::cos(angle),
+                cy + ringRadius * std::sin(angle),
+                altitude));
+        }
+    }
+    return scenario;
+}
+
+/*
+ * @brief:
+ *         PD control and physics per step, then the same convergence and
+ *         overshoot bookkeeping as runScenario().
+ */
+
+ScenarioResult runScenario3D(const Scenario3DParams& scenario,
+    const std::function<void(double time, const std::vector<Drone3>& drones)>& onStep) {
+    ScenarioResult result;
+
+    const std::size_t count = std::min(scenario.startPositions.size(), scenario.targets.size());
+    std::vector<Drone3> drones;
+    drones.reserve(count);
+    FormationController3 controller(scenario.stopRadius);
+    for (std::size_t i = 0; i < count; ++i) {
+        drones.emplace_back(static_cast<int>(i), scenario.drone, scenario.startPositions[i]);
+        controller.addDrone(static_cast<int>(i), scenario.targets[i], scenario.kP, scenario.kD, scenario.drone.mass);
+    }
+
+    std::vector<bool> arrived(count, false);
+    double time = 0.0;
+    while (time < scenario.duration) {
+        controller.compute(drones, scenario.world.gravity);
+        const double* fx = controller.thrust(0);
+        const double* fy = controller.thrust(1);
+        const double* fz = controller.thrust(2);
+        for (std::size_t i = 0; i < count; ++i) {
+            Drone3& d = drones[i];
+            d.setThrustForce(Vector3(fx[i], fy[i], fz[i]));
+            d.update(scenario.dt, scenario.world);
+        }
+        time += scenario.dt;
+        ++result.steps;
+
+        bool allInside = true;
+        for (std::size_t i = 0; i < count; ++i) {
+            double dist = (scenario.targets[i] - drones[i].getPosition()).length();
+            if (dist < scenario.stopRadius) arrived[i] = true;
+            if (arrived[i]) result.maxOvershoot = std::max(result.maxOvershoot, dist);
+            allInside = allInside && dist < scenario.stopRadius + scenario.settleTolerance;
+        }
+        if (!allInside) result.convergenceTime = -1.0;
+        else if (result.convergenceTime < 0.0) result.convergenceTime = time;
+
+        if (onStep) onStep(time, drones);
+    }
+    return result;
+}
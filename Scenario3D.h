@@ -0,0 +1,70 @@
+#ifndef SCENARIO_3D_H
+#define SCENARIO_3D_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "Drone.h"
+#include "Scenario.h"
+#include "Vector3.h"
+#include "World.h"
+
+/*
+ * @class:
+ *         Scenario3DParams
+ * @brief:
+ *         A formation-flight run in the 3D mode: same fields as
+ *         ScenarioParams, with 3D positions and no network.
+ *
+ * layeredScenario() builds the altitude-layered formation.
+ */
+
+struct Scenario3DParams {
+    World3 world;
+    DroneParams drone{ 1.0, 40.0, 25.0 };   // mass (kg), max thrust (N), max speed (m/s)
+
+    std::vector<Vector3> startPositions;
+    std::vector<Vector3> targets;           // one per start position
+
+    double kP = 0.4;
+    double kD = 1.2;
+    double stopRadius = 1.5;
+    double settleTolerance = 0.5;
+    double dt = 0.01;           // s
+    double duration = 30.0;     // s
+};
+
+/*
+ * @brief:
+ *         Altitude-layered formation: drones take off from a ground grid
+ *         around the world centre and form one ring per layer, layer k at
+ *         altitude baseAltitude + k * layerSpacing.
+ *
+ * @param: layers
+ *         Number of altitude layers.
+ * @param: dronesPerLayer
+ *         Drones on each ring.
+ * @param: layerSpacing
+ *         Vertical distance between layers (m).
+ */
+
+Scenario3DParams layeredScenario(std::size_t layers, std::size_t dronesPerLayer,
+    double layerSpacing = 10.0, double baseAltitude = 20.0, double ringRadius = 15.0);
+
+/*
+ * @brief:
+ *         Runs a 3D scenario headless: FormationController3 and Drone3
+ *         physics, the same loop as runScenario() without the Simulator.
+ *
+ * The result uses ScenarioResult's convergence definitions; the network
+ * fields stay 0.
+ *
+ * @param: onStep
+ *         Optional; called after every step with the time and the drones
+ *         (index = drone id), e.g. to record a trajectory.
+ */
+
+ScenarioResult runScenario3D(const Scenario3DParams& scenario,
+    const std::function<void(double time, const std::vector<Drone3>& drones)>& onStep = nullptr);
+
+#endif // SCENARIO_3D_H
@@ -0,0 +1,319 @@
+#include "ShmFrameRing.h"
+#include "Profiler.h"
+#include <cstring>
+#include <new>
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(int) == sizeof(std::int32_t), "ids column is int32");
+
+namespace {
+
+    std::size_t alignUp(std::size_t n) {
+        return (n + ShmRing::kAlign - 1) & ~(ShmRing::kAlign - 1);
+    }
+
+    std::size_t ringHeaderBytes() { return alignUp(sizeof(ShmRingHeader)); }
+
+    std::size_t slotHeaderBytes() { return alignUp(sizeof(ShmSlotHeader)); }
+
+    std::size_t idColumnBytes(std::size_t capacity) { return alignUp(capacity * sizeof(std::int32_t)); }
+
+    std::size_t realColumnBytes(std::size_t capacity) { return alignUp(capacity * sizeof(double)); }
+
+    std::size_t slotBytesFor(std::size_t capacity) {
+        return slotHeaderBytes() + idColumnBytes(capacity) + 4 * realColumnBytes(capacity);
+    }
+
+    // byte offset of column c (0 = ids, 1..4 = x, y, vx, vy) inside a slot
+    std::size_t columnOffset(std::size_t capacity, int c) {
+        if (c == 0) return slotHeaderBytes();
+        return slotHeaderBytes() + idColumnBytes(capacity)
+            + static_cast<std::size_t>(c - 1) * realColumnBytes(capacity);
+    }
+}
+
+/*
+ * @brief:
+ *         Returns a view over this frame's columns.
+ */
+
+TelemetryFrame ShmFrame::view() const {
+    TelemetryFrame frame;
+    frame.step = step;
+    frame.time = time;
+    frame.count = ids.size();
+    frame.ids = ids.data();
+    frame.x = x.data();
+    frame.y = y.data();
+    frame.vx = vx.data();
+    frame.vy = vy.data();
+    return frame;
+}
+
+/*
+ * @brief:
+ *         Creates the shared-memory object, sizes it for slotCount frames of
+ *         'capacity' drones and initializes the header and slot seqlocks.
+ *
+ * An existing object with the same name is truncated and re-initialized,
+ * so a restarted simulator reuses the name cleanly.
+ */
+
+ShmFrameRingWriter::ShmFrameRingWriter(const std::string& name, std::size_t capacity, std::size_t slotCount)
+    : mName(name),
+    mPublished(&MetricsRegistry::global().counter("shm.frames_published")),
+    mTruncated(&MetricsRegistry::global().counter("shm.truncated_frames"))
+{
+#if defined(_WIN32)
+    (void)capacity; (void)slotCount;
+    mError = "shared-memory ring requires a POSIX platform";
+#else
+    if (capacity == 0 || slotCount == 0) {
+        mError = "capacity and slot count must be positive";
+        return;
+    }
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        mError = "shm_open(" + name + "): " + std::strerror(errno);
+        return;
+    }
+
+    std::size_t slotBytes = slotBytesFor(capacity);
+    std::size_t total = ringHeaderBytes() + slotCount * slotBytes;
+
+    // truncate first so a re-used object starts zeroed
+    if (ftruncate(fd, 0) != 0 || ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        mError = "ftruncate(" + name + "): " + std::strerror(errno);
+        ::close(fd);
+        return;
+    }
+
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        mError = "mmap(" + name + "): " + std::strerror(errno);
+        return;
+    }
+
+    mBase = static_cast<unsigned char*>(base);
+    mMappedBytes = total;
+
+    // fault every page in now rather than on the first lap of publish().
+    // A write is needed: MAP_POPULATE alone leaves a write fault per page.
+    const std::size_t pageBytes = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    for (std::size_t offset = 0; offset < total; offset += pageBytes) mBase[offset] = 0;
+
+    mHeader = new (mBase) ShmRingHeader{};
+    mHeader->version = ShmRing::kVersion;
+    mHeader->slotCount = static_cast<std::uint32_t>(slotCount);
+    mHeader->capacity = static_cast<std::uint32_t>(capacity);
+    mHeader->slotBytes = slotBytes;
+    mHeader->latestStep.store(0, std::memory_order_relaxed);
+    for (std::size_t s = 0; s < slotCount; ++s) {
+        new (mBase + ringHeaderBytes() + s * slotBytes) ShmSlotHeader{};
+    }
+
+    // readers check the magic before trusting anything else
+    mHeader->magic.store(ShmRing::kMagic, std::memory_order_release);
+#endif
+}
+
+ShmFrameRingWriter::~ShmFrameRingWriter() {
+    close();
+}
+
+/*
+ * @brief:
+ *         Copies the frame into slot (step % slotCount) under the slot's
+ *         seqlock and advances latestStep.
+ *
+ * @param: frame
+ *         Frame of the step that just finished.
+ */
+
+void ShmFrameRingWriter::publish(const TelemetryFrame& frame) {
+    if (!mBase) return;
+    PROFILE_SCOPE("shm.publish");
+
+    const std::size_t capacity = mHeader->capacity;
+    std::size_t n = frame.count;
+    if (n > capacity) {
+        n = capacity;
+        mTruncated->add();
+    }
+
+    unsigned char* slot = mBase + ringHeaderBytes()
+        + static_cast<std::size_t>(frame.step % mHeader->slotCount) * mHeader->slotBytes;
+    ShmSlotHeader* sh = reinterpret_cast<ShmSlotHeader*>(slot);
+
+    std::uint64_t seq = sh->sequence.load(std::memory_order_relaxed);
+    sh->sequence.store(seq + 1, std::memory_order_relaxed);   // odd: writing
+    std::atomic_thread_fence(std::memory_order_release);
+
+    sh->step = frame.step;
+    sh->time = frame.time;
+    sh->count = static_cast<std::uint32_t>(n);
+    std::memcpy(slot + columnOffset(capacity, 0), frame.ids, n * sizeof(std::int32_t));
+    std::memcpy(slot + columnOffset(capacity, 1), frame.x, n * sizeof(double));
+    std::memcpy(slot + columnOffset(capacity, 2), frame.y, n * sizeof(double));
+    std::memcpy(slot + columnOffset(capacity, 3), frame.vx, n * sizeof(double));
+    std::memcpy(slot + columnOffset(capacity, 4), frame.vy, n * sizeof(double));
+
+    sh->sequence.store(seq + 2, std::memory_order_release);   // even: stable
+    mHeader->latestStep.store(frame.step, std::memory_order_release);
+    mPublished->add();
+}
+
+/*
+ * @brief:
+ *         Unmaps the ring and removes its name.
+ */
+
+void ShmFrameRingWriter::close() {
+#if !defined(_WIN32)
+    if (!mBase) return;
+    munmap(mBase, mMappedBytes);
+    shm_unlink(mName.c_str());
+    mBase = nullptr;
+    mHeader = nullptr;
+#endif
+}
+
+/*
+ * @brief:
+ *         Attaches to an existing ring read-only and validates its header.
+ */
+
+ShmFrameRingReader::ShmFrameRingReader(const std::string& name) {
+#if defined(_WIN32)
+    (void)name;
+    mError = "shared-memory ring requires a POSIX platform";
+#else
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        mError = "shm_open(" + name + "): " + std::strerror(errno);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < ringHeaderBytes()) {
+        mError = name + ": not a frame ring (too small)";
+        ::close(fd);
+        return;
+    }
+
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        mError = "mmap(" + name + "): " + std::strerror(errno);
+        return;
+    }
+
+    const ShmRingHeader* header = static_cast<const ShmRingHeader*>(base);
+    bool valid = header->magic.load(std::memory_order_acquire) == ShmRing::kMagic
+        && header->version == ShmRing::kVersion
+        && header->slotCount > 0
+        && header->slotBytes == slotBytesFor(header->capacity)
+        && size >= ringHeaderBytes() + header->slotCount * header->slotBytes;
+    if (!valid) {
+        mError = name + ": not an initialized frame ring";
+        munmap(base, size);
+        return;
+    }
+
+    mBase = static_cast<const unsigned char*>(base);
+    mMappedBytes = size;
+    mHeader = header;
+#endif
+}
+
+ShmFrameRingReader::~ShmFrameRingReader() {
+#if !defined(_WIN32)
+    if (mBase) munmap(const_cast<unsigned char*>(mBase), mMappedBytes);
+#endif
+}
+
+std::uint64_t ShmFrameRingReader::latestStep() const {
+    return mHeader ? mHeader->latestStep.load(std::memory_order_acquire) : 0;
+}
+
+/*
+ * @brief:
+ *         Reads the newest frame, retrying if the writer laps the slot
+ *         while it is being copied.
+ */
+
+bool ShmFrameRingReader::readLatest(ShmFrame& out) {
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        std::uint64_t step = latestStep();
+        if (step == 0) return false;
+        if (readStep(step, out)) return true;
+    }
+    return false;
+}
+
+/*
+ * @brief:
+ *         Seqlock read of one slot.
+ *
+ * The slot is copied out, then the sequence is re-checked; a copy that
+ * overlapped a write is discarded and retried. The contents of 'out' are
+ * unspecified when this returns false.
+ */
+
+bool ShmFrameRingReader::readStep(std::uint64_t step, ShmFrame& out) {
+    if (!mHeader || step == 0) return false;
+
+    const std::size_t capacity = mHeader->capacity;
+    const unsigned char* slot = mBase + ringHeaderBytes()
+        + static_cast<std::size_t>(step % mHeader->slotCount) * mHeader->slotBytes;
+    const ShmSlotHeader* sh = reinterpret_cast<const ShmSlotHeader*>(slot);
+
+    for (int attempt = 0; attempt < 64; ++attempt) {
+        std::uint64_t before = sh->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            ++mRetries;   // writer is inside this slot
+            continue;
+        }
+
+        std::uint64_t slotStep = sh->step;
+        double time = sh->time;
+        std::size_t n = sh->count;
+        if (n > capacity) n = capacity;   // torn count; caught by the re-check
+
+        if (slotStep == step) {
+            out.ids.resize(n);
+            out.x.resize(n);
+            out.y.resize(n);
+            out.vx.resize(n);
+            out.vy.resize(n);
+            std::memcpy(out.ids.data(), slot + columnOffset(capacity, 0), n * sizeof(std::int32_t));
+            std::memcpy(out.x.data(), slot + columnOffset(capacity, 1), n * sizeof(double));
+            std::memcpy(out.y.data(), slot + columnOffset(capacity, 2), n * sizeof(double));
+            std::memcpy(out.vx.data(), slot + columnOffset(capacity, 3), n * sizeof(double));
+            std::memcpy(out.vy.data(), slot + columnOffset(capacity, 4), n * sizeof(double));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        std::uint64_t after = sh->sequence.load(std::memory_order_relaxed);
+        if (before != after) {
+            ++mRetries;
+            continue;
+        }
+
+        if (slotStep != step) return false;   // overwritten or not yet written
+        out.step = slotStep;
+        out.time = time;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,221 @@
+#ifndef SHM_FRAME_RING_H
+#define SHM_FRAME_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Metrics.h"
+#include "TelemetrySink.h"
+
+/*
+ * @brief:
+ *         Shared-memory layout of the frame ring.
+ *
+ * The POSIX shared-memory object holds a ShmRingHeader followed by
+ * slotCount slots. Each slot is a ShmSlotHeader followed by the SoA columns
+ * ids (int32), x, y, vx, vy (float64), each sized for 'capacity' drones and
+ * padded to 64 bytes. Frame for step s lives in slot s % slotCount.
+ *
+ * Every slot is guarded by a seqlock: the writer makes 'sequence' odd,
+ * copies the frame in, then makes it even again. A reader copies the slot
+ * out between two reads of 'sequence' and keeps the copy only if both
+ * reads are equal and even. The writer never waits for readers, and
+ * readers never write to the segment (they map it read-only).
+ */
+
+namespace ShmRing {
+    constexpr std::uint32_t kMagic = 0x47525344;   // "DSRG"
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::size_t kAlign = 64;
+}
+
+struct ShmRingHeader {
+    std::atomic<std::uint32_t> magic;   // written last by the writer
+    std::uint32_t version;
+    std::uint32_t slotCount;
+    std::uint32_t capacity;
+    std::uint64_t slotBytes;
+    std::atomic<std::uint64_t> latestStep;   // newest complete frame, 0 = none
+};
+
+struct ShmSlotHeader {
+    std::atomic<std::uint64_t> sequence;     // odd while being written
+    std::uint64_t step;
+    double time;
+    std::uint32_t count;
+    std::uint32_t reserved;
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+    "shared-memory seqlock needs address-free 64-bit atomics");
+
+/*
+ * @class:
+ *         ShmFrame
+ * @brief:
+ *         Reader-side copy of one frame.
+ */
+
+struct ShmFrame {
+    std::uint64_t step = 0;
+    double time = 0.0;
+    std::vector<int> ids;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> vx;
+    std::vector<double> vy;
+
+    /*
+     * @brief:
+     *         Column view of this copy, e.g. to forward it to a sink.
+     */
+
+    TelemetryFrame view() const;
+};
+
+/*
+ * @class:
+ *         ShmFrameRingWriter
+ * @brief:
+ *         TelemetrySink that publishes every step into the shared-memory
+ *         ring.
+ *
+ * Publishing is five memcpy calls into the slot (one per column) plus two
+ * atomic stores; there is no encoding and no system call per step. The
+ * constructor faults in every page of the ring, so a publish costs about
+ * what copying the frame into a private buffer of the ring's size costs.
+ * That is more than a copy into a cache-resident buffer, because
+ * consecutive steps use different slots.
+ * Frames with more drones than 'capacity' are truncated to the first
+ * 'capacity' drones (counted in shm.truncated_frames).
+ *
+ * POSIX only; on other platforms the writer never opens.
+ */
+
+class ShmFrameRingWriter : public TelemetrySink {
+public:
+
+    /*
+     * @brief:
+     *         Creates (or re-creates) the shared-memory object.
+     *
+     * @param: name
+     *         Shared-memory object name, e.g. "/dronesim".
+     * @param: capacity
+     *         Maximum drones per frame.
+     * @param: slotCount
+     *         Number of frames kept in the ring.
+     */
+
+    ShmFrameRingWriter(const std::string& name, std::size_t capacity, std::size_t slotCount = 64);
+
+    ~ShmFrameRingWriter() override;
+
+    ShmFrameRingWriter(const ShmFrameRingWriter&) = delete;
+    ShmFrameRingWriter& operator=(const ShmFrameRingWriter&) = delete;
+
+    bool isOpen() const { return mBase != nullptr; }
+
+    const std::string& error() const { return mError; }
+
+    void publish(const TelemetryFrame& frame) override;
+
+    /*
+     * @brief:
+     *         Unmaps and unlinks the object. Readers that are already
+     *         attached keep their mapping; new readers cannot attach.
+     */
+
+    void close() override;
+
+private:
+    std::string mName;
+    std::string mError;
+    unsigned char* mBase = nullptr;
+    std::size_t mMappedBytes = 0;
+    ShmRingHeader* mHeader = nullptr;
+
+    Counter* mPublished;
+    Counter* mTruncated;
+};
+
+/*
+ * @class:
+ *         ShmFrameRingReader
+ * @brief:
+ *         Read-only attachment to a ring created by ShmFrameRingWriter,
+ *         usually from another process.
+ */
+
+class ShmFrameRingReader {
+public:
+
+    /*
+     * @brief:
+     *         Opens and maps the shared-memory object read-only.
+     *
+     * @param: name
+     *         Name passed to the writer.
+     */
+
+    explicit ShmFrameRingReader(const std::string& name);
+
+    ~ShmFrameRingReader();
+
+    ShmFrameRingReader(const ShmFrameRingReader&) = delete;
+    ShmFrameRingReader& operator=(const ShmFrameRingReader&) = delete;
+
+    bool isOpen() const { return mBase != nullptr; }
+
+    const std::string& error() const { return mError; }
+
+    std::uint32_t capacity() const { return mHeader ? mHeader->capacity : 0; }
+
+    std::uint32_t slotCount() const { return mHeader ? mHeader->slotCount : 0; }
+
+    /*
+     * @brief:
+     *         Step number of the newest complete frame (0 before the first).
+     */
+
+    std::uint64_t latestStep() const;
+
+    /*
+     * @brief:
+     *         Copies the newest complete frame.
+     *
+     * @return:
+     *         false if nothing has been published yet.
+     */
+
+    bool readLatest(ShmFrame& out);
+
+    /*
+     * @brief:
+     *         Copies the frame of a specific step.
+     *
+     * @return:
+     *         false if that step is not (or no longer) in the ring.
+     */
+
+    bool readStep(std::uint64_t step, ShmFrame& out);
+
+    /*
+     * @brief:
+     *         Copies that had to be retried because the writer was
+     *         updating the slot at the same time.
+     */
+
+    std::uint64_t retries() const { return mRetries; }
+
+private:
+    std::string mError;
+    const unsigned char* mBase = nullptr;
+    std::size_t mMappedBytes = 0;
+    const ShmRingHeader* mHeader = nullptr;
+    std::uint64_t mRetries = 0;
+};
+
+#endif // SHM_FRAME_RING_H
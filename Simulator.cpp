@@ -1,6 +1,9 @@
 #include "Simulator.h"
+#include "Profiler.h"
+#include <chrono>
 #include <sstream>
 #include <iomanip>
+#include <iostream>
 
 /*
  * @brief: Constructs a Simulator using the provided world and initializes
@@ -15,16 +18,26 @@
  *
  * @param: world
  *         Reference to the global world settings.
+ * @param: network
+ *         Network parameters (latency, jitter, drop probability, seed, log).
  */
 
-Simulator::Simulator(const World& world)
+Simulator::Simulator(const World& world, const NetworkParams& network)
     : mWorld(world),
-    mComms(/*baseLatency=*/0.5,
-        /*jitter=*/0.2,
-        /*dropProbability=*/0.15),
+    mComms(network),
     mSimTime(0.0),
     mNextReportTime(0.5),
-    mReportInterval(0.5)   // drones report every 0.5 s
+    mReportInterval(0.5),   // drones report every 0.5 s
+    mStepCounter(&MetricsRegistry::global().counter("sim.steps")),
+    mDronesIntegrated(&MetricsRegistry::global().counter("sim.drones_integrated")),
+    mStepDurationNs(&MetricsRegistry::global().histogram("sim.step_duration_ns")),
+    mStatusBytes(&MetricsRegistry::global().counter("telemetry.status_bytes")),
+    mKeyframes(&MetricsRegistry::global().counter("telemetry.keyframes")),
+    mDeltas(&MetricsRegistry::global().counter("telemetry.deltas")),
+    mSuppressed(&MetricsRegistry::global().counter("telemetry.suppressed")),
+    mUnencodable(&MetricsRegistry::global().counter("telemetry.unencodable")),
+    mAcks(&MetricsRegistry::global().counter("telemetry.acks")),
+    mMissingBase(&MetricsRegistry::global().counter("telemetry.missing_base"))
 {
     // Register HQ node in the comms network
     mComms.addNode("HQ");
@@ -35,26 +48,64 @@ Simulator::Simulator(const World& world)
  *         Creates a new drone, assigns it an ID, and registers it in the
  *         communication network.
  *
- * The drone ID corresponds to its index in the internal vector.
- * A matching network node ("Drone0", "Drone1", ) is also created so that
- * the drone may send telemetry messages.
+ * IDs count up from 0 and are never reused, so the ID equals the index in
+ * the internal vector until the first removal. A matching network node
+ * ("Drone0", "Drone1", …) is also created so that the drone may send
+ * telemetry messages.
  *
  * @param: parameters
  *         Initial drone configuration parameters.
  * @param: startPos 
  *         Starting position in world coordinates.
- * @return: The assigned drone ID.
+ * @return: Handle of the new drone.
  */
 
-int Simulator::addDrone(const DroneParams& parameters, const Vector2& startPos) {
-    int id = static_cast<int>(mDrones.size());   // id = index
+DroneHandle Simulator::addDrone(const DroneParams& parameters, const Vector2& startPos) {
+    int id = mNextDroneId++;
+    DroneHandle handle = mDroneSlots.insert();
     mDrones.emplace_back(id, parameters, startPos);
 
     // Create a node name like "Drone0", "Drone1", etc.
     std::string nodeName = "Drone" + std::to_string(id);
     mComms.addNode(nodeName);
+    mDroneNodes.push_back(mComms.indexOf(nodeName));
+    mComms.setNodePosition(mDroneNodes.back(), startPos);
+    mStatusEncoders.emplace_back();
+    mDroneInboxCursors.push_back(0);
 
-    return id;
+    return handle;
+}
+
+/*
+ * @brief:
+ *         Removes a drone and its network node.
+ *
+ * Swap-and-pop on every per-drone vector, mirroring the slot map: the last
+ * drone takes the removed drone's index.
+ *
+ * @param: drone
+ *         Handle of the drone to remove.
+ * @return: false for a stale handle.
+ */
+
+bool Simulator::removeDrone(DroneHandle drone) {
+    std::size_t removed = 0;
+    std::size_t moved = 0;
+    if (!mDroneSlots.erase(drone, removed, moved)) return false;
+
+    mComms.removeNode("Drone" + std::to_string(mDrones[removed].getId()));
+
+    if (moved != removed) {
+        mDrones[removed] = mDrones[moved];
+        mDroneNodes[removed] = mDroneNodes[moved];
+        mStatusEncoders[removed] = std::move(mStatusEncoders[moved]);
+        mDroneInboxCursors[removed] = mDroneInboxCursors[moved];
+    }
+    mDrones.pop_back();
+    mDroneNodes.pop_back();
+    mStatusEncoders.pop_back();
+    mDroneInboxCursors.pop_back();
+    return true;
 }
 
 /**
@@ -64,17 +115,21 @@ int Simulator::addDrone(const DroneParams& parameters, const Vector2& startPos)
  * Performs bounds checking on the drone ID and forwards the command to
  * the drone instance.
  *
- * @param: droneId
- *         ID of the drone to command.
+ * @param: index
+ *         Index of the drone to command.
  * @param: direction
  *         Normalized direction vector for thrust.
  */
-void Simulator::setDroneThrustDirection(int droneId, const Vector2& direction) {
-    if (droneId >= 0 && droneId < static_cast<int>(mDrones.size())) {
-        mDrones[droneId].setThrustDirection(direction);
+void Simulator::setDroneThrustDirection(int index, const Vector2& direction) {
+    if (index >= 0 && index < static_cast<int>(mDrones.size())) {
+        mDrones[index].setThrustDirection(direction);
     }
 }
 
+void Simulator::setDroneThrustDirection(DroneHandle drone, const Vector2& direction) {
+    setDroneThrustDirection(droneIndex(drone), direction);
+}
+
 /*
  * @brief:
  *         Sets the full thrust force vector for a drone.
@@ -82,15 +137,47 @@ void Simulator::setDroneThrustDirection(int droneId, const Vector2& direction) {
  * Unlike setDroneThrustDirection(), this function directly adjusts both
  * direction and magnitude of the drone's thrust, providing more control.
  *
- * @param: droneId
- *         ID of the drone.
+ * @param: index
+ *         Index of the drone.
  * @param: force
  *         Thrust vector applied to the drone.
  */
 
-void Simulator::setDroneThrustForce(int droneId, const Vector2& force) {
-    if (droneId >= 0 && droneId < static_cast<int>(mDrones.size())) {
-        mDrones[droneId].setThrustForce(force);
+void Simulator::setDroneThrustForce(int index, const Vector2& force) {
+    if (index >= 0 && index < static_cast<int>(mDrones.size())) {
+        mDrones[index].setThrustForce(force);
+    }
+}
+
+void Simulator::setDroneThrustForce(DroneHandle drone, const Vector2& force) {
+    setDroneThrustForce(droneIndex(drone), force);
+}
+
+/*
+ * @brief:
+ *         Applies a batch of thrust force vectors.
+ *
+ * Equivalent to calling setDroneThrustForce() for every entry, without the
+ * per-call Vector2 plumbing on the caller side. Invalid indices are ignored.
+ *
+ * @param: indices
+ *         Indices of the drones to command.
+ * @param: forceX
+ *         Thrust x-components.
+ * @param: forceY
+ *         Thrust y-components.
+ * @param: count
+ *         Number of drones in the batch.
+ */
+
+void Simulator::setDroneThrustForces(const int* indices, const double* forceX,
+    const double* forceY, std::size_t count) {
+    const int droneCount = static_cast<int>(mDrones.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        int index = indices[i];
+        if (index >= 0 && index < droneCount) {
+            mDrones[index].setThrustForce(Vector2(forceX[i], forceY[i]));
+        }
     }
 }
 
@@ -99,22 +186,26 @@ void Simulator::setDroneThrustForce(int droneId, const Vector2& force) {
  *         Removes all thrust from a drone so that only gravity and external
  *         forces act upon it.
  *
- * @param: droneId 
- *         ID of the drone to modify.
+ * @param: index 
+ *         Index of the drone to modify.
  */
 
-void Simulator::clearDroneThrust(int droneId) {
-    if (droneId >= 0 && droneId < static_cast<int>(mDrones.size())) {
-        mDrones[droneId].clearThrust();
+void Simulator::clearDroneThrust(int index) {
+    if (index >= 0 && index < static_cast<int>(mDrones.size())) {
+        mDrones[index].clearThrust();
     }
 }
 
+void Simulator::clearDroneThrust(DroneHandle drone) {
+    clearDroneThrust(droneIndex(drone));
+}
+
 /*
  * @brief:
  *         Advances the physics simulation and communication system by dt seconds.
  *
  * Steps performed:
- * 1. Update each drones physics (position, velocity, forces).
+ * 1. Update each drone’s physics (position, velocity, forces).
  * 2. If the reporting interval has been reached, send a telemetry message
  *    for each drone.
  * 3. Step the communication network to deliver pending messages, simulate
@@ -124,43 +215,117 @@ void Simulator::clearDroneThrust(int droneId) {
  *         Time step in seconds.
  */
 void Simulator::step(double dt) {
+    PROFILE_SCOPE("Simulator::step");
+    auto stepStart = std::chrono::steady_clock::now();
     mSimTime += dt;
 
     // 1) Update all drones (physics)
-    for (auto& d : mDrones) {
-        d.update(dt, mWorld);
+    {
+        PROFILE_SCOPE("physics");
+        for (auto& d : mDrones) {
+            d.update(dt, mWorld);
+        }
+    }
+
+    // Radio connectivity follows the drones (grid cells change only when a
+    // drone crosses a cell boundary)
+    if (mRadioLinksEnabled) {
+        PROFILE_SCOPE("radio.positions");
+        for (size_t i = 0; i < mDrones.size(); ++i) {
+            mComms.setNodePosition(mDroneNodes[i], mDrones[i].getPosition());
+        }
     }
 
     // 2) Periodic status reports from each drone to HQ
     if (mSimTime >= mNextReportTime) {
-        for (const auto& d : mDrones) {
-            sendDroneStatus(d, mSimTime);
+        PROFILE_SCOPE("report");
+        mReportBatch.clear();
+        for (size_t i = 0; i < mDrones.size(); ++i) {
+            sendDroneStatus(i);
         }
+        // one batched send: all payloads are encrypted in a single pass
+        mComms.sendMessages(mReportBatch, mSimTime);
         mNextReportTime += mReportInterval;
+        ++mReportSeq;
     }
 
     // 3) Advance comms network simulation
     mComms.step(mSimTime);
+    if (mDeltaTelemetry) {
+        processTelemetryAcks();
+    }
+
+    // 4) Publish this step's state to telemetry sinks
+    ++mStepIndex;
+    if (!mSinks.empty()) {
+        publishTelemetry();
+    }
+
+    mStepCounter->add();
+    mDronesIntegrated->add(mDrones.size());
+    mStepDurationNs->observe(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - stepStart).count()));
 }
 
 
 /*
  * @brief:
- *         Builds a telemetry status message for a drone and sends it to HQ.
+ *         Builds a telemetry status message for a drone and stages it in the
+ *         current tick's report batch (sent to HQ by step()).
  *
  * The message contains:
  * - Position (x, y)
  * - Velocity (x, y)
  *
- * Values are formatted to two decimal places for readability.
+ * Text reports are formatted to two decimal places for readability;
+ * binary reports (setBinaryStatus) carry millimetre fixed-point values and
+ * the report sequence number.
  *
- * @param: d 
- *         Reference to the drone generating the report.
- * @param: currentTime
- *         Simulation timestamp when the message is sent.
+ * @param: index
+ *         Index of the drone generating the report.
  */
 
-void Simulator::sendDroneStatus(const Drone& d, double currentTime) {
+void Simulator::sendDroneStatus(std::size_t index) {
+    PROFILE_SCOPE("sendDroneStatus");
+    const Drone& d = mDrones[index];
+    if (mDeltaTelemetry) {
+        std::string payload;
+        DeltaEncoder::Kind kind = mStatusEncoders[index].encode(mDeltaParams,
+            static_cast<std::uint32_t>(d.getId()), mReportSeq,
+            d.getPosition(), d.getVelocity(), payload);
+        if (kind == DeltaEncoder::Kind::Suppressed) {
+            mSuppressed->add();
+            return;
+        }
+        if (kind == DeltaEncoder::Kind::Unencodable) {
+            mUnencodable->add();
+            return;
+        }
+        (kind == DeltaEncoder::Kind::Keyframe ? mKeyframes : mDeltas)->add();
+        mStatusBytes->add(payload.size());
+        mReportBatch.push_back({ "Drone" + std::to_string(d.getId()), "HQ", std::move(payload) });
+        return;
+    }
+
+    if (mBinaryStatus) {
+        codec::StatusMsg status;
+        status.droneId = static_cast<std::uint32_t>(d.getId());
+        status.seq = mReportSeq;
+        status.x = d.getPosition().x;
+        status.y = d.getPosition().y;
+        status.vx = d.getVelocity().x;
+        status.vy = d.getVelocity().y;
+        std::string payload = codec::encode(status);
+        if (payload.empty()) {
+            mUnencodable->add();   // NaN or out-of-range state
+            return;
+        }
+        mStatusBytes->add(payload.size());
+        mReportBatch.push_back({ "Drone" + std::to_string(d.getId()), "HQ", std::move(payload) });
+        return;
+    }
+
     std::ostringstream oss;
     oss << "STATUS pos=("
         << std::fixed << std::setprecision(2)
@@ -168,9 +333,268 @@ void Simulator::sendDroneStatus(const Drone& d, double currentTime) {
         << d.getVelocity().x << "," << d.getVelocity().y << ")";
 
     std::string payload = oss.str();
-    std::string fromName = "Drone" + std::to_string(d.getId());
+    mStatusBytes->add(payload.size());
+    mReportBatch.push_back({ "Drone" + std::to_string(d.getId()), "HQ", std::move(payload) });
+}
+
+/*
+ * @brief:
+ *         Runs the HQ and drone halves of the delta telemetry protocol on
+ *         messages delivered during this step.
+ *
+ * Only inbox entries added since the previous call are examined (per-node
+ * read cursors), so the cost is proportional to this step's deliveries
+ * plus one cursor check per drone.
+ */
+
+void Simulator::processTelemetryAcks() {
+    PROFILE_SCOPE("telemetry.acks");
+
+    // HQ: reconstruct state, acknowledge every decoded report
+    const auto& hqInbox = mComms.nodeAt(mComms.indexOf("HQ")).inbox();
+    std::uint64_t missingBefore = mHqTelemetry.missingBase();
+    mAckBatch.clear();
+    for (; mHqInboxCursor < hqInbox.size(); ++mHqInboxCursor) {
+        std::uint32_t droneId = 0;
+        std::uint32_t seq = 0;
+        if (!mHqTelemetry.apply(hqInbox[mHqInboxCursor].payload(), droneId, seq)) continue;
+
+        codec::AckMsg ack;
+        ack.nodeId = droneId;
+        ack.seq = seq;
+        mAckBatch.push_back({ "HQ", "Drone" + std::to_string(droneId), codec::encode(ack) });
+    }
+    mMissingBase->add(mHqTelemetry.missingBase() - missingBefore);
+    if (!mAckBatch.empty()) {
+        mComms.sendMessages(mAckBatch, mSimTime);
+        mAcks->add(mAckBatch.size());
+    }
+
+    // Drones: advance the delta base on acknowledgement
+    for (size_t i = 0; i < mDroneNodes.size(); ++i) {
+        const auto& inbox = mComms.nodeAt(mDroneNodes[i]).inbox();
+        for (std::size_t& k = mDroneInboxCursors[i]; k < inbox.size(); ++k) {
+            codec::AckMsg ack;
+            if (codec::MessageView(inbox[k].payload()).decode(ack)) {
+                mStatusEncoders[i].onAck(ack.seq);
+            }
+        }
+    }
+}
+
+/*
+ * @brief:
+ *         Broadcasts a command from HQ to all drones at the current
+ *         simulation time.
+ *
+ * @param: payload
+ *         Command text.
+ */
+
+void Simulator::broadcastCommand(const std::string& payload) {
+    mComms.broadcast("HQ", payload, mSimTime);
+}
+
+/*
+ * @brief:
+ *         Encodes a command with the binary codec and broadcasts it.
+ *
+ * @param: command
+ *         Command to send.
+ */
+
+bool Simulator::broadcastCommand(const codec::CommandMsg& command) {
+    std::string payload = codec::encode(command);
+    if (payload.empty()) return false;
+    mComms.broadcast("HQ", payload, mSimTime);
+    return true;
+}
+
+/*
+ * @brief:
+ *         Switches drone STATUS reports between text and binary frames.
+ *
+ * @param: enabled
+ *         true for binary StatusMsg frames.
+ */
+
+void Simulator::setBinaryStatus(bool enabled) {
+    mBinaryStatus = enabled;
+}
 
-    mComms.sendMessage(fromName, "HQ", payload, currentTime);
+/*
+ * @brief:
+ *         Adds a telemetry sink (not owned).
+ *
+ * @param: sink
+ *         Sink receiving a frame after every step.
+ */
+
+void Simulator::addTelemetrySink(TelemetrySink& sink) {
+    mSinks.push_back(&sink);
+}
+
+/*
+ * @brief:
+ *         Forwards communication events from the network to the observer.
+ *
+ * @param: observer
+ *         Observer to add.
+ */
+
+void Simulator::addCommsObserver(CommsObserver& observer) {
+    mComms.addObserver(observer);
+}
+
+/*
+ * @brief:
+ *         Removes an observer added with addCommsObserver().
+ *
+ * @param: observer
+ *         Observer to remove.
+ */
+
+void Simulator::removeCommsObserver(CommsObserver& observer) {
+    mComms.removeObserver(observer);
+}
+
+/*
+ * @brief:
+ *         Removes a telemetry sink added with addTelemetrySink().
+ *
+ * @param: sink
+ *         Sink to remove.
+ */
+
+void Simulator::removeTelemetrySink(TelemetrySink& sink) {
+    for (size_t i = 0; i < mSinks.size(); ++i) {
+        if (mSinks[i] == &sink) {
+            mSinks.erase(mSinks.begin() + static_cast<std::ptrdiff_t>(i));
+            return;
+        }
+    }
+}
+
+/*
+ * @brief:
+ *         Builds the frame for the step that just finished and publishes it.
+ *
+ * The column vectors are reused, so after the first step this does not
+ * allocate.
+ */
+
+void Simulator::publishTelemetry() {
+    PROFILE_SCOPE("telemetry.publish");
+    const size_t n = mDrones.size();
+    mFrameIds.resize(n);
+    mFrameX.resize(n);
+    mFrameY.resize(n);
+    mFrameVX.resize(n);
+    mFrameVY.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Drone& d = mDrones[i];
+        mFrameIds[i] = d.getId();
+        mFrameX[i] = d.getPosition().x;
+        mFrameY[i] = d.getPosition().y;
+        mFrameVX[i] = d.getVelocity().x;
+        mFrameVY[i] = d.getVelocity().y;
+    }
+
+    TelemetryFrame frame;
+    frame.step = mStepIndex;
+    frame.time = mSimTime;
+    frame.count = n;
+    frame.ids = mFrameIds.data();
+    frame.x = mFrameX.data();
+    frame.y = mFrameY.data();
+    frame.vx = mFrameVX.data();
+    frame.vy = mFrameVY.data();
+
+    for (TelemetrySink* sink : mSinks) {
+        sink->publish(frame);
+    }
+}
+
+/*
+ * @brief:
+ *         Enables delta-compressed telemetry (implies binary frames).
+ *
+ * Inbox entries delivered before this call are skipped by the HQ decoder
+ * and the drones' acknowledgement handling.
+ *
+ * @param: params
+ *         Keyframe interval and suppression thresholds.
+ */
+
+void Simulator::enableDeltaTelemetry(const DeltaTelemetryParams& params) {
+    mDeltaParams = params;
+    mDeltaTelemetry = true;
+    mHqInboxCursor = mComms.nodeAt(mComms.indexOf("HQ")).inbox().size();
+    for (size_t i = 0; i < mDroneNodes.size(); ++i) {
+        mDroneInboxCursors[i] = mComms.nodeAt(mDroneNodes[i]).inbox().size();
+    }
+}
+
+/*
+ * @brief:
+ *         Enables range-limited radio links.
+ *
+ * Connectivity, drop probability and extra latency are derived from the
+ * distance between nodes. HQ is placed at a fixed position; drone node
+ * positions are refreshed after every physics step.
+ *
+ * @param: params
+ *         Radio range, edge drop probability and per-meter latency.
+ * @param: hqPosition
+ *         World position of the HQ node.
+ */
+
+void Simulator::enableRadioLinks(const RadioLinkParams& params, const Vector2& hqPosition) {
+    mComms.enableRadioLinks(params);
+    mComms.setNodePosition(mComms.indexOf("HQ"), hqPosition);
+    for (size_t i = 0; i < mDrones.size(); ++i) {
+        mComms.setNodePosition(mDroneNodes[i], mDrones[i].getPosition());
+    }
+    mRadioLinksEnabled = true;
+}
+
+/*
+ * @brief:
+ *         Enables multi-hop mesh routing on top of the radio links.
+ *
+ * Each node keeps a route cache filled by on-demand route discovery.
+ * Caches of drones that crossed a radio grid cell are dropped at the next
+ * network tick; broken hops elsewhere are repaired when they are used.
+ *
+ * @param: maxHops
+ *         Maximum route length in hops.
+ */
+void Simulator::enableMeshRouting(int maxHops) {
+    if (!mRadioLinksEnabled) return;
+    mComms.enableMeshRouting(maxHops);
+}
+
+/*
+ * @brief:
+ *         Enables the per-node bandwidth and queueing model.
+ *
+ * Message latency then includes transmit queueing, token-bucket waits and
+ * serialization at both ends on top of the propagation latency. Queue
+ * depth and queueing delay are exported as net.tx_* / net.rx_* metrics.
+ *
+ * @param: params
+ *         Bandwidth model parameters.
+ */
+void Simulator::enableBandwidthLimits(const BandwidthParams& params) {
+    mComms.enableBandwidthLimits(params);
+}
+
+/*
+ * @brief:
+ *         Switches the communication log to the compressed writer.
+ */
+bool Simulator::enableCommsLogCompression() {
+    return mComms.enableLogCompression();
 }
 
 /*
@@ -188,4 +612,12 @@ void Simulator::sendDroneStatus(const Drone& d, double currentTime) {
  */
 void Simulator::printCommsSummary() const {
     mComms.printSummary(mSimTime);
+
+    if (mDeltaTelemetry) {
+        std::cout << "\nDelta telemetry:    " << mKeyframes->value() << " keyframes, "
+            << mDeltas->value() << " deltas, "
+            << mSuppressed->value() << " suppressed, "
+            << mStatusBytes->value() << " STATUS bytes, "
+            << mAcks->value() << " acks\n";
+    }
 }
@@ -1,10 +1,23 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include "Drone.h"
 #include "World.h"
 #include "Network.h"
+#include "MessageCodec.h"
+#include "DeltaTelemetry.h"
+#include "TelemetrySink.h"
+#include "Metrics.h"
+#include "SlotMap.h"
+
+/*
+ * Stable reference to a drone (see Simulator::addDrone()).
+ */
+
+using DroneHandle = SlotHandle;
 
 /*
  * @class: 
@@ -18,7 +31,7 @@
  * the physics environment, world settings, and swarm-level behaviors.
  *
  * Responsibilities:
- * - Create drones and initialize their parameters.
+ * - Create and remove drones and initialize their parameters.
  * - Apply thrust vectors to individual drones.
  * - Step the physics simulation forward by a fixed or variable dt.
  * - Relay drone telemetry through the Network subsystem.
@@ -26,6 +39,12 @@
  *
  * This class is intended to be used by a main program or higher-level scenario
  * engine that issues commands and reads telemetry.
+ *
+ * Drones live densely packed in getDrones(), in no particular order once
+ * drones have been removed. A DroneHandle refers to one drone for its whole
+ * life; an index into getDrones() is only valid until the next removal.
+ * Drone IDs (getId(), network node "Drone<id>", telemetry) are never reused.
+ * Without removals, index, ID and handle index all coincide.
  */
 
 class Simulator {
@@ -36,37 +55,96 @@ public:
      *         Constructs a new Simulator using the provided world settings.
      * @param:
      *         world Global environment settings (gravity, bounds, etc.).
+     * @param:
+     *         network Link model, RNG seed and comms log of the network
+     *         (the defaults are the original 0.5 s / 0.2 s / 15% model
+     *         logging to comms_log.csv).
      */
 
-    Simulator(const World& world);
+    Simulator(const World& world, const NetworkParams& network = NetworkParams());
 
     /*
      * @brief:
-     *         Adds a new drone to the simulation.
+     *         Adds a new drone to the simulation, in O(1) (at any time, e.g.
+     *         for a late launch).
+     *
+     * The drone is appended to getDrones() and gets the next drone ID and
+     * its network node.
      *
      * @param: parameters
      *         Initial configuration values (mass, thrust limits, etc.).
      * @param: startPos
      *         Starting position of the drone in world coordinates.
-     * @return: The unique ID assigned to the new drone.
+     * @return: Handle of the new drone.
      */
 
-    int addDrone(const DroneParams& parameters, const Vector2& startPos);
+    DroneHandle addDrone(const DroneParams& parameters, const Vector2& startPos);
+
+    /*
+     * @brief:
+     *         Removes a drone (crash, battery out), in O(1) apart from the
+     *         network node removal.
+     *
+     * The last drone of getDrones() moves into the freed index; no other
+     * drone moves and every other handle stays valid. The drone's network
+     * node is removed too (see Network::removeNode for its cost), so
+     * in-flight messages to it are dropped.
+     *
+     * @param: drone
+     *         Drone to remove.
+     * @return: false if the handle is stale (nothing changes).
+     */
+
+    bool removeDrone(DroneHandle drone);
+
+    /*
+     * @return: true while the drone has not been removed.
+     */
+
+    bool isAlive(DroneHandle drone) const { return mDroneSlots.contains(drone); }
+
+    /*
+     * @return: Index of the drone in getDrones(), -1 for a stale handle.
+     */
+
+    int droneIndex(DroneHandle drone) const {
+        std::size_t index = mDroneSlots.indexOf(drone);
+        return index == SlotMap::npos ? -1 : static_cast<int>(index);
+    }
+
+    /*
+     * @return: Handle of the drone at an index of getDrones().
+     */
+
+    DroneHandle droneHandle(std::size_t index) const { return mDroneSlots.handleAt(index); }
+
+    /*
+     * @return: The drone, or nullptr for a stale handle.
+     */
+
+    const Drone* getDrone(DroneHandle drone) const {
+        std::size_t index = mDroneSlots.indexOf(drone);
+        return index == SlotMap::npos ? nullptr : &mDrones[index];
+    }
+
+    std::size_t droneCount() const { return mDrones.size(); }
 
     /*
      * @brief: 
      *         Sets the direction of the drone's thrust vector.
      *
-     * This does not set the magnitudeonly the normalized direction in which
+     * This does not set the magnitude—only the normalized direction in which
      * thrust is applied. Magnitude can be set separately via setDroneThrustForce().
      *
-     * @param: droneId
-     *         ID of the drone to command.
+     * @param: index
+     *         Index of the drone in getDrones().
      * @param: direction
      *         The thrust direction vector.
      */
 
-    void setDroneThrustDirection(int droneId, const Vector2& direction);
+    void setDroneThrustDirection(int index, const Vector2& direction);
+
+    void setDroneThrustDirection(DroneHandle drone, const Vector2& direction);
 
     /*
      * @brief:
@@ -75,13 +153,36 @@ public:
      * This directly sets both direction and magnitude of the thrust. Used for
      * more precise control (e.g., autopilot or AI controller).
      *
-     * @param: droneId
-     *         ID of the drone to command.
+     * @param: index
+     *         Index of the drone in getDrones().
      * @param: force
      *         The thrust force vector.
      */
 
-    void setDroneThrustForce(int droneId, const Vector2& force);
+    void setDroneThrustForce(int index, const Vector2& force);
+
+    void setDroneThrustForce(DroneHandle drone, const Vector2& force);
+
+    /*
+     * @brief:
+     *         Sets thrust force vectors for many drones in one call.
+     *
+     * Batched form of setDroneThrustForce() intended for controllers that
+     * compute thrust as structure-of-arrays (see FormationController).
+     * Each force is clamped to the drone's maxThrust.
+     *
+     * @param: indices
+     *         Indices in getDrones() of the drones to command.
+     * @param: forceX
+     *         Thrust x-components, one per drone.
+     * @param: forceY
+     *         Thrust y-components, one per drone.
+     * @param: count
+     *         Number of entries in each array.
+     */
+
+    void setDroneThrustForces(const int* indices, const double* forceX,
+        const double* forceY, std::size_t count);
 
     /*
      * @brief: 
@@ -90,11 +191,13 @@ public:
      * Effectively sets the thrust vector to zero, meaning the drone will only be
      * influenced by gravity and other external forces.
      *
-     * @param: droneId
-     *         ID of the drone to modify.
+     * @param: index
+     *         Index of the drone in getDrones().
      */
 
-    void clearDroneThrust(int droneId);
+    void clearDroneThrust(int index);
+
+    void clearDroneThrust(DroneHandle drone);
 
     /*
      * @brief:
@@ -124,6 +227,164 @@ public:
 
     const std::vector<Drone>& getDrones() const { return mDrones; }
 
+    /*
+     * @brief:
+     *         Sends a swarm-wide command from HQ to every drone.
+     *
+     * Uses Network::broadcast(), so the payload is encrypted once and
+     * shared by all recipients, while each drone still sees its own
+     * latency and drop outcome.
+     *
+     * @param: payload
+     *         Command text.
+     */
+
+    void broadcastCommand(const std::string& payload);
+
+    /*
+     * @brief:
+     *         Broadcasts a binary-encoded command (see MessageCodec.h).
+     *
+     * @param: command
+     *         Command fields; encoded once, then broadcast like the text
+     *         overload.
+     * @return: false (nothing sent) if a target coordinate is NaN or out of
+     *          the codec's fixed-point range.
+     */
+
+    bool broadcastCommand(const codec::CommandMsg& command);
+
+    /*
+     * @brief:
+     *         Selects the STATUS report encoding.
+     *
+     * Binary reports use the schema codec (varint id/sequence, millimetre
+     * fixed-point position and velocity) and are roughly a third of the
+     * size of the text form. Logs render them in readable form.
+     *
+     * @param: enabled
+     *         true = binary StatusMsg frames, false = text (default).
+     */
+
+    void setBinaryStatus(bool enabled);
+
+    /*
+     * @brief:
+     *         Switches STATUS reports to delta-compressed binary telemetry.
+     *
+     * Drones send a full keyframe every keyframeInterval reports and, in
+     * between, quantized deltas against the last report HQ acknowledged.
+     * Reports that changed less than the thresholds since an acknowledged
+     * report are not sent at all. HQ reconstructs every drone's state (see
+     * hqTelemetry()) and acknowledges each report it decodes.
+     *
+     * @param: params
+     *         Keyframe interval and suppression thresholds.
+     */
+
+    void enableDeltaTelemetry(const DeltaTelemetryParams& params);
+
+    /*
+     * @brief:
+     *         HQ's reconstructed view of the swarm (delta telemetry mode).
+     *
+     * @return:
+     *         Decoder holding the latest reconstructed state per drone.
+     */
+
+    const DeltaDecoder& hqTelemetry() const { return mHqTelemetry; }
+
+    /*
+     * @brief:
+     *         Registers a sink that receives one TelemetryFrame at the end
+     *         of every step.
+     *
+     * The simulator does not take ownership; the sink must outlive the
+     * simulation (or be removed with removeTelemetrySink()).
+     *
+     * @param: sink
+     *         Sink to publish to.
+     */
+
+    void addTelemetrySink(TelemetrySink& sink);
+
+    /*
+     * @brief:
+     *         Registers an observer that sees every communication event as
+     *         it is written to the comms log (same lifetime rules as sinks).
+     *
+     * @param: observer
+     *         Observer to notify.
+     */
+
+    void addCommsObserver(CommsObserver& observer);
+
+    void removeCommsObserver(CommsObserver& observer);
+
+    /*
+     * @brief:
+     *         Stops publishing to a previously added sink.
+     *
+     * @param: sink
+     *         Sink to remove; ignored if it was never added.
+     */
+
+    void removeTelemetrySink(TelemetrySink& sink);
+
+    /*
+     * @brief:
+     *         Switches the network from all-to-all delivery to range-limited
+     *         radio links driven by drone positions.
+     *
+     * @param: params
+     *         Radio link parameters (max range, drop and latency model).
+     * @param: hqPosition
+     *         Fixed world position of the HQ node.
+     */
+
+    void enableRadioLinks(const RadioLinkParams& params, const Vector2& hqPosition);
+
+    /*
+     * @brief:
+     *         Routes unicast messages (drone status reports) over multiple
+     *         radio hops instead of requiring a direct link to HQ.
+     *
+     * Must be called after enableRadioLinks(); has no effect otherwise.
+     *
+     * @param: maxHops
+     *         Upper bound on the route length explored by route discovery.
+     */
+
+    void enableMeshRouting(int maxHops);
+
+    /*
+     * @brief:
+     *         Gives every radio finite bandwidth: per-node transmit and
+     *         receive queues with token-bucket shaping and serialization
+     *         delay proportional to the encrypted frame size.
+     *
+     * With this enabled the status burst sent at every report interval
+     * queues at the drones and at HQ instead of arriving all at once.
+     *
+     * @param: params
+     *         Line rate, token bucket rate/depth, frame overhead and
+     *         maximum queue depth.
+     */
+
+    void enableBandwidthLimits(const BandwidthParams& params);
+
+    /*
+     * @brief:
+     *         Writes the communication log compressed, as comms_log.csv.lz
+     *         (see LogCompression.h). Call before the first step.
+     *
+     * @return:
+     *         false if the compressed file could not be created (the plain
+     *         log is kept).
+     */
+
+    bool enableCommsLogCompression();
+
     /*
      * @brief:
      *         Prints a summary of all communication messages exchanged
@@ -134,33 +395,103 @@ public:
 
     void printCommsSummary() const;
 
+    /*
+     * @brief:
+     *         Messages delivered / dropped so far (per recipient).
+     */
+
+    int deliveredMessageCount() const { return mComms.deliveredCount(); }
+
+    std::size_t droppedMessageCount() const { return mComms.droppedCount(); }
+
+    double getSimTime() const { return mSimTime; }
+
 private:
     
     /*
      * @brief:
-     *         Sends a single drone's status message over the communication network.
+     *         Builds a single drone's status message for the communication network.
      *
-     * Called internally at each reporting interval.
+     * Called internally at each reporting interval. The message is appended
+     * to the tick's report batch, which step() sends in one call.
      *
-     * @param: d 
-     *         The drone whose status is being reported.
-     * @param:
-     *         currentTime  Simulation time at which the report is generated.
+     * @param: index
+     *         Index of the reporting drone in mDrones.
+     */
+
+    void sendDroneStatus(std::size_t index);
+
+    /*
+     * @brief:
+     *         Delta telemetry bookkeeping after the network step.
+     *
+     * HQ decodes newly delivered reports and acknowledges them in one
+     * batch; drones apply newly delivered acknowledgements to their
+     * encoders.
      */
 
-    void sendDroneStatus(const Drone& d, double currentTime);
+    void processTelemetryAcks();
+
+    /*
+     * @brief:
+     *         Gathers the drone state into SoA columns and hands the frame
+     *         to every registered sink.
+     */
+
+    void publishTelemetry();
 
     // World settings
     World mWorld;
 
-    // Collection of all active drones in the simulation
+    // Collection of all active drones in the simulation (dense; every
+    // per-drone vector below is indexed the same way and kept in step by
+    // addDrone()/removeDrone())
     std::vector<Drone> mDrones;
+    SlotMap mDroneSlots;
+    int mNextDroneId = 0;
 
     // Comms network + timing
     Network mComms;
     double mSimTime;
     double mNextReportTime;
     double mReportInterval;
+    std::vector<OutgoingMessage> mReportBatch;
+    bool mBinaryStatus = false;
+    std::uint32_t mReportSeq = 0;
+
+    // Delta telemetry: per-drone encoders, HQ decoder, inbox read cursors
+    bool mDeltaTelemetry = false;
+    DeltaTelemetryParams mDeltaParams;
+    std::vector<DeltaEncoder> mStatusEncoders;
+    DeltaDecoder mHqTelemetry;
+    std::size_t mHqInboxCursor = 0;
+    std::vector<std::size_t> mDroneInboxCursors;
+    std::vector<OutgoingMessage> mAckBatch;
+
+    // Per-step telemetry frame (columns reused across steps)
+    std::vector<TelemetrySink*> mSinks;
+    std::uint64_t mStepIndex = 0;
+    std::vector<int> mFrameIds;
+    std::vector<double> mFrameX;
+    std::vector<double> mFrameY;
+    std::vector<double> mFrameVX;
+    std::vector<double> mFrameVY;
+
+    // Network node index of each drone, and whether positions drive links
+    std::vector<int> mDroneNodes;
+    bool mRadioLinksEnabled = false;
+
+    // Runtime metrics (owned by MetricsRegistry::global())
+    Counter* mStepCounter;
+    Counter* mDronesIntegrated;
+    Histogram* mStepDurationNs;
+    Counter* mStatusBytes;
+    Counter* mKeyframes;
+    Counter* mDeltas;
+    Counter* mSuppressed;
+    Counter* mUnencodable;
+    Counter* mAcks;
+    Counter* mMissingBase;
 };
 
 #endif // SIMULATOR_H
@@ -0,0 +1,150 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * @class:
+ *         SlotHandle
+ * @brief:
+ *         Generational handle to an element of a SlotMap.
+ *
+ * A handle stays valid until its element is erased and never becomes valid
+ * again: reusing the slot bumps its generation, so a stale handle is
+ * detected instead of silently referring to the newcomer.
+ */
+
+struct SlotHandle {
+    static constexpr std::uint32_t kInvalidIndex = 0xffffffffu;
+
+    std::uint32_t index = kInvalidIndex;    // slot
+    std::uint32_t generation = 0;
+
+    bool valid() const { return index != kInvalidIndex; }
+
+    bool operator==(const SlotHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+/*
+ * @class:
+ *         SlotMap
+ * @brief:
+ *         Maps generational handles to indices of densely packed arrays,
+ *         with O(1) insert, erase and lookup.
+ *
+ * The map owns no elements: the caller keeps its element arrays dense and
+ * mirrors the map's moves. insert() corresponds to a push_back; erase()
+ * reports which dense index was vacated and which element (the last one)
+ * moves into it, i.e. a swap-and-pop. Handles of other elements are not
+ * affected by either, only their dense index may change.
+ *
+ * Erased slots go on a free list and are reused (newest first) with a new
+ * generation.
+ */
+
+class SlotMap {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /*
+     * @brief:
+     *         Registers a new element at dense index size() (before the
+     *         call); the caller appends it to its arrays.
+     *
+     * @return: Handle of the new element.
+     */
+
+    SlotHandle insert() {
+        std::uint32_t slot;
+        if (!mFree.empty()) {
+            slot = mFree.back();
+            mFree.pop_back();
+        }
+        else {
+            slot = static_cast<std::uint32_t>(mSlots.size());
+            mSlots.push_back(Slot());
+        }
+        mSlots[slot].dense = static_cast<std::uint32_t>(mDenseToSlot.size());
+        mDenseToSlot.push_back(slot);
+        return SlotHandle{ slot, mSlots[slot].generation };
+    }
+
+    /*
+     * @brief:
+     *         Erases an element.
+     *
+     * The caller then moves its element at dense index 'moved' into
+     * 'removed' (nothing to do when they are equal) and pops the back.
+     *
+     * @param: handle
+     *         Element to erase.
+     * @param: removed
+     *         Receives the dense index the element occupied.
+     * @param: moved
+     *         Receives the dense index of the element that fills the gap
+     *         (the former last element).
+     * @return: false if the handle is stale or invalid (nothing changes).
+     */
+
+    bool erase(SlotHandle handle, std::size_t& removed, std::size_t& moved) {
+        if (!contains(handle)) return false;
+        Slot& slot = mSlots[handle.index];
+        removed = slot.dense;
+        moved = mDenseToSlot.size() - 1;
+
+        std::uint32_t lastSlot = mDenseToSlot.back();
+        mDenseToSlot[removed] = lastSlot;
+        mSlots[lastSlot].dense = static_cast<std::uint32_t>(removed);
+        mDenseToSlot.pop_back();
+
+        ++slot.generation;
+        slot.dense = kNoDense;
+        mFree.push_back(handle.index);
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const {
+        return handle.index < mSlots.size()
+            && mSlots[handle.index].generation == handle.generation
+            && mSlots[handle.index].dense != kNoDense;
+    }
+
+    /*
+     * @return: Dense index of the element, npos for a stale handle.
+     */
+
+    std::size_t indexOf(SlotHandle handle) const {
+        return contains(handle) ? mSlots[handle.index].dense : npos;
+    }
+
+    /*
+     * @return: Handle of the element at a dense index (< size()).
+     */
+
+    SlotHandle handleAt(std::size_t dense) const {
+        std::uint32_t slot = mDenseToSlot[dense];
+        return SlotHandle{ slot, mSlots[slot].generation };
+    }
+
+    std::size_t size() const { return mDenseToSlot.size(); }
+
+private:
+    static constexpr std::uint32_t kNoDense = 0xffffffffu;
+
+    struct Slot {
+        std::uint32_t dense = kNoDense;
+        std::uint32_t generation = 0;
+    };
+
+    std::vector<Slot> mSlots;
+    std::vector<std::uint32_t> mDenseToSlot;
+    std::vector<std::uint32_t> mFree;
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,250 @@
+#include "SocketTelemetrySink.h"
+#include "Profiler.h"
+#include "TelemetryProtocol.h"
+
+#if !defined(_WIN32)
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if !defined(_WIN32)
+    bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+#endif
+
+#if defined(MSG_NOSIGNAL)
+    constexpr int kSendFlags = MSG_NOSIGNAL;   // closed peer -> EPIPE, not SIGPIPE
+#else
+    constexpr int kSendFlags = 0;
+#endif
+}
+
+/*
+ * @brief:
+ *         Parses the endpoint and creates a non-blocking listening socket.
+ *
+ * On failure the sink stays closed and error() holds the reason; the
+ * simulation keeps running without streaming.
+ *
+ * @param: endpoint
+ *         "unix:<path>" or "tcp:<port>".
+ */
+
+SocketTelemetrySink::SocketTelemetrySink(const std::string& endpoint)
+    : mFramesSent(&MetricsRegistry::global().counter("stream.frames_sent")),
+    mFramesDropped(&MetricsRegistry::global().counter("stream.frames_dropped")),
+    mBytesSent(&MetricsRegistry::global().counter("stream.bytes_sent")),
+    mClientsGauge(&MetricsRegistry::global().gauge("stream.clients"))
+{
+#if defined(_WIN32)
+    mError = "socket telemetry stream requires a POSIX platform";
+    (void)endpoint;
+#else
+    int fd = -1;
+    if (endpoint.compare(0, 5, "unix:") == 0) {
+        std::string path = endpoint.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            mError = "invalid unix socket path: " + path;
+            return;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        ::unlink(path.c_str());   // stale socket from a previous run
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            mError = "cannot bind " + path + ": " + std::strerror(errno);
+            if (fd >= 0) ::close(fd);
+            return;
+        }
+        mUnixPath = path;
+    }
+    else if (endpoint.compare(0, 4, "tcp:") == 0) {
+        int port = std::atoi(endpoint.c_str() + 4);
+        if (port <= 0 || port > 65535) {
+            mError = "invalid tcp port: " + endpoint.substr(4);
+            return;
+        }
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<std::uint16_t>(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            mError = "cannot bind 127.0.0.1:" + std::to_string(port) + ": " + std::strerror(errno);
+            if (fd >= 0) ::close(fd);
+            return;
+        }
+    }
+    else {
+        mError = "endpoint must be unix:<path> or tcp:<port>: " + endpoint;
+        return;
+    }
+
+    if (listen(fd, 8) != 0 || !setNonBlocking(fd)) {
+        mError = std::string("cannot listen: ") + std::strerror(errno);
+        ::close(fd);
+        return;
+    }
+    mListenFd = fd;
+#endif
+}
+
+SocketTelemetrySink::~SocketTelemetrySink() {
+    close();
+}
+
+/*
+ * @brief:
+ *         Encodes the frame once and offers it to every client.
+ *
+ * Per client:
+ * - finish a previously torn frame first; if that does not complete, this
+ *   frame is dropped for the client;
+ * - otherwise write the frame; if the socket is full before the first byte
+ *   the frame is dropped, if it is full midway the rest is kept as the
+ *   client's pending tail.
+ *
+ * @param: frame
+ *         Frame for the step that just finished.
+ */
+
+void SocketTelemetrySink::publish(const TelemetryFrame& frame) {
+    if (mListenFd < 0) return;
+    PROFILE_SCOPE("stream.publish");
+
+    acceptClients();
+    if (mClients.empty()) return;
+
+    mFrame.clear();
+    TelemetryProtocol::appendFrame(mFrame, frame);
+
+    for (std::size_t i = 0; i < mClients.size();) {
+        Client& client = mClients[i];
+
+        if (client.pendingOffset < client.pending.size()) {
+            long n = sendSome(client, client.pending.data() + client.pendingOffset,
+                client.pending.size() - client.pendingOffset);
+            if (n < 0) {
+                dropClient(i);
+                continue;
+            }
+            client.pendingOffset += static_cast<std::size_t>(n);
+            if (client.pendingOffset < client.pending.size()) {
+                mFramesDropped->add();   // still busy with an older frame
+                ++i;
+                continue;
+            }
+            client.pending.clear();
+            client.pendingOffset = 0;
+        }
+
+        long n = sendSome(client, mFrame.data(), mFrame.size());
+        if (n < 0) {
+            dropClient(i);
+            continue;
+        }
+        if (n == 0) {
+            mFramesDropped->add();
+        }
+        else {
+            mFramesSent->add();
+            if (static_cast<std::size_t>(n) < mFrame.size()) {
+                client.pending.assign(mFrame, static_cast<std::size_t>(n), std::string::npos);
+                client.pendingOffset = 0;
+            }
+        }
+        ++i;
+    }
+}
+
+/*
+ * @brief:
+ *         Disconnects all clients and removes the listening socket.
+ */
+
+void SocketTelemetrySink::close() {
+#if !defined(_WIN32)
+    for (auto& client : mClients) ::close(client.fd);
+    mClients.clear();
+    if (mListenFd >= 0) {
+        ::close(mListenFd);
+        mListenFd = -1;
+    }
+    if (!mUnixPath.empty()) {
+        ::unlink(mUnixPath.c_str());
+        mUnixPath.clear();
+    }
+    mClientsGauge->set(0.0);
+#endif
+}
+
+/*
+ * @brief:
+ *         Accepts every pending connection without blocking.
+ */
+
+void SocketTelemetrySink::acceptClients() {
+#if !defined(_WIN32)
+    for (;;) {
+        int fd = accept(mListenFd, nullptr, nullptr);
+        if (fd < 0) break;   // EAGAIN: nothing pending
+        if (!setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));   // fails harmlessly on unix sockets
+#if defined(SO_NOSIGPIPE)
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        mClients.push_back({ fd, std::string(), 0 });
+    }
+    mClientsGauge->set(static_cast<double>(mClients.size()));
+#endif
+}
+
+long SocketTelemetrySink::sendSome(Client& client, const char* data, std::size_t size) {
+#if defined(_WIN32)
+    (void)client; (void)data; (void)size;
+    return -1;
+#else
+    std::size_t written = 0;
+    while (written < size) {
+        ssize_t n = send(client.fd, data + written, size - written, kSendFlags);
+        if (n > 0) {
+            written += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        return -1;
+    }
+    mBytesSent->add(written);
+    return static_cast<long>(written);
+#endif
+}
+
+void SocketTelemetrySink::dropClient(std::size_t index) {
+#if !defined(_WIN32)
+    ::close(mClients[index].fd);
+#endif
+    mClients[index] = std::move(mClients.back());
+    mClients.pop_back();
+    mClientsGauge->set(static_cast<double>(mClients.size()));
+}
@@ -0,0 +1,95 @@
+#ifndef SOCKET_TELEMETRY_SINK_H
+#define SOCKET_TELEMETRY_SINK_H
+
+#include <string>
+#include <vector>
+#include "Metrics.h"
+#include "TelemetrySink.h"
+
+/*
+ * @class:
+ *         SocketTelemetrySink
+ * @brief:
+ *         Streams one binary frame per step (TelemetryProtocol.h) to every
+ *         client connected to a local socket.
+ *
+ * The sink listens on a Unix-domain socket ("unix:/path/to.sock") or a
+ * loopback TCP port ("tcp:5555"). Everything is non-blocking: pending
+ * connections are accepted at the start of publish(), and each client gets
+ * the frame only if its socket can take it right now. A client that is not
+ * keeping up loses whole frames (it sees a gap in the step number); a
+ * frame that was only partly written is completed before anything newer is
+ * sent, so the stream never contains a torn frame.
+ *
+ * POSIX only; on other platforms the sink never opens and publish() is a
+ * no-op.
+ */
+
+class SocketTelemetrySink : public TelemetrySink {
+public:
+
+    /*
+     * @brief:
+     *         Opens the listening socket.
+     *
+     * @param: endpoint
+     *         "unix:<path>" or "tcp:<port>" (TCP binds 127.0.0.1 only).
+     */
+
+    explicit SocketTelemetrySink(const std::string& endpoint);
+
+    ~SocketTelemetrySink() override;
+
+    SocketTelemetrySink(const SocketTelemetrySink&) = delete;
+    SocketTelemetrySink& operator=(const SocketTelemetrySink&) = delete;
+
+    /*
+     * @brief:
+     *         True if the listening socket was created; otherwise
+     *         error() describes why.
+     */
+
+    bool isOpen() const { return mListenFd >= 0; }
+
+    const std::string& error() const { return mError; }
+
+    std::size_t clientCount() const { return mClients.size(); }
+
+    void publish(const TelemetryFrame& frame) override;
+
+    void close() override;
+
+private:
+    struct Client {
+        int fd;
+        std::string pending;        // unsent tail of a partly written frame
+        std::size_t pendingOffset;
+    };
+
+    void acceptClients();
+
+    /*
+     * @brief:
+     *         Writes as much of 'data' as the client's socket accepts.
+     *
+     * @return:
+     *         Bytes written, or -1 if the connection failed.
+     */
+
+    long sendSome(Client& client, const char* data, std::size_t size);
+
+    void dropClient(std::size_t index);
+
+    int mListenFd = -1;
+    std::string mUnixPath;
+    std::string mError;
+    std::vector<Client> mClients;
+    std::string mFrame;
+
+    Counter* mFramesSent;
+    Counter* mFramesDropped;
+    Counter* mBytesSent;
+    Gauge* mClientsGauge;
+};
+
+#endif // SOCKET_TELEMETRY_SINK_H
@@ -0,0 +1,89 @@
+#ifndef TELEMETRY_LOG_INDEX_H
+#define TELEMETRY_LOG_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/*
+ * @brief:
+ *         Binary layout of the step index written next to a telemetry CSV
+ *         ("<log>.idx").
+ *
+ * All fields are little-endian. The file is a 32-byte header followed by
+ * one fixed-size 32-byte entry per logged step, in step order:
+ *
+ *   header                          entry
+ *   offset  size  field             offset  size  field
+ *   0       4     magic "DSTI"      0       8     step     uint64
+ *   4       2     version 1         8       8     time     float64
+ *   6       2     headerSize (32)   16      8     offset   uint64, first row
+ *   8       4     entrySize (32)    24      4     count    uint32, rows
+ *   12      20    reserved (0)      28      4     reserved (0)
+ *
+ * Steps are consecutive, so the entry of step s is at
+ * headerSize + (s - firstStep) * entrySize, where firstStep is the step of
+ * entry 0. The rows of a step are the bytes from its offset up to the next
+ * entry's offset (or the end of the CSV for the last step).
+ */
+
+namespace TelemetryLogIndex {
+
+    constexpr std::uint32_t kMagic = 0x49545344;   // "DSTI" in little-endian byte order
+    constexpr std::uint16_t kVersion = 1;
+    constexpr std::size_t kHeaderSize = 32;
+    constexpr std::size_t kEntrySize = 32;
+
+    struct Entry {
+        std::uint64_t step;
+        double time;
+        std::uint64_t offset;
+        std::uint32_t count;
+    };
+
+    inline std::string indexPath(const std::string& logPath) {
+        return logPath + ".idx";
+    }
+
+    inline void encodeHeader(char* out) {
+        std::memset(out, 0, kHeaderSize);
+        std::memcpy(out, &kMagic, 4);
+        std::memcpy(out + 4, &kVersion, 2);
+        std::uint16_t headerSize = static_cast<std::uint16_t>(kHeaderSize);
+        std::uint32_t entrySize = static_cast<std::uint32_t>(kEntrySize);
+        std::memcpy(out + 6, &headerSize, 2);
+        std::memcpy(out + 8, &entrySize, 4);
+    }
+
+    inline bool parseHeader(const char* data) {
+        std::uint32_t magic;
+        std::uint16_t version, headerSize;
+        std::uint32_t entrySize;
+        std::memcpy(&magic, data, 4);
+        std::memcpy(&version, data + 4, 2);
+        std::memcpy(&headerSize, data + 6, 2);
+        std::memcpy(&entrySize, data + 8, 4);
+        return magic == kMagic && version == kVersion
+            && headerSize == kHeaderSize && entrySize == kEntrySize;
+    }
+
+    inline void encodeEntry(char* out, const Entry& e) {
+        std::memset(out, 0, kEntrySize);
+        std::memcpy(out, &e.step, 8);
+        std::memcpy(out + 8, &e.time, 8);
+        std::memcpy(out + 16, &e.offset, 8);
+        std::memcpy(out + 24, &e.count, 4);
+    }
+
+    inline Entry decodeEntry(const char* data) {
+        Entry e;
+        std::memcpy(&e.step, data, 8);
+        std::memcpy(&e.time, data + 8, 8);
+        std::memcpy(&e.offset, data + 16, 8);
+        std::memcpy(&e.count, data + 24, 4);
+        return e;
+    }
+}
+
+#endif // TELEMETRY_LOG_INDEX_H
@@ -0,0 +1,218 @@
+#include "TelemetryLogReader.h"
+#include <cmath>
+#include <cstdlib>
+
+/*
+ * @brief:
+ *         Returns a view over this frame's columns.
+ */
+
+TelemetryFrame LoggedFrame::view() const {
+    TelemetryFrame frame;
+    frame.step = step;
+    frame.time = time;
+    frame.count = ids.size();
+    frame.ids = ids.data();
+    frame.x = x.data();
+    frame.y = y.data();
+    frame.vx = vx.data();
+    frame.vy = vy.data();
+    return frame;
+}
+
+/*
+ * @brief:
+ *         Opens both files, validates the index header and reads the first
+ *         entry's step.
+ */
+
+TelemetryLogReader::TelemetryLogReader(const std::string& path)
+    : mLog(path, std::ios::binary),
+    mIndex(TelemetryLogIndex::indexPath(path), std::ios::binary)
+{
+    if (!mLog) {
+        mError = "could not open " + path;
+        return;
+    }
+    if (!mIndex) {
+        mError = "could not open " + TelemetryLogIndex::indexPath(path);
+        return;
+    }
+
+    char header[TelemetryLogIndex::kHeaderSize];
+    if (!mIndex.read(header, sizeof(header)) || !TelemetryLogIndex::parseHeader(header)) {
+        mError = TelemetryLogIndex::indexPath(path) + ": not a telemetry log index";
+        return;
+    }
+
+    mOpen = true;
+    TelemetryLogIndex::Entry first;
+    if (readEntryAt(0, first)) mFirstStep = first.step;
+}
+
+std::uint64_t TelemetryLogReader::stepCount() {
+    if (!mOpen) return 0;
+    mIndex.clear();
+    mIndex.seekg(0, std::ios::end);
+    std::uint64_t size = static_cast<std::uint64_t>(mIndex.tellg());
+    if (size < TelemetryLogIndex::kHeaderSize) return 0;
+    return (size - TelemetryLogIndex::kHeaderSize) / TelemetryLogIndex::kEntrySize;
+}
+
+bool TelemetryLogReader::readEntryAt(std::uint64_t index, TelemetryLogIndex::Entry& out) {
+    char data[TelemetryLogIndex::kEntrySize];
+    mIndex.clear();
+    mIndex.seekg(static_cast<std::streamoff>(TelemetryLogIndex::kHeaderSize + index * TelemetryLogIndex::kEntrySize));
+    if (!mIndex.read(data, sizeof(data))) return false;
+    out = TelemetryLogIndex::decodeEntry(data);
+    return true;
+}
+
+bool TelemetryLogReader::entry(std::uint64_t step, TelemetryLogIndex::Entry& out) {
+    if (!mOpen) return false;
+    if (mFirstStep == 0) {
+        // log was empty when opened; pick up the first step once it exists
+        TelemetryLogIndex::Entry first;
+        if (!readEntryAt(0, first)) return false;
+        mFirstStep = first.step;
+    }
+    if (step < mFirstStep) return false;
+    return readEntryAt(step - mFirstStep, out);
+}
+
+/*
+ * @brief:
+ *         Interpolates a first guess from the first and last entries, then
+ *         narrows with a binary search if the guess was off.
+ */
+
+std::uint64_t TelemetryLogReader::stepAtTime(double t) {
+    std::uint64_t n = stepCount();
+    TelemetryLogIndex::Entry first, last;
+    if (n == 0 || !readEntryAt(0, first) || !readEntryAt(n - 1, last)) return 0;
+    if (t <= first.time) return first.step;
+    if (t >= last.time) return last.step;
+
+    // lower bound: first index with time >= t lies in (lo, hi]
+    std::uint64_t lo = 0, hi = n - 1;
+    double fraction = (t - first.time) / (last.time - first.time);
+    std::uint64_t guess = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(n - 1)));
+    if (guess > lo && guess < hi) {
+        TelemetryLogIndex::Entry g, before;
+        if (!readEntryAt(guess, g) || !readEntryAt(guess - 1, before)) return 0;
+        if (g.time >= t && before.time < t) {
+            return (g.time - t <= t - before.time) ? g.step : before.step;
+        }
+        if (g.time >= t) hi = guess;
+        else lo = guess;
+    }
+
+    while (hi - lo > 1) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        TelemetryLogIndex::Entry m;
+        if (!readEntryAt(mid, m)) return 0;
+        if (m.time >= t) hi = mid;
+        else lo = mid;
+    }
+
+    TelemetryLogIndex::Entry a, b;
+    if (!readEntryAt(lo, a) || !readEntryAt(hi, b)) return 0;
+    return (b.time - t <= t - a.time) ? b.step : a.step;
+}
+
+bool TelemetryLogReader::readStep(std::uint64_t step, LoggedFrame& out) {
+    std::vector<LoggedFrame> frames;
+    if (!readRange(step, step, frames)) return false;
+    out = std::move(frames.front());
+    return true;
+}
+
+/*
+ * @brief:
+ *         Reads the byte range from step 'first' up to the step after
+ *         'last' (or end of file) and splits it using the index counts.
+ */
+
+bool TelemetryLogReader::readRange(std::uint64_t first, std::uint64_t last, std::vector<LoggedFrame>& out) {
+    out.clear();
+    if (!mOpen || last < first) return false;
+
+    std::vector<TelemetryLogIndex::Entry> entries;
+    entries.reserve(static_cast<std::size_t>(last - first + 1));
+    for (std::uint64_t s = first; s <= last; ++s) {
+        TelemetryLogIndex::Entry e;
+        if (!entry(s, e)) return false;
+        entries.push_back(e);
+    }
+
+    std::uint64_t endOffset;
+    TelemetryLogIndex::Entry next;
+    if (entry(last + 1, next)) {
+        endOffset = next.offset;
+    }
+    else {
+        mLog.clear();
+        mLog.seekg(0, std::ios::end);
+        endOffset = static_cast<std::uint64_t>(mLog.tellg());
+    }
+    if (endOffset < entries.front().offset) return false;
+
+    std::size_t bytes = static_cast<std::size_t>(endOffset - entries.front().offset);
+    mBuffer.resize(bytes + 1);
+    mLog.clear();
+    mLog.seekg(static_cast<std::streamoff>(entries.front().offset));
+    if (!mLog.read(mBuffer.data(), static_cast<std::streamsize>(bytes))) return false;
+    mBuffer[bytes] = '\0';   // strtod stops here at the latest
+
+    out.resize(entries.size());
+    for (std::size_t k = 0; k < entries.size(); ++k) {
+        const char* begin = mBuffer.data() + (entries[k].offset - entries.front().offset);
+        const char* end = (k + 1 < entries.size())
+            ? mBuffer.data() + (entries[k + 1].offset - entries.front().offset)
+            : mBuffer.data() + bytes;
+        if (!parseRows(begin, end, entries[k], out[k])) {
+            out.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * @brief:
+ *         Parses 'count' rows of "time,droneId,x,y,vx,vy\n".
+ *
+ * @return:
+ *         false on a malformed or incomplete (still being written) row.
+ */
+
+bool TelemetryLogReader::parseRows(const char* begin, const char* end,
+    const TelemetryLogIndex::Entry& e, LoggedFrame& out)
+{
+    const std::size_t n = e.count;
+    out.step = e.step;
+    out.time = e.time;
+    out.ids.resize(n);
+    out.x.resize(n);
+    out.y.resize(n);
+    out.vx.resize(n);
+    out.vy.resize(n);
+
+    const char* p = begin;
+    char* next = nullptr;
+    for (std::size_t i = 0; i < n; ++i) {
+        double values[6];
+        for (int f = 0; f < 6; ++f) {
+            values[f] = std::strtod(p, &next);
+            char expected = (f == 5) ? '\n' : ',';
+            if (next == p || next >= end || *next != expected) return false;
+            p = next + 1;
+        }
+        out.ids[i] = static_cast<int>(values[1]);
+        out.x[i] = values[2];
+        out.y[i] = values[3];
+        out.vx[i] = values[4];
+        out.vy[i] = values[5];
+    }
+    return true;
+}
@@ -0,0 +1,130 @@
+#ifndef TELEMETRY_LOG_READER_H
+#define TELEMETRY_LOG_READER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "TelemetryLogIndex.h"
+#include "TelemetrySink.h"
+
+/*
+ * @class:
+ *         LoggedFrame
+ * @brief:
+ *         One step read back from a telemetry CSV.
+ */
+
+struct LoggedFrame {
+    std::uint64_t step = 0;
+    double time = 0.0;
+    std::vector<int> ids;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> vx;
+    std::vector<double> vy;
+
+    /*
+     * @brief:
+     *         Column view of this frame, e.g. to forward it to a sink.
+     */
+
+    TelemetryFrame view() const;
+};
+
+/*
+ * @class:
+ *         TelemetryLogReader
+ * @brief:
+ *         Random access to a telemetry CSV through its step index
+ *         (written by CsvTelemetrySink).
+ *
+ * Neither file is loaded into memory: finding a step is one index read
+ * and a seek, and only the requested rows are read and parsed. A log that
+ * is still being written can be read; steps appear as they are flushed.
+ */
+
+class TelemetryLogReader {
+public:
+
+    /*
+     * @brief:
+     *         Opens the CSV and "<path>.idx".
+     *
+     * @param: path
+     *         CSV path, e.g. "simulation_log.csv".
+     */
+
+    explicit TelemetryLogReader(const std::string& path);
+
+    bool isOpen() const { return mOpen; }
+
+    const std::string& error() const { return mError; }
+
+    /*
+     * @brief:
+     *         Number of indexed steps (re-checked on every call, so it grows
+     *         while the log is being written).
+     */
+
+    std::uint64_t stepCount();
+
+    std::uint64_t firstStep() const { return mFirstStep; }
+
+    /*
+     * @brief:
+     *         Index entry of a step.
+     *
+     * @return:
+     *         false if the step is not in the log.
+     */
+
+    bool entry(std::uint64_t step, TelemetryLogIndex::Entry& out);
+
+    /*
+     * @brief:
+     *         Step whose time is closest to 't' (clamped to the logged
+     *         range).
+     *
+     * The first guess assumes a constant dt, so for a fixed-step log this
+     * costs one or two index reads; otherwise it falls back to a binary
+     * search over the index.
+     *
+     * @return:
+     *         0 if the log is empty.
+     */
+
+    std::uint64_t stepAtTime(double t);
+
+    /*
+     * @brief:
+     *         Reads the rows of one step.
+     */
+
+    bool readStep(std::uint64_t step, LoggedFrame& out);
+
+    /*
+     * @brief:
+     *         Reads steps [first, last] with a single contiguous read of the
+     *         CSV, e.g. the window a visualizer is showing.
+     *
+     * @return:
+     *         false if any step in the range is not in the log.
+     */
+
+    bool readRange(std::uint64_t first, std::uint64_t last, std::vector<LoggedFrame>& out);
+
+private:
+    bool readEntryAt(std::uint64_t index, TelemetryLogIndex::Entry& out);
+
+    bool parseRows(const char* begin, const char* end, const TelemetryLogIndex::Entry& e, LoggedFrame& out);
+
+    bool mOpen = false;
+    std::string mError;
+    std::ifstream mLog;
+    std::ifstream mIndex;
+    std::uint64_t mFirstStep = 0;
+    std::vector<char> mBuffer;
+};
+
+#endif // TELEMETRY_LOG_READER_H
@@ -0,0 +1,123 @@
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "TelemetrySink.h"
+
+/*
+ * @brief:
+ *         Binary wire format of one telemetry frame (stream protocol v1).
+ *
+ * All fields are little-endian. A frame is a fixed 32-byte header followed
+ * by five columns of 'count' entries each:
+ *
+ *   offset  size  field
+ *   0       4     magic    "DSTF" (0x46545344)
+ *   4       2     version  1
+ *   6       2     headerSize (32)
+ *   8       8     step     uint64
+ *   16      8     time     float64, simulation seconds
+ *   24      4     count    uint32, number of drones
+ *   28      4     reserved (0)
+ *   32      4*n   ids      int32
+ *   ..      8*n   x        float64
+ *   ..      8*n   y        float64
+ *   ..      8*n   vx       float64
+ *   ..      8*n   vy       float64
+ *
+ * A frame is therefore 32 + 36 * count bytes. Frames are written back to
+ * back on the stream; a reader that skipped frames sees a gap in 'step'.
+ * The format is shared by the socket stream, the shared-memory ring and
+ * the binary telemetry log so one decoder handles all of them.
+ */
+
+namespace TelemetryProtocol {
+
+    constexpr std::uint32_t kMagic = 0x46545344;   // "DSTF" in little-endian byte order
+    constexpr std::uint16_t kVersion = 1;
+    constexpr std::size_t kHeaderSize = 32;
+    constexpr std::size_t kBytesPerDrone = 4 + 4 * 8;
+
+    struct Header {
+        std::uint64_t step;
+        double time;
+        std::uint32_t count;
+    };
+
+    inline std::size_t frameSize(std::size_t count) {
+        return kHeaderSize + kBytesPerDrone * count;
+    }
+
+    // The simulator only targets little-endian hosts, so fields are copied
+    // as-is (memcpy keeps the access unaligned-safe).
+    template <typename T>
+    inline void put(std::string& out, const T& v) {
+        out.append(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    template <typename T>
+    inline T get(const char* p) {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        return v;
+    }
+
+    /*
+     * @brief:
+     *         Appends the encoded frame to 'out'.
+     */
+
+    inline void appendFrame(std::string& out, const TelemetryFrame& frame) {
+        out.reserve(out.size() + frameSize(frame.count));
+        put(out, kMagic);
+        put(out, kVersion);
+        put(out, static_cast<std::uint16_t>(kHeaderSize));
+        put(out, frame.step);
+        put(out, frame.time);
+        put(out, static_cast<std::uint32_t>(frame.count));
+        put(out, std::uint32_t{ 0 });
+
+        for (std::size_t i = 0; i < frame.count; ++i) put(out, static_cast<std::int32_t>(frame.ids[i]));
+        out.append(reinterpret_cast<const char*>(frame.x), frame.count * sizeof(double));
+        out.append(reinterpret_cast<const char*>(frame.y), frame.count * sizeof(double));
+        out.append(reinterpret_cast<const char*>(frame.vx), frame.count * sizeof(double));
+        out.append(reinterpret_cast<const char*>(frame.vy), frame.count * sizeof(double));
+    }
+
+    /*
+     * @brief:
+     *         Parses a frame header.
+     *
+     * @return:
+     *         false if the bytes are not a v1 frame header.
+     */
+
+    inline bool parseHeader(const char* data, std::size_t size, Header& header) {
+        if (size < kHeaderSize) return false;
+        if (get<std::uint32_t>(data) != kMagic) return false;
+        if (get<std::uint16_t>(data + 4) != kVersion) return false;
+        if (get<std::uint16_t>(data + 6) != kHeaderSize) return false;
+        header.step = get<std::uint64_t>(data + 8);
+        header.time = get<double>(data + 16);
+        header.count = get<std::uint32_t>(data + 24);
+        return true;
+    }
+
+    /*
+     * @brief:
+     *         Byte offset of a column inside a frame of 'count' drones.
+     *
+     * @param: column
+     *         0 = ids, 1 = x, 2 = y, 3 = vx, 4 = vy.
+     */
+
+    inline std::size_t columnOffset(std::size_t count, int column) {
+        if (column == 0) return kHeaderSize;
+        return kHeaderSize + 4 * count + static_cast<std::size_t>(column - 1) * 8 * count;
+    }
+}
+
+#endif // TELEMETRY_PROTOCOL_H
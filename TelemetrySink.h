@@ -0,0 +1,63 @@
+#ifndef TELEMETRY_SINK_H
+#define TELEMETRY_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * @class:
+ *         TelemetryFrame
+ * @brief:
+ *         State of every drone after one simulation step, as parallel
+ *         (structure-of-arrays) columns.
+ *
+ * The arrays are owned by the publisher and are only valid for the duration
+ * of TelemetrySink::publish(); sinks that need the data later copy it.
+ */
+
+struct TelemetryFrame {
+    std::uint64_t step = 0;     // step index, starting at 1
+    double time = 0.0;          // simulation time after the step
+    std::size_t count = 0;      // number of drones (length of every column)
+    const int* ids = nullptr;
+    const double* x = nullptr;
+    const double* y = nullptr;
+    const double* vx = nullptr;
+    const double* vy = nullptr;
+};
+
+/*
+ * @class:
+ *         TelemetrySink
+ * @brief:
+ *         Consumer of per-step telemetry frames.
+ *
+ * Registered with Simulator::addTelemetrySink(); publish() is called once
+ * at the end of every Simulator::step() on the simulation thread, so it
+ * should return quickly (queue, copy or drop rather than block).
+ */
+
+class TelemetrySink {
+public:
+    virtual ~TelemetrySink() = default;
+
+    /*
+     * @brief:
+     *         Receives the frame for one completed step.
+     *
+     * @param: frame
+     *         Column views valid only during this call.
+     */
+
+    virtual void publish(const TelemetryFrame& frame) = 0;
+
+    /*
+     * @brief:
+     *         Flushes and releases resources; called by the owner after the
+     *         last frame. The default does nothing.
+     */
+
+    virtual void close() {}
+};
+
+#endif // TELEMETRY_SINK_H
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "../ChaCha20.h"
+
+/**
+ * @brief:
+ *         Self-test and throughput benchmark for the ChaCha20 cipher
+ *         (ChaCha20.h).
+ *
+ * Self-test (default): the RFC 8439 block function (section 2.3.2) and
+ * encryption (section 2.4.2) vectors, xorBatch() against xorStream() per
+ * job over jobs of random length (in place and out of place), and an
+ * apply() round trip.
+ *
+ * Benchmark: --bench encrypts messages of one size in place, once with a
+ * xorStream() call per message and once in xorBatch() calls of 256
+ * messages, and prints GB/s for both. Without --size it runs 64 B, 1 KB and
+ * 16 KB messages.
+ *
+ * Usage:
+ *   CipherCheck [--jobs N] [--seed S]
+ *   CipherCheck --bench [--size BYTES] [--mb M]
+ *
+ * Build (from the repository root; the AVX2 batch path is picked at run
+ * time when the CPU has it):
+ *   g++ -std=c++17 -O2 Tools/CipherCheck.cpp ChaCha20.cpp -o cipher_check
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::uint8_t> fromHex(const char* hex) {
+        std::vector<std::uint8_t> bytes;
+        for (const char* c = hex; c[0] && c[1]; ) {
+            if (*c == ' ') {
+                ++c;
+                continue;
+            }
+            bytes.push_back(static_cast<std::uint8_t>(std::strtoul(std::string(c, 2).c_str(), nullptr, 16)));
+            c += 2;
+        }
+        return bytes;
+    }
+
+    ChaCha20::Key rfcKey() {
+        ChaCha20::Key key;
+        for (std::size_t i = 0; i < key.size(); ++i) key[i] = static_cast<std::uint8_t>(i);
+        return key;
+    }
+
+    // RFC 8439 2.3.2: key 00..1f, nonce 000000090000004a00000000, counter 1
+    bool checkBlockVector() {
+        const ChaCha20::Nonce nonce = { 0, 0, 0, 0x09, 0, 0, 0, 0x4a, 0, 0, 0, 0 };
+        const std::vector<std::uint8_t> expected = fromHex(
+            "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+            "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e");
+        std::uint8_t out[64];
+        ChaCha20::block(rfcKey(), nonce, 1, out);
+        if (std::vector<std::uint8_t>(out, out + 64) == expected) return true;
+        std::cerr << "RFC 8439 2.3.2 block function vector differs\n";
+        return false;
+    }
+
+    // RFC 8439 2.4.2: key 00..1f, nonce 000000000000004a00000000, counter 1
+    bool checkEncryptionVector() {
+        const ChaCha20::Nonce nonce = { 0, 0, 0, 0, 0, 0, 0, 0x4a, 0, 0, 0, 0 };
+        const std::string plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you "
+            "only one tip for the future, sunscreen would be it.";
+        const std::vector<std::uint8_t> expected = fromHex(
+            "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+            "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+            "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+            "5af90bbf74a35be6b40b8eedf2785e42874d");
+        std::vector<std::uint8_t> out(plaintext.size());
+        ChaCha20::xorStream(rfcKey(), nonce, 1,
+            reinterpret_cast<const std::uint8_t*>(plaintext.data()), out.data(), out.size());
+        if (out == expected) return true;
+        std::cerr << "RFC 8439 2.4.2 encryption vector differs\n";
+        return false;
+    }
+
+    bool checkBatch(std::size_t jobs, std::uint64_t seed, bool inPlace) {
+        const ChaCha20::Key key = ChaCha20::deriveKey("USMC-COMMS-KEY");
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<std::size_t> length(0, 300);
+
+        std::vector<std::vector<std::uint8_t>> input(jobs);
+        std::vector<std::vector<std::uint8_t>> output(jobs);
+        std::vector<ChaCha20::Job> batch(jobs);
+        for (std::size_t j = 0; j < jobs; ++j) {
+            input[j].resize(length(rng));
+            for (auto& b : input[j]) b = static_cast<std::uint8_t>(rng());
+            output[j] = input[j];
+            std::uint8_t* out = output[j].data();
+            const std::uint8_t* in = inPlace ? out : input[j].data();
+            batch[j] = { in, out, input[j].size(), rng() };
+        }
+        ChaCha20::xorBatch(key, batch.data(), batch.size());
+
+        for (std::size_t j = 0; j < jobs; ++j) {
+            std::vector<std::uint8_t> reference(input[j].size());
+            ChaCha20::xorStream(key, ChaCha20::nonceFromId(batch[j].nonceId), 0,
+                input[j].data(), reference.data(), reference.size());
+            if (reference != output[j]) {
+                std::cerr << "job " << j << " (" << input[j].size() << " bytes) differs\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkRoundTrip(std::uint64_t seed) {
+        const ChaCha20::Key key = ChaCha20::deriveKey("USMC-COMMS-KEY");
+        std::mt19937_64 rng(seed);
+        for (std::size_t size = 0; size < 1000; size += 7) {
+            std::string text(size, '\0');
+            for (auto& c : text) c = static_cast<char>(rng());
+            std::uint64_t id = rng();
+            std::string cipher = ChaCha20::apply(key, id, text);
+            if ((size >= 16 && cipher == text) || ChaCha20::apply(key, id, cipher) != text) {
+                std::cerr << "apply() does not round trip " << size << " bytes\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int runSelfTest(std::size_t jobs, std::uint64_t seed) {
+        std::cout << "batch path: " << (ChaCha20::hasSimdBatch() ? "AVX2" : "scalar") << "\n";
+        const bool results[] = {
+            checkBlockVector(),
+            checkEncryptionVector(),
+            checkBatch(jobs, seed, false),
+            checkBatch(jobs, seed + 1, true),
+            checkRoundTrip(seed),
+        };
+        const auto passed = std::count(std::begin(results), std::end(results), true);
+        const bool ok = passed == static_cast<long>(std::size(results));
+        std::cout << (ok ? "PASS" : "FAIL") << ": " << passed << "/" << std::size(results)
+            << " checks (RFC 8439 vectors, " << jobs << " batch jobs in and out of place, apply() round trip)\n";
+        return ok ? 0 : 1;
+    }
+
+    double gigabytesPerSecond(std::size_t bytes, Clock::duration elapsed) {
+        return static_cast<double>(bytes) / std::chrono::duration<double, std::nano>(elapsed).count();
+    }
+
+    // about 'megabytes' MB in messages of 'size' bytes, encrypted 256 at a time in place
+    void runBench(std::size_t size, std::size_t megabytes) {
+        const ChaCha20::Key key = ChaCha20::deriveKey("USMC-COMMS-KEY");
+        const std::size_t batchSize = 256;
+        const std::size_t passes = std::max<std::size_t>(1, megabytes * 1000000 / (size * batchSize));
+        std::vector<std::uint8_t> buffer(batchSize * size, 0x5a);
+        std::vector<ChaCha20::Job> batch(batchSize);
+        for (std::size_t j = 0; j < batchSize; ++j) {
+            std::uint8_t* message = buffer.data() + j * size;
+            batch[j] = { message, message, size, 0 };
+        }
+
+        Clock::time_point start = Clock::now();
+        for (std::size_t p = 0; p < passes; ++p) {
+            for (std::size_t j = 0; j < batchSize; ++j) {
+                ChaCha20::xorStream(key, ChaCha20::nonceFromId(p * batchSize + j), 0,
+                    batch[j].in, batch[j].out, size);
+            }
+        }
+        const Clock::duration streamTime = Clock::now() - start;
+
+        start = Clock::now();
+        for (std::size_t p = 0; p < passes; ++p) {
+            for (std::size_t j = 0; j < batchSize; ++j) batch[j].nonceId = p * batchSize + j;
+            ChaCha20::xorBatch(key, batch.data(), batch.size());
+        }
+        const Clock::duration batchTime = Clock::now() - start;
+
+        const std::size_t bytes = passes * batchSize * size;
+        std::cout << std::fixed << std::setprecision(2) << size << " B messages: xorStream " << gigabytesPerSecond(bytes, streamTime)
+            << " GB/s, xorBatch " << gigabytesPerSecond(bytes, batchTime) << " GB/s ("
+            << (ChaCha20::hasSimdBatch() ? "AVX2" : "scalar") << ")\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t jobs = 5000;
+    std::uint64_t seed = 1;
+    bool bench = false;
+    std::size_t size = 0;
+    std::size_t megabytes = 256;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--bench") bench = true;
+        else if (arg == "--jobs" && hasValue) jobs = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--seed" && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--size" && hasValue) size = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--mb" && hasValue) megabytes = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else {
+            std::cerr << "usage: CipherCheck [--jobs N] [--seed S]\n"
+                         "       CipherCheck --bench [--size BYTES] [--mb M]\n";
+            return 2;
+        }
+    }
+
+    if (!bench) return runSelfTest(jobs, seed);
+    if (size > 0) runBench(size, megabytes);
+    else {
+        for (std::size_t s : { 64, 1024, 16384 }) runBench(s, megabytes);
+    }
+    return 0;
+}
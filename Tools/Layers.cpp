@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "../CsvFormat.h"
+#include "../Scenario3D.h"
+
+/**
+ * @brief:
+ *         Runs the altitude-layered 3D formation (layeredScenario()).
+ *
+ * Drones take off from a ground grid and form one ring per altitude layer.
+ * Prints convergence and overshoot; --csv writes the trajectory (every
+ * --every steps) as time,drone,x,y,z,vx,vy,vz.
+ *
+ * Usage:
+ *   Layers [--layers L] [--per-layer N] [--spacing M] [--duration T]
+ *          [--csv trajectory.csv] [--every K]
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/Layers.cpp Scenario3D.cpp Drone.cpp FormationController.cpp -o layers
+ */
+
+int main(int argc, char** argv) {
+    std::size_t layers = 3;
+    std::size_t perLayer = 8;
+    double spacing = 10.0;
+    double duration = 30.0;
+    std::size_t every = 10;
+    std::string csvPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--layers" && hasValue) layers = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--per-layer" && hasValue) perLayer = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--spacing" && hasValue) spacing = std::atof(argv[++i]);
+        else if (arg == "--duration" && hasValue) duration = std::atof(argv[++i]);
+        else if (arg == "--csv" && hasValue) csvPath = argv[++i];
+        else if (arg == "--every" && hasValue) every = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else {
+            std::cerr << "usage: Layers [--layers L] [--per-layer N] [--spacing M] [--duration T]"
+                " [--csv trajectory.csv] [--every K]\n";
+            return 2;
+        }
+    }
+    if (every == 0) every = 1;
+
+    Scenario3DParams scenario = layeredScenario(layers, perLayer, spacing);
+    scenario.duration = duration;
+
+    std::ofstream csv;
+    std::string text;
+    std::size_t step = 0;
+    std::function<void(double, const std::vector<Drone3>&)> record;
+    if (!csvPath.empty()) {
+        csv.open(csvPath, std::ios::binary);
+        if (!csv) {
+            std::cerr << "cannot write " << csvPath << "\n";
+            return 1;
+        }
+        csv << "time,drone,x,y,z,vx,vy,vz\n";
+        record = [&](double time, const std::vector<Drone3>& drones) {
+            if (++step % every != 0) return;
+            text.clear();
+            for (const Drone3& d : drones) {
+                CsvFormat::appendReal(text, time);
+                text += ',';
+                CsvFormat::appendInt(text, d.getId());
+                const Vector3& p = d.getPosition();
+                const Vector3& v = d.getVelocity();
+                for (double c : { p.x, p.y, p.z, v.x, v.y, v.z }) {
+                    text += ',';
+                    CsvFormat::appendReal(text, c);
+                }
+                text += '\n';
+            }
+            csv.write(text.data(), static_cast<std::streamsize>(text.size()));
+        };
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ScenarioResult result = runScenario3D(scenario, record);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::fixed << std::setprecision(3)
+        << layers * perLayer << " drones in " << layers << " layers, "
+        << result.steps << " steps in " << seconds << " s\n";
+    if (result.converged()) std::cout << "converged at " << result.convergenceTime << " s";
+    else std::cout << "not converged after " << scenario.duration << " s";
+    std::cout << ", max overshoot " << result.maxOvershoot << " m\n";
+    return 0;
+}
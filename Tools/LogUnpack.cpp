@@ -0,0 +1,122 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "../CompressedTelemetrySink.h"
+#include "../CsvFormat.h"
+#include "../LogCompression.h"
+
+/**
+ * @brief:
+ *         Decompresses the simulator's compressed logs (LogCompression.h).
+ *
+ * - "*.lz"  (--log-compress): restores the original file byte for byte,
+ *   e.g. simulation_log.csv.lz -> simulation_log.csv. The step index
+ *   (simulation_log.csv.idx) is written uncompressed and applies to the
+ *   restored CSV.
+ * - "*.dtz" (--record): writes the frames as a simulation_log.csv-style
+ *   CSV. Each value is printed with 6 significant digits, like the live CSV;
+ *   use CompressedTelemetryReader for the exact doubles.
+ *
+ * Prints the compressed and restored sizes and the time taken.
+ *
+ * Usage:
+ *   LogUnpack <input.lz|input.dtz> <output>
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/LogUnpack.cpp LogCompression.cpp CompressedTelemetrySink.cpp TelemetryLogReader.cpp Metrics.cpp Profiler.cpp -pthread -o log_unpack
+ */
+
+namespace {
+
+    bool endsWith(const std::string& s, const char* suffix) {
+        std::size_t n = std::strlen(suffix);
+        return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+    }
+
+    int unpackTelemetry(const std::string& in, std::ofstream& out, std::uint64_t& written) {
+        CompressedTelemetryReader reader(in);
+        if (!reader.isOpen()) {
+            std::cerr << reader.error() << "\n";
+            return 1;
+        }
+
+        std::string text = "time,droneId,x,y,vx,vy\n";
+        LoggedFrame frame;
+        while (reader.next(frame)) {
+            for (std::size_t i = 0; i < frame.ids.size(); ++i) {
+                CsvFormat::appendReal(text, frame.time);
+                text += ',';
+                CsvFormat::appendInt(text, frame.ids[i]);
+                text += ',';
+                CsvFormat::appendReal(text, frame.x[i]);
+                text += ',';
+                CsvFormat::appendReal(text, frame.y[i]);
+                text += ',';
+                CsvFormat::appendReal(text, frame.vx[i]);
+                text += ',';
+                CsvFormat::appendReal(text, frame.vy[i]);
+                text += '\n';
+            }
+            if (text.size() > (1 << 20)) {
+                out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                written += text.size();
+                text.clear();
+            }
+        }
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        written += text.size();
+
+        if (!reader.error().empty()) {
+            std::cerr << in << ": " << reader.error() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    int unpackBytes(const std::string& in, std::ofstream& out, std::uint64_t& written) {
+        CompressedLogReader reader(in);
+        if (!reader.isOpen()) {
+            std::cerr << reader.error() << "\n";
+            return 1;
+        }
+
+        std::string block;
+        LogCompression::BlockFilter filter;
+        while (reader.nextBlock(block, filter)) {
+            out.write(block.data(), static_cast<std::streamsize>(block.size()));
+            written += block.size();
+        }
+        if (!reader.error().empty()) {
+            std::cerr << in << ": " << reader.error() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: LogUnpack <input.lz|input.dtz> <output>\n";
+        return 2;
+    }
+
+    std::string in = argv[1];
+    std::ofstream out(argv[2], std::ios::binary);
+    if (!out) {
+        std::cerr << "cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t written = 0;
+    int rc = endsWith(in, ".dtz") ? unpackTelemetry(in, out, written) : unpackBytes(in, out, written);
+    out.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ifstream compressed(in, std::ios::binary | std::ios::ate);
+    std::cout << in << ": " << compressed.tellg() << " -> " << written << " bytes in "
+        << seconds << " s\n";
+    return rc;
+}
@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "../LogCompression.h"
+
+/**
+ * @brief:
+ *         Self-test of the log block codec and file format (LogCompression.h).
+ *
+ * 1. Round trip: compress() then decompress() restores random inputs of
+ *    several kinds (random bytes, long runs, CSV-like rows, short repeating
+ *    patterns; 0 bytes to a few hundred KB); decoding with a rawSize one byte
+ *    too small or too large is rejected.
+ * 2. Truncation: every prefix of a compressed block is rejected or decodes
+ *    to the original (a trailing empty sequence carries no data).
+ * 3. Corruption: blocks with random bytes overwritten are rejected or decode
+ *    to exactly rawSize bytes. Run a -fsanitize=address build to check that
+ *    the decoder never reads or writes out of bounds.
+ * 4. Files: a CompressedLogWriter log with small blocks reads back through
+ *    CompressedLogReader byte for byte. Cut at random lengths, the reader
+ *    returns a prefix of the data and sets error() unless the cut falls on a
+ *    block boundary; a bad codec byte or block size is reported.
+ *
+ * The file checks write and remove lz_check.tmp in the working directory.
+ *
+ * Usage:
+ *   LzCheck [--inputs N] [--seed S]
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/LzCheck.cpp LogCompression.cpp Metrics.cpp Profiler.cpp -pthread -o lz_check
+ */
+
+namespace {
+
+    const char kTempPath[] = "lz_check.tmp";
+
+    std::string randomInput(std::mt19937_64& rng, std::size_t maxSize) {
+        std::size_t size = std::uniform_int_distribution<std::size_t>(0, maxSize)(rng);
+        std::string data;
+        data.reserve(size);
+        switch (rng() % 4) {
+        case 0:   // incompressible
+            while (data.size() < size) data.push_back(static_cast<char>(rng()));
+            break;
+        case 1:   // runs of one byte
+            while (data.size() < size) data.append(1 + rng() % 300, static_cast<char>(rng() % 4));
+            break;
+        case 2: {   // log rows: repeated structure, changing digits
+            char row[96];
+            for (std::uint64_t step = 0; data.size() < size; ++step) {
+                int n = std::snprintf(row, sizeof(row), "%.3f,%u,%.6f,%.6f\n", step * 0.01,
+                    static_cast<unsigned>(rng() % 64), (rng() % 100000) * 1e-3, (rng() % 100000) * 1e-3);
+                data.append(row, static_cast<std::size_t>(n));
+            }
+            break;
+        }
+        default: {   // short pattern with occasional noise (overlapping matches)
+            std::string pattern(1 + rng() % 7, '\0');
+            for (auto& c : pattern) c = static_cast<char>(rng());
+            while (data.size() < size) {
+                data += pattern;
+                if (rng() % 50 == 0) data.push_back(static_cast<char>(rng()));
+            }
+            break;
+        }
+        }
+        data.resize(size);
+        return data;
+    }
+
+    bool checkRoundTrip(std::size_t inputs, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::string packed, unpacked;
+        for (std::size_t i = 0; i < inputs; ++i) {
+            std::string data = randomInput(rng, i % 10 == 0 ? 300000 : 3000);
+            LogCompression::compress(data.data(), data.size(), packed);
+            if (!LogCompression::decompress(packed.data(), packed.size(), data.size(), unpacked) || unpacked != data) {
+                std::cerr << "input " << i << " (" << data.size() << " bytes) does not round trip\n";
+                return false;
+            }
+            bool shortOk = !data.empty() &&
+                LogCompression::decompress(packed.data(), packed.size(), data.size() - 1, unpacked);
+            bool longOk = LogCompression::decompress(packed.data(), packed.size(), data.size() + 1, unpacked);
+            if (shortOk || longOk) {
+                std::cerr << "input " << i << " decodes with a wrong rawSize\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool checkTruncation(std::size_t inputs, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::string packed, unpacked;
+        for (std::size_t i = 0; i < inputs; ++i) {
+            std::string data = randomInput(rng, 2000);
+            LogCompression::compress(data.data(), data.size(), packed);
+            for (std::size_t cut = 0; cut < packed.size(); ++cut) {
+                if (LogCompression::decompress(packed.data(), cut, data.size(), unpacked) && unpacked != data) {
+                    std::cerr << "input " << i << " cut at " << cut << " decodes to wrong data\n";
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool checkCorruption(std::size_t inputs, std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::string packed, unpacked;
+        for (std::size_t i = 0; i < inputs; ++i) {
+            std::string data = randomInput(rng, 5000);
+            LogCompression::compress(data.data(), data.size(), packed);
+            if (packed.empty()) continue;
+            for (int trial = 0; trial < 20; ++trial) {
+                std::string bad = packed;
+                for (std::uint64_t k = 1 + rng() % 3; k > 0; --k) bad[rng() % bad.size()] = static_cast<char>(rng());
+                if (LogCompression::decompress(bad.data(), bad.size(), data.size(), unpacked) &&
+                    unpacked.size() != data.size()) {
+                    std::cerr << "input " << i << ": corrupt block decodes to " << unpacked.size() << " bytes\n";
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::string readFile(const char* path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const char* path, const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    // everything CompressedLogReader returns for the file, and its error()
+    std::string readLog(const char* path, std::string& error) {
+        CompressedLogReader reader(path);
+        std::string all, block;
+        LogCompression::BlockFilter filter;
+        while (reader.nextBlock(block, filter)) all += block;
+        error = reader.error();
+        return all;
+    }
+
+    // file offsets where a block header starts, and the end of the file
+    std::vector<std::size_t> blockBoundaries(const std::string& file) {
+        std::vector<std::size_t> bounds;
+        std::size_t pos = LogCompression::kFileHeaderSize;
+        while (pos + LogCompression::kBlockHeaderSize <= file.size()) {
+            bounds.push_back(pos);
+            std::uint32_t size;
+            std::memcpy(&size, file.data() + pos + 8, 4);
+            pos += LogCompression::kBlockHeaderSize + size;
+        }
+        bounds.push_back(pos);
+        return bounds;
+    }
+
+    bool checkFile(std::uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::string data;
+        {
+            CompressedLogWriter writer(kTempPath, 4096);
+            if (!writer.isOpen()) {
+                std::cerr << writer.error() << "\n";
+                return false;
+            }
+            for (int i = 0; i < 200; ++i) {
+                std::string piece = randomInput(rng, 1500);
+                writer.write(piece.data(), piece.size());
+                data += piece;
+            }
+            writer.close();
+        }
+
+        const std::string file = readFile(kTempPath);
+        std::string error;
+        if (readLog(kTempPath, error) != data || !error.empty()) {
+            std::cerr << "log does not read back: " << error << "\n";
+            return false;
+        }
+
+        const std::vector<std::size_t> bounds = blockBoundaries(file);
+        bool ok = bounds.back() == file.size();
+        for (int trial = 0; ok && trial < 300; ++trial) {
+            std::size_t cut = LogCompression::kFileHeaderSize + rng() % (file.size() - LogCompression::kFileHeaderSize);
+            if (trial < 3) cut = bounds[rng() % bounds.size()];
+            writeFile(kTempPath, file.substr(0, cut));
+            std::string got = readLog(kTempPath, error);
+            bool atBoundary = std::find(bounds.begin(), bounds.end(), cut) != bounds.end();
+            if (data.compare(0, got.size(), got) != 0 || error.empty() == !atBoundary) {
+                std::cerr << "cut at " << cut << ": " << (error.empty() ? "no error" : error) << "\n";
+                ok = false;
+            }
+        }
+
+        // second block: unknown codec, then a size running past the end
+        const std::size_t header = bounds.size() > 2 ? bounds[1] : bounds[0];
+        std::string bad = file;
+        bad[header + 1] = 7;
+        writeFile(kTempPath, bad);
+        readLog(kTempPath, error);
+        if (error != "corrupt compressed block") {
+            std::cerr << "bad codec byte: " << (error.empty() ? "no error" : error) << "\n";
+            ok = false;
+        }
+
+        bad = file;
+        std::uint32_t size = 0xFFFFFF;
+        std::memcpy(&bad[header + 8], &size, 4);
+        writeFile(kTempPath, bad);
+        readLog(kTempPath, error);
+        if (error != "truncated block") {
+            std::cerr << "oversized block: " << (error.empty() ? "no error" : error) << "\n";
+            ok = false;
+        }
+
+        std::remove(kTempPath);
+        return ok;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t inputs = 2000;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--inputs" && hasValue) inputs = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--seed" && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "usage: LzCheck [--inputs N] [--seed S]\n";
+            return 2;
+        }
+    }
+
+    // every check runs; a failing one explains itself on stderr
+    bool ok = checkRoundTrip(inputs, seed);
+    ok = checkTruncation(inputs / 10, seed + 1) && ok;
+    ok = checkCorruption(inputs / 4, seed + 2) && ok;
+    ok = checkFile(seed + 3) && ok;
+    std::cout << (ok ? "PASS" : "FAIL") << ": " << inputs << " round trips, " << inputs / 10
+        << " truncated and " << inputs / 4 << " corrupted inputs, log file read-back\n";
+    return ok ? 0 : 1;
+}
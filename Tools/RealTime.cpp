@@ -0,0 +1,88 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "../FormationController.h"
+#include "../RealTimePacer.h"
+#include "../Scenario.h"
+#include "../Simulator.h"
+
+/**
+ * @brief:
+ *         Wall-clock paced run of a formation swarm (RealTimePacer).
+ *
+ * Flies N drones from a grid to a ring (swarmScenario()) with the full Simulator (network
+ * on, console output and logs off) at 1/dt steps per second times the
+ * real-time factor, then prints overruns, busy time and wake-up jitter.
+ * Use it to check that a swarm size holds a loop rate (default 1 kHz).
+ *
+ * Usage:
+ *   RealTime [--drones N] [--dt S] [--duration T] [--factor F]
+ *            [--policy catch-up|skip|slow-down] [--spin US]
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/RealTime.cpp RealTimePacer.cpp Scenario.cpp Simulator.cpp Drone.cpp FormationController.cpp ChaCha20.cpp LogCompression.cpp Metrics.cpp Profiler.cpp -pthread -o realtime
+ */
+
+namespace {
+
+    bool parsePolicy(const std::string& name, OverrunPolicy& out) {
+        if (name == "catch-up") out = OverrunPolicy::CatchUp;
+        else if (name == "skip") out = OverrunPolicy::Skip;
+        else if (name == "slow-down") out = OverrunPolicy::SlowDown;
+        else return false;
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t drones = 64;
+    double dt = 0.001;
+    double duration = 10.0;
+    PacingParams pacing;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--drones" && hasValue) drones = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--dt" && hasValue) dt = std::atof(argv[++i]);
+        else if (arg == "--duration" && hasValue) duration = std::atof(argv[++i]);
+        else if (arg == "--factor" && hasValue) pacing.realTimeFactor = std::atof(argv[++i]);
+        else if (arg == "--policy" && hasValue && parsePolicy(argv[i + 1], pacing.policy)) ++i;
+        else if (arg == "--spin" && hasValue) pacing.spinMicros = std::atof(argv[++i]);
+        else {
+            std::cerr << "usage: RealTime [--drones N] [--dt S] [--duration T] [--factor F]"
+                " [--policy catch-up|skip|slow-down] [--spin US]\n";
+            return 2;
+        }
+    }
+    if (dt <= 0.0 || pacing.realTimeFactor <= 0.0) {
+        std::cerr << "dt and factor must be positive\n";
+        return 2;
+    }
+
+    ScenarioParams scenario = swarmScenario(drones);
+    scenario.network.logPath.clear();
+    scenario.network.printEvents = false;
+    const World& world = scenario.world;
+    Simulator sim(world, scenario.network);
+
+    FormationController controller(scenario.stopRadius);
+    for (std::size_t i = 0; i < drones; ++i) {
+        int index = sim.droneIndex(sim.addDrone(scenario.drone, scenario.startPositions[i]));
+        controller.addDrone(index, scenario.targets[i], scenario.kP, scenario.kD, scenario.drone.mass);
+    }
+
+    RealTimePacer pacer(dt, pacing);
+    pacer.start();
+    for (double t = 0.0; t < duration; t += dt) {
+        controller.compute(sim.getDrones(), world.gravity);
+        sim.setDroneThrustForces(controller.droneIds(), controller.thrustX(),
+            controller.thrustY(), controller.size());
+        sim.step(dt);
+        pacer.wait();
+    }
+
+    std::cout << drones << " drones";
+    pacer.printSummary(std::cout);
+    return 0;
+}
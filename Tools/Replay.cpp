@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "../ReplayEngine.h"
+#include "../ShmFrameRing.h"
+#include "../SocketTelemetrySink.h"
+
+/**
+ * @brief:
+ *         Replays a recorded run (ReplayEngine) into the same outputs the
+ *         live simulator offers, so visualizers and analysis tools can be
+ *         pointed at a recording instead of a running simulation.
+ *
+ * Prints the number of frames, rows and comms events replayed and the
+ * achieved rate. With --speed 0 (the default) this measures how fast the
+ * logs can be read back.
+ *
+ * Usage:
+ *   Replay [simulation_log.csv] [--comms <comms_log.csv> | --no-comms]
+ *          [--speed X] [--from T] [--to T] [--stream <endpoint>] [--shm <name>]
+ *          [--print-comms]
+ *
+ * --from seeks to the step closest to simulation time T before starting;
+ * --to stops after the last frame at or before T.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/Replay.cpp ReplayEngine.cpp TelemetryLogReader.cpp ShmFrameRing.cpp SocketTelemetrySink.cpp Metrics.cpp Profiler.cpp -pthread -o replay
+ */
+
+namespace {
+
+    class CountingSink : public TelemetrySink {
+    public:
+        void publish(const TelemetryFrame& frame) override {
+            ++frames;
+            rows += frame.count;
+        }
+
+        std::uint64_t frames = 0;
+        std::uint64_t rows = 0;
+    };
+
+    class PrintingObserver : public CommsObserver {
+    public:
+        void onCommsEvent(const CommsEvent& e) override {
+            std::cout << e.time << ' ' << e.event << ' ' << e.from << " -> " << e.to
+                << " \"" << e.payload << "\"\n";
+        }
+    };
+}
+
+int main(int argc, char** argv) {
+    std::string telemetryPath = "simulation_log.csv";
+    std::string commsPath = "comms_log.csv";
+    std::string streamEndpoint, shmName;
+    double speed = 0.0;
+    double from = -1.0, to = 1e300;
+    bool printComms = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--comms" && hasValue) commsPath = argv[++i];
+        else if (arg == "--no-comms") commsPath.clear();
+        else if (arg == "--speed" && hasValue) speed = std::atof(argv[++i]);
+        else if (arg == "--from" && hasValue) from = std::atof(argv[++i]);
+        else if (arg == "--to" && hasValue) to = std::atof(argv[++i]);
+        else if (arg == "--stream" && hasValue) streamEndpoint = argv[++i];
+        else if (arg == "--shm" && hasValue) shmName = argv[++i];
+        else if (arg == "--print-comms") printComms = true;
+        else if (!arg.empty() && arg[0] != '-') telemetryPath = arg;
+        else {
+            std::cerr << "usage: Replay [simulation_log.csv] [--comms <path> | --no-comms] [--speed X]"
+                " [--from T] [--to T] [--stream <endpoint>] [--shm <name>] [--print-comms]\n";
+            return 2;
+        }
+    }
+
+    ReplayEngine replay(telemetryPath, commsPath);
+    if (!replay.isOpen()) {
+        std::cerr << replay.error() << "\n";
+        return 1;
+    }
+    replay.setSpeed(speed);
+
+    CountingSink counter;
+    replay.addTelemetrySink(counter);
+
+    PrintingObserver printer;
+    if (printComms) replay.addCommsObserver(printer);
+
+    std::unique_ptr<SocketTelemetrySink> stream;
+    if (!streamEndpoint.empty()) {
+        stream = std::make_unique<SocketTelemetrySink>(streamEndpoint);
+        if (!stream->isOpen()) {
+            std::cerr << stream->error() << "\n";
+            return 1;
+        }
+        replay.addTelemetrySink(*stream);
+    }
+
+    std::unique_ptr<ShmFrameRingWriter> shmRing;
+    if (!shmName.empty()) {
+        // size the ring for the largest frame in the log
+        TelemetryLogReader index(telemetryPath);
+        std::uint32_t capacity = 0;
+        TelemetryLogIndex::Entry e;
+        for (std::uint64_t s = replay.firstStep(); index.entry(s, e); ++s) capacity = std::max(capacity, e.count);
+        shmRing = std::make_unique<ShmFrameRingWriter>(shmName, static_cast<std::size_t>(capacity));
+        if (!shmRing->isOpen()) {
+            std::cerr << shmRing->error() << "\n";
+            return 1;
+        }
+        replay.addTelemetrySink(*shmRing);
+    }
+
+    if (from >= 0.0 && !replay.seekTime(from)) {
+        std::cerr << "cannot seek to t=" << from << "\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    replay.run(to);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (stream) stream->close();
+    if (shmRing) shmRing->close();
+
+    if (!replay.error().empty()) {
+        std::cerr << replay.error() << "\n";
+        return 1;
+    }
+
+    std::cerr << "replayed " << counter.frames << " frames (" << counter.rows << " rows) and "
+        << replay.commsEventsPublished() << " comms events in " << seconds << " s ("
+        << (seconds > 0.0 ? counter.frames / seconds : 0.0) << " frames/s)\n";
+    return 0;
+}
@@ -0,0 +1,210 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../ShmFrameRing.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * @brief:
+ *         Stress test and live observer for the shared-memory frame ring
+ *         (ShmFrameRing.h).
+ *
+ * Self-test (default): creates a ring, forks K reader processes that attach
+ * read-only, then publishes S frames of N drones as fast as possible. Every
+ * column value is a function of (step, drone index), so each reader checks
+ * every frame it copies for tearing. Prints per-reader frames/retries/torn
+ * counts and the writer's cost per publish next to a plain memcpy of the
+ * same bytes into a private buffer as large as the ring (a buffer that
+ * stays in cache would hide the cache misses every ring slot costs).
+ *
+ * Observer: --attach <name> prints the newest frame of a running simulator
+ * (started with --shm <name>) twice a second until it stops publishing.
+ *
+ * Usage:
+ *   ShmRingStress [--readers K] [--drones N] [--steps S]
+ *   ShmRingStress --attach /dronesim
+ *
+ * Build (from the repository root; add -lrt on glibc older than 2.34):
+ *   g++ -std=c++17 -O2 Tools/ShmRingStress.cpp ShmFrameRing.cpp Metrics.cpp Profiler.cpp -pthread -o shm_ring_stress
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double valueX(std::uint64_t step, std::size_t i) { return static_cast<double>(step) + static_cast<double>(i); }
+
+    int runReader(const std::string& name, std::uint64_t lastStep, int readyFd) {
+        ShmFrameRingReader reader(name);
+        char ok = reader.isOpen() ? 1 : 0;
+        if (write(readyFd, &ok, 1) != 1 || !ok) return 2;
+        close(readyFd);
+
+        ShmFrame frame;
+        std::uint64_t frames = 0;
+        std::uint64_t torn = 0;
+        std::uint64_t seen = 0;
+        while (seen < lastStep) {
+            if (!reader.readLatest(frame) || frame.step == seen) continue;
+            seen = frame.step;
+            ++frames;
+            for (std::size_t i = 0; i < frame.ids.size(); ++i) {
+                double x = valueX(frame.step, i);
+                if (frame.ids[i] != static_cast<int>(i) || frame.x[i] != x || frame.y[i] != -x
+                    || frame.vx[i] != 0.5 * x || frame.vy[i] != static_cast<double>(frame.step)) {
+                    ++torn;
+                    break;
+                }
+            }
+        }
+
+        std::cout << "reader " << getpid() << ": frames=" << frames
+            << " retries=" << reader.retries() << " torn=" << torn << std::endl;
+        return torn == 0 ? 0 : 1;
+    }
+
+    int runSelfTest(int readers, std::size_t drones, std::uint64_t steps) {
+        std::string name = "/dronesim-stress-" + std::to_string(getpid());
+        const std::size_t slots = 64;
+        ShmFrameRingWriter writer(name, drones, slots);
+        if (!writer.isOpen()) {
+            std::cerr << writer.error() << "\n";
+            return 1;
+        }
+
+        int pipeFds[2];
+        if (pipe(pipeFds) != 0) return 1;
+
+        std::vector<pid_t> children;
+        for (int r = 0; r < readers; ++r) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                close(pipeFds[0]);
+                std::_Exit(runReader(name, steps, pipeFds[1]));
+            }
+            children.push_back(pid);
+        }
+        close(pipeFds[1]);
+        for (int r = 0; r < readers; ++r) {
+            char ok = 0;
+            if (read(pipeFds[0], &ok, 1) != 1 || !ok) {
+                std::cerr << "reader failed to attach\n";
+            }
+        }
+        close(pipeFds[0]);
+
+        std::vector<int> ids(drones);
+        std::vector<double> x(drones), y(drones), vx(drones), vy(drones);
+        const std::size_t frameBytes = drones * (sizeof(std::int32_t) + 4 * sizeof(double));
+        std::vector<unsigned char> scratch(slots * frameBytes);
+
+        double publishNs = 0.0;
+        double memcpyNs = 0.0;
+        for (std::uint64_t step = 1; step <= steps; ++step) {
+            for (std::size_t i = 0; i < drones; ++i) {
+                ids[i] = static_cast<int>(i);
+                x[i] = valueX(step, i);
+                y[i] = -x[i];
+                vx[i] = 0.5 * x[i];
+                vy[i] = static_cast<double>(step);
+            }
+
+            TelemetryFrame frame;
+            frame.step = step;
+            frame.time = static_cast<double>(step) * 0.01;
+            frame.count = drones;
+            frame.ids = ids.data();
+            frame.x = x.data();
+            frame.y = y.data();
+            frame.vx = vx.data();
+            frame.vy = vy.data();
+
+            auto t0 = Clock::now();
+            writer.publish(frame);
+            auto t1 = Clock::now();
+
+            // baseline: the same bytes copied into private memory
+            unsigned char* p = scratch.data() + (step % slots) * frameBytes;
+            std::memcpy(p, ids.data(), drones * sizeof(std::int32_t)); p += drones * sizeof(std::int32_t);
+            std::memcpy(p, x.data(), drones * sizeof(double)); p += drones * sizeof(double);
+            std::memcpy(p, y.data(), drones * sizeof(double)); p += drones * sizeof(double);
+            std::memcpy(p, vx.data(), drones * sizeof(double)); p += drones * sizeof(double);
+            std::memcpy(p, vy.data(), drones * sizeof(double));
+            auto t2 = Clock::now();
+
+            publishNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+            memcpyNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+        }
+
+        int failures = 0;
+        for (pid_t pid : children) {
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ++failures;
+        }
+        writer.close();
+
+        std::cout << "writer: " << steps << " frames x " << drones << " drones, publish "
+            << publishNs / static_cast<double>(steps) << " ns/frame, plain memcpy "
+            << memcpyNs / static_cast<double>(steps) << " ns/frame\n";
+        std::cout << (failures == 0 ? "PASS" : "FAIL") << ": " << readers - failures
+            << "/" << readers << " readers saw no torn frames\n";
+        return failures == 0 ? 0 : 1;
+    }
+
+    int runObserver(const std::string& name) {
+        ShmFrameRingReader reader(name);
+        if (!reader.isOpen()) {
+            std::cerr << reader.error() << "\n";
+            return 1;
+        }
+
+        ShmFrame frame;
+        std::uint64_t lastStep = 0;
+        auto lastChange = Clock::now();
+        while (Clock::now() - lastChange < std::chrono::seconds(2)) {
+            if (reader.readLatest(frame) && frame.step != lastStep) {
+                lastStep = frame.step;
+                lastChange = Clock::now();
+                double cx = 0.0, cy = 0.0;
+                for (std::size_t i = 0; i < frame.x.size(); ++i) {
+                    cx += frame.x[i];
+                    cy += frame.y[i];
+                }
+                if (!frame.x.empty()) {
+                    cx /= static_cast<double>(frame.x.size());
+                    cy /= static_cast<double>(frame.x.size());
+                }
+                std::cout << "step=" << frame.step << " t=" << frame.time
+                    << " drones=" << frame.ids.size()
+                    << " centroid=(" << cx << ", " << cy << ")\n";
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+        std::cout << "no new frames for 2 s, retries=" << reader.retries() << "\n";
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    int readers = 4;
+    std::size_t drones = 10000;
+    std::uint64_t steps = 20000;
+    std::string attach;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--readers") readers = std::atoi(argv[i + 1]);
+        else if (opt == "--drones") drones = static_cast<std::size_t>(std::atol(argv[i + 1]));
+        else if (opt == "--steps") steps = static_cast<std::uint64_t>(std::atoll(argv[i + 1]));
+        else if (opt == "--attach") attach = argv[i + 1];
+    }
+
+    if (!attach.empty()) return runObserver(attach);
+    return runSelfTest(readers, drones, steps);
+}
@@ -0,0 +1,212 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../Network.h"
+#include "../SlotMap.h"
+
+/**
+ * @brief:
+ *         Churn test of the generational slot map (SlotMap.h) and of node
+ *         removal in the Network.
+ *
+ * Runs random inserts and erases (phases that grow, shrink and churn the
+ * population) against a dense element array mirrored the way Simulator
+ * does it (push_back on insert, swap-and-pop on erase), and checks after
+ * every operation:
+ *
+ * 1. Live handles: contains(), indexOf() points at the element inserted
+ *    with that handle (checked against a handle -> value map), handleAt()
+ *    maps the dense index back to the handle.
+ * 2. Stale handles: a sample of erased handles is not contained, indexOf()
+ *    is npos and erase() fails without changing anything, even after their
+ *    slot has been reused.
+ * 3. Handles are never issued twice, and slots are reused: the slot count
+ *    never exceeds the peak number of live elements.
+ *
+ * Then Network::removeNode() on a mesh-routed line of nodes: once a relay
+ * is removed no cached route leads to or through its index, and the
+ * newcomer that reuses the index is in none of the old node's multicast
+ * groups.
+ *
+ * Usage:
+ *   SlotMapCheck [--ops N] [--seed S]
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/SlotMapCheck.cpp ChaCha20.cpp LogCompression.cpp Metrics.cpp Profiler.cpp -pthread -o slot_map_check
+ */
+
+namespace {
+
+    struct Element {
+        SlotHandle handle;
+        std::uint64_t value;
+    };
+
+    struct Failures {
+        std::uint64_t live = 0;
+        std::uint64_t stale = 0;
+        std::uint64_t reuse = 0;
+    };
+
+    using Key = std::pair<std::uint32_t, std::uint32_t>;   // (index, generation)
+
+    // 'expected' is the reference model: live handle -> inserted value
+    void checkLive(const SlotMap& map, const std::vector<Element>& dense,
+        const std::map<Key, std::uint64_t>& expected, Failures& failures)
+    {
+        if (map.size() != dense.size() || map.size() != expected.size()) ++failures.live;
+        for (const auto& entry : expected) {
+            const SlotHandle h{ entry.first.first, entry.first.second };
+            std::size_t i = map.indexOf(h);
+            if (!map.contains(h) || i >= dense.size() || dense[i].value != entry.second || map.handleAt(i) != h) {
+                ++failures.live;
+            }
+        }
+    }
+
+    void checkStale(SlotMap& map, const std::vector<SlotHandle>& erased, std::mt19937_64& rng, Failures& failures) {
+        if (erased.empty()) return;
+        for (int k = 0; k < 8; ++k) {
+            const SlotHandle h = erased[rng() % erased.size()];
+            std::size_t removed = SlotMap::npos;
+            std::size_t moved = SlotMap::npos;
+            std::size_t size = map.size();
+            if (map.contains(h) || map.indexOf(h) != SlotMap::npos || map.erase(h, removed, moved) ||
+                map.size() != size || removed != SlotMap::npos || moved != SlotMap::npos) {
+                ++failures.stale;
+            }
+        }
+    }
+
+    bool run(std::uint64_t ops, std::uint64_t seed, Failures& failures) {
+        std::mt19937_64 rng(seed);
+        SlotMap map;
+        std::vector<Element> dense;
+        std::vector<SlotHandle> erased;
+        std::map<Key, std::uint64_t> expected;
+        std::set<Key> issued;
+        std::size_t peak = 0;
+        std::uint32_t maxSlot = 0;
+
+        const SlotHandle none;
+        if (map.contains(none) || map.indexOf(none) != SlotMap::npos) ++failures.stale;
+
+        for (std::uint64_t op = 0; op < ops; ++op) {
+            // phases of 1000 ops: grow (75% inserts), churn (50%), shrink (25%)
+            const std::uint64_t insertPercent = 25 + 25 * ((op / 1000) % 3);
+            const bool insert = dense.empty() || rng() % 100 < insertPercent;
+            if (insert) {
+                SlotHandle h = map.insert();
+                if (!issued.insert({ h.index, h.generation }).second) ++failures.reuse;
+                dense.push_back({ h, rng() });
+                expected[{ h.index, h.generation }] = dense.back().value;
+                if (h.index > maxSlot) maxSlot = h.index;
+            }
+            else {
+                std::size_t victim = rng() % dense.size();
+                SlotHandle h = dense[victim].handle;
+                std::size_t removed = 0;
+                std::size_t moved = 0;
+                if (!map.erase(h, removed, moved) || removed != victim || moved != dense.size() - 1) {
+                    ++failures.live;
+                    return false;
+                }
+                dense[removed] = dense[moved];
+                dense.pop_back();
+                expected.erase({ h.index, h.generation });
+                erased.push_back(h);
+            }
+            if (dense.size() > peak) peak = dense.size();
+
+            checkLive(map, dense, expected, failures);
+            checkStale(map, erased, rng, failures);
+        }
+        if (maxSlot >= peak && peak > 0) ++failures.reuse;
+        std::cout << ops << " ops, " << issued.size() << " handles issued, peak " << peak
+            << " live, " << maxSlot + 1 << " slots\n";
+        return true;
+    }
+
+    bool checkNodeRemoval() {
+        NetworkParams params;
+        params.baseLatency = 0.0;
+        params.jitter = 0.0;
+        params.dropProbability = 0.0;
+        params.seed = 1;
+        params.logPath = "";
+        params.printEvents = false;
+        Network net(params);
+        RadioLinkParams radio;
+        radio.edgeDropProbability = 0.0;
+        net.enableRadioLinks(radio);
+        net.enableMeshRouting();
+
+        // a line of nodes 20 m apart (range 30 m): every route but one hop relays
+        const int count = 8;
+        const int relay = 3;
+        std::vector<std::string> names;
+        for (int i = 0; i < count; ++i) {
+            names.push_back("N" + std::to_string(i));
+            net.addNode(names.back());
+            net.setNodePosition(i, Vector2(20.0 * i, 0.0));
+        }
+        net.createGroup("all", names);
+        for (int i = 0; i < count; ++i) {
+            for (int j = 0; j < count; ++j) {
+                if (i != j) net.sendMessage(names[i], names[j], "ping", 0.0);
+            }
+        }
+        net.step(1.0);
+
+        MeshRouter& router = *net.meshRouter();
+        const std::size_t before = router.routesVia(relay);
+        net.removeNode(names[relay]);
+        const std::size_t after = router.routesVia(relay) + router.cachedRoutes(relay);
+
+        // the newcomer takes the relay's index and place
+        net.addNode("Newcomer");
+        const int index = net.indexOf("Newcomer");
+        net.setNodePosition(index, Vector2(20.0 * relay, 0.0));
+        const std::size_t inboxBefore = net.nodeAt(relay - 1).inbox().size();
+        net.multicast(names[relay + 1], "all", "hello", 2.0);
+        net.step(3.0);
+        const bool groupOk = net.nodeAt(index).inbox().empty() &&
+            net.nodeAt(relay - 1).inbox().size() == inboxBefore;
+
+        std::cout << "node removal: " << before << " routes via the relay before, " << after
+            << " after; newcomer at index " << index << (groupOk ? " not" : "") << " in the old groups\n";
+        return before > 0 && after == 0 && index == relay && groupOk;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::uint64_t ops = 200000;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--ops" && hasValue) ops = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--seed" && hasValue) seed = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::cerr << "usage: SlotMapCheck [--ops N] [--seed S]\n";
+            return 2;
+        }
+    }
+
+    Failures failures;
+    bool ok = run(ops, seed, failures);
+    ok = ok && failures.live == 0 && failures.stale == 0 && failures.reuse == 0;
+    const bool nodesOk = checkNodeRemoval();
+    std::cout << (ok && nodesOk ? "PASS" : "FAIL") << ": " << failures.live << " live, " << failures.stale
+        << " stale and " << failures.reuse << " reuse mismatches, node removal "
+        << (nodesOk ? "clean" : "leaves stale routes or group members") << "\n";
+    ok = ok && nodesOk;
+    return ok ? 0 : 1;
+}
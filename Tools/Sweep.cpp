@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "../ParameterSweep.h"
+
+/**
+ * @brief:
+ *         Parameter sweep over the demo formation (ParameterSweep).
+ *
+ * Each --range adds one swept parameter: kP, kD, stopRadius,
+ * settleTolerance, dt, duration, latency, jitter or drop. Without --lhs
+ * the ranges form a grid ("steps" values each, ends included); with
+ * --lhs N, N Latin-hypercube points are drawn instead (steps ignored).
+ * Writes one CSV row per point and prints the fastest-converging point.
+ *
+ * Usage:
+ *   Sweep --range kP=0.2:1.0:5 --range kD=0.5:2.0:4 [--lhs N] [--repeats R]
+ *         [--seed S] [--threads N] [--duration T] [--batch W] [--out sweep.csv]
+ *
+ * --batch W scores the dynamics only, W runs per SIMD batch (WorldBatch);
+ * delivery and latency are then not measured.
+ * --duration defaults to 30 s so the demo formation can settle.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/Sweep.cpp ParameterSweep.cpp Scenario.cpp Simulator.cpp Drone.cpp FormationController.cpp ChaCha20.cpp WorkerPool.cpp WorldBatch.cpp LogCompression.cpp Metrics.cpp Profiler.cpp -pthread -o sweep
+ */
+
+namespace {
+
+    // "name=min:max[:steps]"
+    bool parseRange(const std::string& text, SweepRange& out) {
+        std::size_t eq = text.find('=');
+        if (eq == std::string::npos || eq == 0) return false;
+        out.name = text.substr(0, eq);
+        const char* p = text.c_str() + eq + 1;
+        char* end = nullptr;
+        out.min = std::strtod(p, &end);
+        if (end == p || *end != ':') return false;
+        p = end + 1;
+        out.max = std::strtod(p, &end);
+        if (end == p) return false;
+        out.steps = 2;
+        if (*end == ':') out.steps = static_cast<std::size_t>(std::strtoul(end + 1, &end, 10));
+        return *end == '\0' && out.steps > 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    SweepParams params;
+    params.base.duration = 30.0;
+    std::string outPath = "sweep.csv";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        SweepRange range;
+        if (arg == "--range" && hasValue && parseRange(argv[i + 1], range)) {
+            params.ranges.push_back(range);
+            ++i;
+        }
+        else if (arg == "--lhs" && hasValue) {
+            params.mode = SweepParams::Mode::LatinHypercube;
+            params.samples = static_cast<std::size_t>(std::atoll(argv[++i]));
+        }
+        else if (arg == "--repeats" && hasValue) params.repeats = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--seed" && hasValue) params.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--threads" && hasValue) params.threads = static_cast<std::size_t>(std::atoi(argv[++i]));
+        else if (arg == "--duration" && hasValue) params.base.duration = std::atof(argv[++i]);
+        else if (arg == "--batch" && hasValue) params.batchWorlds = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--out" && hasValue) outPath = argv[++i];
+        else {
+            std::cerr << "usage: Sweep --range name=min:max[:steps] ... [--lhs N] [--repeats R]"
+                " [--seed S] [--threads N] [--duration T] [--batch W] [--out sweep.csv]\n";
+            return 2;
+        }
+    }
+
+    ParameterSweep sweep(params);
+    std::string problem = sweep.validate();
+    if (!problem.empty()) {
+        std::cerr << problem << "\n";
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SweepPoint> results = sweep.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream out(outPath, std::ios::binary);
+    if (!out) {
+        std::cerr << "cannot write " << outPath << "\n";
+        return 1;
+    }
+    sweep.writeTable(out, results);
+
+    // fastest point that converged on every repeat (overshoot breaks ties)
+    const SweepPoint* best = nullptr;
+    for (const SweepPoint& point : results) {
+        if (point.converged != point.runs) continue;
+        if (!best || point.convergenceTime < best->convergenceTime
+            || (point.convergenceTime == best->convergenceTime && point.maxOvershoot < best->maxOvershoot)) {
+            best = &point;
+        }
+    }
+
+    std::size_t runs = results.empty() ? 0 : results.size() * results.front().runs;
+    std::cout << std::fixed << std::setprecision(3)
+        << results.size() << " points, " << runs << " runs in " << seconds << " s -> " << outPath << "\n";
+    if (best) {
+        std::cout << "fastest convergence: " << best->convergenceTime << " s (overshoot "
+            << best->maxOvershoot << " m, delivery " << best->deliveryRatio << ") at";
+        for (std::size_t d = 0; d < params.ranges.size(); ++d) {
+            std::cout << " " << params.ranges[d].name << "=" << best->values[d];
+        }
+        std::cout << "\n";
+    }
+    else {
+        std::cout << "no point converged on every run\n";
+    }
+    return 0;
+}
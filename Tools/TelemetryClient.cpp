@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TelemetryProtocol.h"
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/**
+ * @brief:
+ *         Reference client for the live telemetry stream
+ *         (SocketTelemetrySink, protocol in TelemetryProtocol.h).
+ *
+ * Connects to the simulator, reads frames back to back and prints one line
+ * every N frames with the step, time, drone count and swarm centroid, plus
+ * how many steps were skipped because the client fell behind.
+ *
+ * Usage:
+ *   TelemetryClient <unix:/path.sock | tcp:port> [--every N] [--delay-ms M]
+ *
+ * --delay-ms sleeps after every frame to emulate a slow consumer, which
+ * makes the server-side frame dropping visible as step gaps.
+ *
+ * Build (from the repository root):
+ *   g++ -std=c++17 -O2 Tools/TelemetryClient.cpp -o telemetry_client
+ */
+
+namespace {
+
+    int connectTo(const std::string& endpoint) {
+        if (endpoint.compare(0, 5, "unix:") == 0) {
+            std::string path = endpoint.substr(5);
+            sockaddr_un addr{};
+            if (path.size() >= sizeof(addr.sun_path)) return -1;
+            addr.sun_family = AF_UNIX;
+            std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+            int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        if (endpoint.compare(0, 4, "tcp:") == 0) {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<std::uint16_t>(std::atoi(endpoint.c_str() + 4)));
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            int fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+        return -1;
+    }
+
+    // reads exactly 'size' bytes; false on EOF/error
+    bool readFully(int fd, char* out, std::size_t size) {
+        std::size_t got = 0;
+        while (got < size) {
+            ssize_t n = read(fd, out + got, size - got);
+            if (n <= 0) return false;
+            got += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <unix:/path.sock | tcp:port> [--every N] [--delay-ms M]\n";
+        return 1;
+    }
+
+    std::string endpoint = argv[1];
+    int every = 100;
+    int delayMs = 0;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string opt = argv[i];
+        if (opt == "--every") every = std::max(1, std::atoi(argv[i + 1]));
+        else if (opt == "--delay-ms") delayMs = std::atoi(argv[i + 1]);
+    }
+
+    int fd = connectTo(endpoint);
+    if (fd < 0) {
+        std::cerr << "cannot connect to " << endpoint << "\n";
+        return 1;
+    }
+
+    std::vector<char> frame;
+    std::uint64_t frames = 0;
+    std::uint64_t skipped = 0;
+    std::uint64_t lastStep = 0;
+    std::cout << std::fixed << std::setprecision(3);
+
+    char header[TelemetryProtocol::kHeaderSize];
+    while (readFully(fd, header, sizeof(header))) {
+        TelemetryProtocol::Header h;
+        if (!TelemetryProtocol::parseHeader(header, sizeof(header), h)) {
+            std::cerr << "protocol error: bad frame header\n";
+            break;
+        }
+
+        std::size_t size = TelemetryProtocol::frameSize(h.count);
+        frame.resize(size);
+        std::memcpy(frame.data(), header, sizeof(header));
+        if (!readFully(fd, frame.data() + sizeof(header), size - sizeof(header))) break;
+
+        if (lastStep != 0 && h.step > lastStep + 1) skipped += h.step - lastStep - 1;
+        lastStep = h.step;
+        ++frames;
+
+        if (frames % static_cast<std::uint64_t>(every) == 1 || every == 1) {
+            const char* xs = frame.data() + TelemetryProtocol::columnOffset(h.count, 1);
+            const char* ys = frame.data() + TelemetryProtocol::columnOffset(h.count, 2);
+            double cx = 0.0, cy = 0.0;
+            for (std::uint32_t i = 0; i < h.count; ++i) {
+                cx += TelemetryProtocol::get<double>(xs + 8 * i);
+                cy += TelemetryProtocol::get<double>(ys + 8 * i);
+            }
+            if (h.count > 0) {
+                cx /= h.count;
+                cy /= h.count;
+            }
+            std::cout << "step=" << h.step << " t=" << h.time << " drones=" << h.count
+                << " centroid=(" << cx << ", " << cy << ")"
+                << " frames=" << frames << " skipped=" << skipped << "\n";
+        }
+
+        if (delayMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+    }
+
+    std::cout << "stream closed: " << frames << " frames received, "
+        << skipped << " steps skipped\n";
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+#include <cstddef>
+
+/*
+* @class:
+*        Vector<N>
+* @brief:
+*        N-dimensional vector used by the dimension-generic physics code.
+*
+* Only the 2D and 3D specializations exist (Vector2.h, Vector3.h). Both offer the
+* same interface — component access by index, +, +=, -, *, *=, length() and
+* normalized() — so BasicDrone, BasicWorld and BasicFormationController are written
+* once for both.
+*
+* kDimensions is the number of meaningful components; kLanes the number of doubles
+* actually stored. A Vector3 is padded to four lanes (32 bytes, 32-byte aligned) so
+* its arithmetic maps onto a single 256-bit SIMD register.
+*/
+
+template <std::size_t N>
+class Vector;
+
+#endif // VECTOR_H
@@ -2,6 +2,13 @@
 #define VECTOR2_H
 
 #include <cmath>
+#include <cstddef>
+#include "Vector.h"
+
+template <>
+class Vector<2>;
+
+using Vector2 = Vector<2>;
 
 /*
 * @class: 
@@ -15,12 +22,19 @@
 * collisions response).
 * 
 * All operations assume standard geometry.
+*
+* Vector2 is the 2D specialization of Vector<N> (see Vector.h).
 */
 
-class Vector2 {
+template <>
+class Vector<2> {
 
 public:
 
+    static constexpr std::size_t kDimensions = 2;
+
+    static constexpr std::size_t kLanes = 2;
+
     /*
     * @brief:
     *         The x-component of the vector.
@@ -44,7 +58,7 @@ public:
     *         Value of the y-component.
     */
 
-    Vector2() : x(0.0), y(0.0) {}
+    Vector() : x(0.0), y(0.0) {}
 
     /*
     * @brief:
@@ -55,7 +69,16 @@ public:
     *         Value of the y-component.
     */
 
-    Vector2(double xVal, double yVal) : x(xVal), y(yVal) {}
+    Vector(double xVal, double yVal) : x(xVal), y(yVal) {}
+
+    /*
+    * @brief:
+    *         Component access by axis (0 = x, 1 = y), for dimension-generic code.
+    */
+
+    double& operator[](std::size_t axis) { return axis == 0 ? x : y; }
+
+    double operator[](std::size_t axis) const { return axis == 0 ? x : y; }
 
     /*
     * @brief:
@@ -126,7 +149,7 @@ public:
     /*
     * @brief:
     *         Computes the magnitude (length) of the vector.
-    * @return: The Euclidean length sqrt(x + y).
+    * @return: The Euclidean length sqrt(x² + y²).
     */
 
     double length() const {
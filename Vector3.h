@@ -0,0 +1,121 @@
+#ifndef VECTOR3_H
+#define VECTOR3_H
+
+#include <cmath>
+#include <cstddef>
+#include "Vector.h"
+
+template <>
+class Vector<3>;
+
+using Vector3 = Vector<3>;
+
+/*
+* @class:
+*        Vector3
+* @brief:
+*        A 3D vector for the 3D mode (x, y horizontal; z is altitude).
+*
+* Same interface as Vector2. The vector is padded with a fourth lane, w, that is
+* always zero, and aligned to 32 bytes: every operation works on all four lanes
+* so compilers emit a single 256-bit instruction per operation with AVX (and two
+* 128-bit ones without), instead of a scalar tail for the odd third component.
+*/
+
+template <>
+class alignas(32) Vector<3> {
+
+public:
+
+    static constexpr std::size_t kDimensions = 3;
+
+    static constexpr std::size_t kLanes = 4;
+
+    double x;
+
+    double y;
+
+    double z;
+
+    /*
+    * @brief:
+    *         Padding lane, kept at zero.
+    */
+
+    double w;
+
+    /*
+    * @brief:
+    *         Constructs a zero vector (0,0,0).
+    */
+
+    Vector() : x(0.0), y(0.0), z(0.0), w(0.0) {}
+
+    /*
+    * @brief:
+    *         Constructs a vector with given components.
+    */
+
+    Vector(double xVal, double yVal, double zVal) : x(xVal), y(yVal), z(zVal), w(0.0) {}
+
+    /*
+    * @brief:
+    *         Component access by axis (0 = x, 1 = y, 2 = z).
+    */
+
+    double& operator[](std::size_t axis) { return axis == 0 ? x : axis == 1 ? y : z; }
+
+    double operator[](std::size_t axis) const { return axis == 0 ? x : axis == 1 ? y : z; }
+
+    Vector3 operator+(const Vector3& other) const {
+        Vector3 r;
+        r.x = x + other.x; r.y = y + other.y; r.z = z + other.z; r.w = w + other.w;
+        return r;
+    }
+
+    Vector3& operator+=(const Vector3& other) {
+        x += other.x; y += other.y; z += other.z; w += other.w;
+        return *this;
+    }
+
+    Vector3 operator-(const Vector3& other) const {
+        Vector3 r;
+        r.x = x - other.x; r.y = y - other.y; r.z = z - other.z; r.w = w - other.w;
+        return r;
+    }
+
+    Vector3 operator*(double scalar) const {
+        Vector3 r;
+        r.x = x * scalar; r.y = y * scalar; r.z = z * scalar; r.w = w * scalar;
+        return r;
+    }
+
+    Vector3& operator*=(double scalar) {
+        x *= scalar; y *= scalar; z *= scalar; w *= scalar;
+        return *this;
+    }
+
+    /*
+    * @return: The Euclidean length sqrt(x² + y² + z²).
+    */
+
+    double length() const {
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    /*
+    * @return: A unit-length copy, or (0,0,0) for the zero vector.
+    */
+
+    Vector3 normalized() const {
+        double len = length();
+        if (len == 0.0) {
+            return Vector3();
+        }
+        Vector3 r;
+        r.x = x / len; r.y = y / len; r.z = z / len; r.w = w / len;
+        return r;
+    }
+};
+
+#endif // VECTOR3_H
@@ -0,0 +1,73 @@
+#include "WorkerPool.h"
+
+/*
+ * @brief:
+ *         Starts threads - 1 pool threads (the caller of run() is the
+ *         remaining worker).
+ */
+
+WorkerPool::WorkerPool(std::size_t threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    for (std::size_t w = 1; w < threads; ++w) {
+        mThreads.emplace_back(&WorkerPool::workerLoop, this, w);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (auto& t : mThreads) t.join();
+}
+
+void WorkerPool::drain(std::size_t worker) {
+    for (;;) {
+        std::size_t task = mNext.fetch_add(1, std::memory_order_relaxed);
+        if (task >= mTasks) return;
+        (*mJob)(task, worker);
+    }
+}
+
+void WorkerPool::run(std::size_t tasks, const std::function<void(std::size_t, std::size_t)>& fn) {
+    if (tasks == 0) return;
+    if (mThreads.empty() || tasks == 1) {
+        for (std::size_t t = 0; t < tasks; ++t) fn(t, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJob = &fn;
+        mTasks = tasks;
+        mNext.store(0, std::memory_order_relaxed);
+        mActive = mThreads.size();
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this] { return mActive == 0; });
+    mJob = nullptr;
+}
+
+void WorkerPool::workerLoop(std::size_t worker) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [&] { return mStop || mGeneration != seen; });
+            if (mStop) return;
+            seen = mGeneration;
+        }
+
+        drain(worker);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (--mActive == 0) mDone.notify_one();
+    }
+}
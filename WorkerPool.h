@@ -0,0 +1,82 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * @class:
+ *         WorkerPool
+ * @brief:
+ *         Fixed set of threads that run batches of independent tasks.
+ *
+ * run() hands out task indices [0, tasks) to the pool threads and the
+ * calling thread, which takes part as worker 0, and returns when every
+ * task has finished. Tasks are claimed one at a time from a shared
+ * counter, so uneven tasks balance themselves. The threads sleep between
+ * batches and live as long as the pool.
+ */
+
+class WorkerPool {
+public:
+
+    /*
+     * @param: threads
+     *         Total workers including the caller of run(); 0 means one per
+     *         hardware thread. A pool of 1 runs everything on the caller.
+     */
+
+    explicit WorkerPool(std::size_t threads);
+
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /*
+     * @brief:
+     *         Number of workers (pool threads + the caller).
+     */
+
+    std::size_t size() const { return mThreads.size() + 1; }
+
+    /*
+     * @brief:
+     *         Runs fn(task, worker) for every task in [0, tasks) and waits
+     *         for all of them.
+     *
+     * @param: tasks
+     *         Number of tasks.
+     * @param: fn
+     *         Task body; 'worker' is in [0, size()) and is unique among
+     *         tasks running at the same time, so it can index per-worker
+     *         scratch state.
+     */
+
+    void run(std::size_t tasks, const std::function<void(std::size_t task, std::size_t worker)>& fn);
+
+private:
+    void workerLoop(std::size_t worker);
+
+    void drain(std::size_t worker);
+
+    std::vector<std::thread> mThreads;
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+
+    const std::function<void(std::size_t, std::size_t)>* mJob = nullptr;
+    std::size_t mTasks = 0;
+    std::atomic<std::size_t> mNext{ 0 };
+    std::size_t mActive = 0;
+    std::uint64_t mGeneration = 0;
+    bool mStop = false;
+};
+
+#endif // WORKER_POOL_H
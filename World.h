@@ -1,7 +1,15 @@
 #ifndef WORLD_H
 #define WORLD_H
 
+#include <cstddef>
 #include "Vector2.h"
+#include "Vector3.h"
+
+template <std::size_t N>
+class BasicWorld;
+
+using World = BasicWorld<2>;
+using World3 = BasicWorld<3>;
 
 /*
 * @class:
@@ -21,15 +29,19 @@
 * @notes:
 * This class does not enforce boundary checking. It only stores the values. Collisions or 
 * boundaries enforcement is handled in Vector2.  
+*
+* World is BasicWorld<2>; World3 below is the 3D counterpart. Both expose
+* extent(axis) so dimension-generic physics can clamp to the bounds.
 */
-class World {
+template <>
+class BasicWorld<2> {
 public:
 
     /*
     * @brief:
     *         Gravity vector applied globally to all physics bodies.
     * 
-    * Units are assumed to be meters per second (m/s).
+    * Units are assumed to be meters per second (m/s²).
     * Default is Earth's gravitational acceleration (0, -9.8)
     */
 
@@ -61,7 +73,7 @@ public:
     * World size of 100m x 100m
     */
 
-    World()
+    BasicWorld()
         : gravity(0.0, -9.8),
         width(100.0),
         height(100.0) {
@@ -79,9 +91,59 @@ public:
     *        World height in meters. 
     */
 
-    World(const Vector2& gravityVal, double w, double h)
+    BasicWorld(const Vector2& gravityVal, double w, double h)
         : gravity(gravityVal), width(w), height(h) {
     }
+
+    /*
+    * @return: Size of the world along an axis (0 = width, 1 = height).
+    */
+
+    double extent(std::size_t axis) const { return axis == 0 ? width : height; }
+};
+
+/*
+* @class:
+*        World3
+* @brief:
+*        3D world settings: gravity and an axis-aligned box from the origin.
+*
+* x spans the width, y the depth and z the height; z is altitude, so the
+* default gravity is (0, 0, -9.8).
+*/
+template <>
+class BasicWorld<3> {
+public:
+
+    Vector3 gravity;
+
+    double width;   // x extent (m)
+
+    double depth;   // y extent (m)
+
+    double height;  // z extent, altitude (m)
+
+    /*
+    * @brief:
+    *         Default constructor: Earth gravity along -z, 100m x 100m x 100m.
+    */
+
+    BasicWorld()
+        : gravity(0.0, 0.0, -9.8),
+        width(100.0),
+        depth(100.0),
+        height(100.0) {
+    }
+
+    BasicWorld(const Vector3& gravityVal, double w, double d, double h)
+        : gravity(gravityVal), width(w), depth(d), height(h) {
+    }
+
+    /*
+    * @return: Size of the world along an axis (0 = width, 1 = depth, 2 = height).
+    */
+
+    double extent(std::size_t axis) const { return axis == 0 ? width : axis == 1 ? depth : height; }
 };
 
 #endif // WORLD_H
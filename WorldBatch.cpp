@@ -0,0 +1,285 @@
+#include "WorldBatch.h"
+#include <algorithm>
+#include <cmath>
+#include "Profiler.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+WorldBatch::WorldBatch(std::size_t drones, std::size_t worlds)
+    : mDrones(drones),
+    mWorlds(worlds),
+    mLanes((worlds + kLanes - 1) / kLanes * kLanes)
+{
+    const std::size_t n = mDrones * mLanes;
+    for (std::vector<double>* v : { &mPosX, &mPosY, &mVelX, &mVelY, &mTargetX, &mTargetY, &mArrived }) {
+        v->assign(n, 0.0);
+    }
+    for (std::vector<double>* v : { &mKp, &mKd, &mStopRadius, &mSettleRadius, &mMass, &mInvMass,
+        &mGravityX, &mGravityY, &mMaxThrust, &mMaxSpeed, &mWidth, &mHeight, &mAllInside, &mOvershoot }) {
+        v->assign(mLanes, 0.0);
+    }
+    mConvergedAt.assign(mLanes, -1.0);
+}
+
+void WorldBatch::setWorld(std::size_t world, const World& settings, const DroneParams& drone,
+    double kP, double kD, double stopRadius, double settleTolerance) {
+    mKp[world] = kP;
+    mKd[world] = kD;
+    mStopRadius[world] = stopRadius;
+    mSettleRadius[world] = stopRadius + settleTolerance;
+    mMass[world] = drone.mass;
+    mInvMass[world] = 1.0 / drone.mass;
+    mGravityX[world] = settings.gravity.x;
+    mGravityY[world] = settings.gravity.y;
+    mMaxThrust[world] = drone.maxThrust;
+    mMaxSpeed[world] = drone.maxSpeed;
+    mWidth[world] = settings.width;
+    mHeight[world] = settings.height;
+}
+
+void WorldBatch::setDrone(std::size_t world, std::size_t drone, const Vector2& start, const Vector2& target) {
+    const std::size_t i = drone * mLanes + world;
+    mPosX[i] = start.x;
+    mPosY[i] = start.y;
+    mVelX[i] = 0.0;
+    mVelY[i] = 0.0;
+    mTargetX[i] = target.x;
+    mTargetY[i] = target.y;
+}
+
+void WorldBatch::setScenario(std::size_t world, const ScenarioParams& scenario) {
+    setWorld(world, scenario.world, scenario.drone, scenario.kP, scenario.kD,
+        scenario.stopRadius, scenario.settleTolerance);
+    for (std::size_t d = 0; d < mDrones; ++d) {
+        setDrone(world, d, scenario.startPositions[d], scenario.targets[d]);
+    }
+}
+
+/*
+ * @brief:
+ *         Fills the padding lanes with copies of world 0 so they stay finite.
+ */
+
+void WorldBatch::padLanes() {
+    mPadded = true;
+    if (mWorlds == 0) return;
+    for (std::size_t w = mWorlds; w < mLanes; ++w) {
+        for (std::vector<double>* v : { &mKp, &mKd, &mStopRadius, &mSettleRadius, &mMass, &mInvMass,
+            &mGravityX, &mGravityY, &mMaxThrust, &mMaxSpeed, &mWidth, &mHeight }) {
+            (*v)[w] = (*v)[0];
+        }
+        for (std::size_t d = 0; d < mDrones; ++d) {
+            for (std::vector<double>* v : { &mPosX, &mPosY, &mVelX, &mVelY, &mTargetX, &mTargetY }) {
+                (*v)[d * mLanes + w] = (*v)[d * mLanes];
+            }
+        }
+    }
+}
+
+/*
+ * @brief:
+ *         One lockstep step of every world.
+ *
+ * Per drone slot, in the order a Simulator run performs them:
+ *   control  (FormationController): PD force with gravity compensation,
+ *            zero inside stopRadius
+ *   thrust   (Drone::setThrustForce): clamp |F| to maxThrust
+ *   physics  (Drone::update): semi-implicit Euler, speed clamp, bounds
+ *   tracking (runScenario): arrival, overshoot and settled flags
+ */
+
+void WorldBatch::step(double dt) {
+    PROFILE_SCOPE("WorldBatch::step");
+    if (!mPadded) padLanes();
+    std::fill(mAllInside.begin(), mAllInside.end(), 1.0);
+
+    for (std::size_t d = 0; d < mDrones; ++d) {
+        double* px = &mPosX[d * mLanes];
+        double* py = &mPosY[d * mLanes];
+        double* vx = &mVelX[d * mLanes];
+        double* vy = &mVelY[d * mLanes];
+        const double* tx = &mTargetX[d * mLanes];
+        const double* ty = &mTargetY[d * mLanes];
+        double* arrived = &mArrived[d * mLanes];
+        std::size_t w = 0;
+
+#if defined(__AVX__)
+        const __m256d vDt = _mm256_set1_pd(dt);
+        const __m256d vZero = _mm256_setzero_pd();
+        const __m256d vOne = _mm256_set1_pd(1.0);
+
+        for (; w + 4 <= mLanes; w += 4) {
+            __m256d x = _mm256_loadu_pd(px + w), y = _mm256_loadu_pd(py + w);
+            __m256d u = _mm256_loadu_pd(vx + w), v = _mm256_loadu_pd(vy + w);
+            __m256d tX = _mm256_loadu_pd(tx + w), tY = _mm256_loadu_pd(ty + w);
+            __m256d m = _mm256_loadu_pd(&mMass[w]);
+            __m256d gx = _mm256_loadu_pd(&mGravityX[w]), gy = _mm256_loadu_pd(&mGravityY[w]);
+
+            // control
+            __m256d dx = _mm256_sub_pd(tX, x), dy = _mm256_sub_pd(tY, y);
+            __m256d dist = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+            __m256d kP = _mm256_loadu_pd(&mKp[w]), kD = _mm256_loadu_pd(&mKd[w]);
+            __m256d ax = _mm256_sub_pd(_mm256_mul_pd(dx, kP), _mm256_mul_pd(u, kD));
+            __m256d ay = _mm256_sub_pd(_mm256_mul_pd(dy, kP), _mm256_mul_pd(v, kD));
+            __m256d active = _mm256_cmp_pd(dist, _mm256_loadu_pd(&mStopRadius[w]), _CMP_GT_OQ);
+            __m256d fx = _mm256_and_pd(_mm256_sub_pd(_mm256_mul_pd(ax, m), _mm256_mul_pd(gx, m)), active);
+            __m256d fy = _mm256_and_pd(_mm256_sub_pd(_mm256_mul_pd(ay, m), _mm256_mul_pd(gy, m)), active);
+
+            // thrust clamp
+            __m256d maxThrust = _mm256_loadu_pd(&mMaxThrust[w]);
+            __m256d mag = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(fx, fx), _mm256_mul_pd(fy, fy)));
+            __m256d clamp = _mm256_and_pd(_mm256_cmp_pd(mag, vZero, _CMP_NEQ_OQ), _mm256_cmp_pd(mag, maxThrust, _CMP_GT_OQ));
+            __m256d thrustScale = _mm256_div_pd(maxThrust, mag);
+            fx = _mm256_blendv_pd(fx, _mm256_mul_pd(fx, thrustScale), clamp);
+            fy = _mm256_blendv_pd(fy, _mm256_mul_pd(fy, thrustScale), clamp);
+
+            // physics
+            __m256d invMass = _mm256_loadu_pd(&mInvMass[w]);
+            __m256d accX = _mm256_mul_pd(_mm256_add_pd(fx, _mm256_mul_pd(gx, m)), invMass);
+            __m256d accY = _mm256_mul_pd(_mm256_add_pd(fy, _mm256_mul_pd(gy, m)), invMass);
+            u = _mm256_add_pd(u, _mm256_mul_pd(accX, vDt));
+            v = _mm256_add_pd(v, _mm256_mul_pd(accY, vDt));
+
+            __m256d maxSpeed = _mm256_loadu_pd(&mMaxSpeed[w]);
+            __m256d speed = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(u, u), _mm256_mul_pd(v, v)));
+            __m256d limit = _mm256_and_pd(_mm256_cmp_pd(maxSpeed, vZero, _CMP_GT_OQ), _mm256_cmp_pd(speed, maxSpeed, _CMP_GT_OQ));
+            __m256d speedScale = _mm256_div_pd(maxSpeed, speed);
+            u = _mm256_blendv_pd(u, _mm256_mul_pd(u, speedScale), limit);
+            v = _mm256_blendv_pd(v, _mm256_mul_pd(v, speedScale), limit);
+
+            x = _mm256_add_pd(x, _mm256_mul_pd(u, vDt));
+            y = _mm256_add_pd(y, _mm256_mul_pd(v, vDt));
+
+            __m256d below = _mm256_cmp_pd(x, vZero, _CMP_LT_OQ);
+            x = _mm256_blendv_pd(x, vZero, below);
+            u = _mm256_blendv_pd(u, vZero, below);
+            below = _mm256_cmp_pd(y, vZero, _CMP_LT_OQ);
+            y = _mm256_blendv_pd(y, vZero, below);
+            v = _mm256_blendv_pd(v, vZero, below);
+            __m256d width = _mm256_loadu_pd(&mWidth[w]), height = _mm256_loadu_pd(&mHeight[w]);
+            __m256d above = _mm256_cmp_pd(x, width, _CMP_GT_OQ);
+            x = _mm256_blendv_pd(x, width, above);
+            u = _mm256_blendv_pd(u, vZero, above);
+            above = _mm256_cmp_pd(y, height, _CMP_GT_OQ);
+            y = _mm256_blendv_pd(y, height, above);
+            v = _mm256_blendv_pd(v, vZero, above);
+
+            _mm256_storeu_pd(px + w, x);
+            _mm256_storeu_pd(py + w, y);
+            _mm256_storeu_pd(vx + w, u);
+            _mm256_storeu_pd(vy + w, v);
+
+            // tracking
+            dx = _mm256_sub_pd(tX, x);
+            dy = _mm256_sub_pd(tY, y);
+            dist = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)));
+            __m256d arrivedNow = _mm256_or_pd(
+                _mm256_cmp_pd(_mm256_loadu_pd(arrived + w), vOne, _CMP_EQ_OQ),
+                _mm256_cmp_pd(dist, _mm256_loadu_pd(&mStopRadius[w]), _CMP_LT_OQ));
+            _mm256_storeu_pd(arrived + w, _mm256_and_pd(arrivedNow, vOne));
+            _mm256_storeu_pd(&mOvershoot[w],
+                _mm256_max_pd(_mm256_loadu_pd(&mOvershoot[w]), _mm256_and_pd(dist, arrivedNow)));
+            __m256d settled = _mm256_cmp_pd(dist, _mm256_loadu_pd(&mSettleRadius[w]), _CMP_LT_OQ);
+            _mm256_storeu_pd(&mAllInside[w], _mm256_and_pd(_mm256_loadu_pd(&mAllInside[w]), settled));
+        }
+#endif
+
+        // Scalar path (non-AVX builds). Branch-free so it can auto-vectorize.
+        for (; w < mLanes; ++w) {
+            const double m = mMass[w];
+            double dx = tx[w] - px[w];
+            double dy = ty[w] - py[w];
+            double dist = std::sqrt(dx * dx + dy * dy);
+            double ax = dx * mKp[w] - vx[w] * mKd[w];
+            double ay = dy * mKp[w] - vy[w] * mKd[w];
+            double active = (dist > mStopRadius[w]) ? 1.0 : 0.0;
+            double fx = (ax * m - mGravityX[w] * m) * active;
+            double fy = (ay * m - mGravityY[w] * m) * active;
+
+            double mag = std::sqrt(fx * fx + fy * fy);
+            bool clamp = mag != 0.0 && mag > mMaxThrust[w];
+            double thrustScale = mMaxThrust[w] / mag;
+            fx = clamp ? fx * thrustScale : fx;
+            fy = clamp ? fy * thrustScale : fy;
+
+            double u = vx[w] + (fx + mGravityX[w] * m) * mInvMass[w] * dt;
+            double v = vy[w] + (fy + mGravityY[w] * m) * mInvMass[w] * dt;
+            double speed = std::sqrt(u * u + v * v);
+            bool limit = mMaxSpeed[w] > 0.0 && speed > mMaxSpeed[w];
+            double speedScale = mMaxSpeed[w] / speed;
+            u = limit ? u * speedScale : u;
+            v = limit ? v * speedScale : v;
+
+            double x = px[w] + u * dt;
+            double y = py[w] + v * dt;
+            if (x < 0.0) { x = 0.0; u = 0.0; }
+            if (y < 0.0) { y = 0.0; v = 0.0; }
+            if (x > mWidth[w]) { x = mWidth[w]; u = 0.0; }
+            if (y > mHeight[w]) { y = mHeight[w]; v = 0.0; }
+            px[w] = x;
+            py[w] = y;
+            vx[w] = u;
+            vy[w] = v;
+
+            dx = tx[w] - x;
+            dy = ty[w] - y;
+            dist = std::sqrt(dx * dx + dy * dy);
+            if (dist < mStopRadius[w]) arrived[w] = 1.0;
+            if (arrived[w] == 1.0) mOvershoot[w] = std::max(mOvershoot[w], dist);
+            if (!(dist < mSettleRadius[w])) mAllInside[w] = 0.0;
+        }
+    }
+
+    mTime += dt;
+    for (std::size_t w = 0; w < mLanes; ++w) {
+        if (mAllInside[w] == 0.0) mConvergedAt[w] = -1.0;
+        else if (mConvergedAt[w] < 0.0) mConvergedAt[w] = mTime;
+    }
+}
+
+Vector2 WorldBatch::position(std::size_t world, std::size_t drone) const {
+    return Vector2(mPosX[drone * mLanes + world], mPosY[drone * mLanes + world]);
+}
+
+Vector2 WorldBatch::velocity(std::size_t world, std::size_t drone) const {
+    return Vector2(mVelX[drone * mLanes + world], mVelY[drone * mLanes + world]);
+}
+
+void runScenarioBatch(const ScenarioParams* scenarios, std::size_t count,
+    ScenarioResult* results, std::size_t worldsPerBatch) {
+    if (worldsPerBatch == 0) worldsPerBatch = 1;
+
+    std::size_t first = 0;
+    while (first < count) {
+        const ScenarioParams& lead = scenarios[first];
+        const std::size_t drones = std::min(lead.startPositions.size(), lead.targets.size());
+
+        std::size_t last = first + 1;
+        while (last < count && last - first < worldsPerBatch
+            && std::min(scenarios[last].startPositions.size(), scenarios[last].targets.size()) == drones
+            && scenarios[last].dt == lead.dt && scenarios[last].duration == lead.duration) {
+            ++last;
+        }
+
+        WorldBatch batch(drones, last - first);
+        for (std::size_t s = first; s < last; ++s) batch.setScenario(s - first, scenarios[s]);
+
+        // same clock as runScenario(), so step counts match
+        std::uint64_t steps = 0;
+        for (double time = 0.0; time < lead.duration; time += lead.dt) {
+            batch.step(lead.dt);
+            ++steps;
+        }
+
+        for (std::size_t s = first; s < last; ++s) {
+            ScenarioResult& result = results[s];
+            result = ScenarioResult();
+            result.convergenceTime = batch.convergenceTime(s - first);
+            result.maxOvershoot = batch.maxOvershoot(s - first);
+            result.steps = steps;
+        }
+        first = last;
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef WORLD_BATCH_H
+#define WORLD_BATCH_H
+
+#include <cstddef>
+#include <vector>
+#include "Drone.h"
+#include "Scenario.h"
+#include "Vector2.h"
+#include "World.h"
+
+/*
+ * @class:
+ *         WorldBatch
+ * @brief:
+ *         Advances many small, independent worlds in lockstep, with the
+ *         worlds in the SIMD lanes.
+ *
+ * Every world has the same number of drones and shares dt; everything else
+ * (gravity, bounds, drone parameters, gains, stop radius, starts, targets)
+ * is per world. State is stored drone-major and world-minor — element
+ * [drone * laneCount() + world] — so one pass of the kernel runs PD control,
+ * thrust clamping, integration and the convergence bookkeeping for drone
+ * slot d of four worlds per AVX instruction. The world count is padded to a
+ * multiple of kLanes with copies of world 0 whose results are ignored.
+ *
+ * The arithmetic matches FormationController and Drone::update() operation
+ * for operation, so a world here follows the same trajectory as the same
+ * scenario in a Simulator. There is no network: batch mode is for dynamics
+ * studies (convergence, overshoot), where the per-Simulator overhead of a
+ * four-drone scenario would otherwise dominate.
+ */
+
+class WorldBatch {
+public:
+    static constexpr std::size_t kLanes = 4;
+
+    /*
+     * @param: drones
+     *         Drones per world.
+     * @param: worlds
+     *         Number of worlds.
+     */
+
+    WorldBatch(std::size_t drones, std::size_t worlds);
+
+    std::size_t worldCount() const { return mWorlds; }
+
+    std::size_t droneCount() const { return mDrones; }
+
+    std::size_t laneCount() const { return mLanes; }
+
+    /*
+     * @brief:
+     *         Sets a world's environment, drone parameters and controller
+     *         (call before the first step).
+     */
+
+    void setWorld(std::size_t world, const World& settings, const DroneParams& drone,
+        double kP, double kD, double stopRadius, double settleTolerance);
+
+    /*
+     * @brief:
+     *         Places one drone of a world and gives it its target.
+     */
+
+    void setDrone(std::size_t world, std::size_t drone, const Vector2& start, const Vector2& target);
+
+    /*
+     * @brief:
+     *         Configures a world from a scenario (drone count must match).
+     */
+
+    void setScenario(std::size_t world, const ScenarioParams& scenario);
+
+    /*
+     * @brief:
+     *         Runs control and physics for every world.
+     */
+
+    void step(double dt);
+
+    double time() const { return mTime; }
+
+    Vector2 position(std::size_t world, std::size_t drone) const;
+
+    Vector2 velocity(std::size_t world, std::size_t drone) const;
+
+    /*
+     * @brief:
+     *         Same definitions as ScenarioResult (tracked every step).
+     */
+
+    double convergenceTime(std::size_t world) const { return mConvergedAt[world]; }
+
+    double maxOvershoot(std::size_t world) const { return mOvershoot[world]; }
+
+private:
+    void padLanes();
+
+    std::size_t mDrones;
+    std::size_t mWorlds;
+    std::size_t mLanes;     // mWorlds rounded up to kLanes
+    bool mPadded = false;
+    double mTime = 0.0;
+
+    // per drone x lane
+    std::vector<double> mPosX;
+    std::vector<double> mPosY;
+    std::vector<double> mVelX;
+    std::vector<double> mVelY;
+    std::vector<double> mTargetX;
+    std::vector<double> mTargetY;
+    std::vector<double> mArrived;       // 1.0 once within stopRadius
+
+    // per lane
+    std::vector<double> mKp;
+    std::vector<double> mKd;
+    std::vector<double> mStopRadius;
+    std::vector<double> mSettleRadius;  // stopRadius + settleTolerance
+    std::vector<double> mMass;
+    std::vector<double> mInvMass;
+    std::vector<double> mGravityX;
+    std::vector<double> mGravityY;
+    std::vector<double> mMaxThrust;
+    std::vector<double> mMaxSpeed;
+    std::vector<double> mWidth;
+    std::vector<double> mHeight;
+    std::vector<double> mAllInside;     // scratch: 1.0 while every drone is settled
+    std::vector<double> mConvergedAt;
+    std::vector<double> mOvershoot;
+};
+
+/*
+ * @brief:
+ *         Runs scenarios headless through WorldBatch, up to 'worldsPerBatch'
+ *         at a time. Consecutive scenarios with the same drone count, dt
+ *         and duration share a batch.
+ *
+ * Only the dynamics fields of the results (convergenceTime, maxOvershoot,
+ * steps) are filled; the network is not simulated.
+ */
+
+void runScenarioBatch(const ScenarioParams* scenarios, std::size_t count,
+    ScenarioResult* results, std::size_t worldsPerBatch = 64);
+
+#endif // WORLD_BATCH_H
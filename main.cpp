@@ -1,8 +1,26 @@
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
 #include <vector>
-#include <fstream>
+#include <memory>
+#include <string>
 #include "Simulator.h"
+#include "CompressedTelemetrySink.h"
+#include "CsvTelemetrySink.h"
+#include "DecimatingTelemetrySink.h"
+#include "FormationController.h"
+#include "Metrics.h"
+#include "Profiler.h"
+#include "RealTimePacer.h"
+#include "Scenario.h"
+#include "ShmFrameRing.h"
+#include "SocketTelemetrySink.h"
 
 /**
  * @brief: 
@@ -11,11 +29,12 @@
  * This program:
  * 1. Creates a 2D physics world with gravity and boundaries.
  * 2. Instantiates a Simulator that manages drones and communication.
- * 3. Spawns four drones at different corners of the world.
+ * 3. Spawns four drones at different corners of the world (or --drones N
+ *    on a grid).
  * 4. Assigns each drone a target offset relative to a formation center.
  * 5. Uses a PD controller to guide drones into formation.
  * 6. Logs drone trajectory data to CSV each timestep.
- * 7. Prints communication network statistics at the end.
+ * 7. Prints communication network statistics and throughput at the end.
  *
  * The simulation demonstrates:
  * - Physics integration
@@ -25,132 +44,401 @@
  *
  * Output files:
  * - simulation_log.csv   : Drone positions/velocities over time.
+ * - simulation_log.csv.idx : Step index for random access
+ *                          (TelemetryLogReader).
+ * - simulation_log.csv.meta : Decimation settings, only when a --log-*
+ *                          option below makes the log sparse.
  * - comms_log.csv        : All network events (generated by Network).
+ * - metrics.csv          : Periodic runtime metric snapshots.
+ *
+ * The run never waits for input, so it can be used in batch jobs; with
+ * --quiet the only output is the throughput report at exit. Bad options
+ * (unknown names, unknown --param names, values that are not numbers or
+ * are out of range) print an error and exit with status 2.
+ *
+ * Options:
+ * - --drones <n>         : Fly n drones (n >= 1) from a grid to a ring
+ *                          (swarmScenario()) instead of the demo.
+ * - --duration <s>       : Simulated time, >= 0 (wins over --param).
+ * - --dt <s>             : Time step, > 0 (wins over --param).
+ * - --seed <n>           : Network RNG seed (default: nondeterministic).
+ * - --threads <n>        : Threads formatting simulation_log.csv rows,
+ *                          1 to 256 (the simulation step itself is
+ *                          sequential).
+ * - --sinks <list>       : Output files, comma-separated from csv
+ *                          (simulation_log.csv), comms (comms_log.csv),
+ *                          metrics (metrics.csv), or none. Default: all.
+ * - --quiet              : No console output during the run, no network
+ *                          event echo and no per-node summary.
+ * - --profile <path>     : Chrome trace path of a -DDRONESIM_PROFILE
+ *                          build (default profile_trace.json).
+ * - --stream <endpoint>  : Stream live telemetry frames over a local
+ *                          socket ("unix:/path.sock" or "tcp:port"),
+ *                          see Tools/TelemetryClient.cpp.
+ * - --shm <name>         : Publish every step into a shared-memory frame
+ *                          ring (e.g. "/dronesim") for local observers,
+ *                          see Tools/ShmRingStress.cpp --attach.
+ * - --log-every <n>      : Consider drones for simulation_log.csv only
+ *                          every n-th step (n >= 1).
+ * - --log-pos-eps <m>    : Skip a drone's row until it moved more than m
+ *                          from its last logged row ...
+ * - --log-vel-eps <m/s>  : ... or its velocity changed more than this.
+ * - --log-max-gap <n>    : Log every drone at least every n steps
+ *                          (0 = never forced).
+ *   Reaching the formation target is always logged.
+ * - --log-threads <n>    : Same as --threads.
+ * - --log-compress       : Write simulation_log.csv.lz and comms_log.csv.lz
+ *                          instead (see Tools/LogUnpack.cpp).
+ * - --record <path>      : Also record every frame, exactly, to a
+ *                          compressed binary log (e.g. run.dtz).
+ * - --param <name=value> : Override a scenario parameter (kP, kD,
+ *                          stopRadius, dt, duration, latency, jitter,
+ *                          drop, ...; see setScenarioParameter()).
+ * - --realtime <factor>  : Pace the loop to wall-clock time, factor (> 0)
+ *                          simulated seconds per second (1 = real time),
+ *                          and print overrun and jitter statistics.
+ * - --overrun <policy>   : What a paced run does after a late step:
+ *                          catch-up (default), skip or slow-down.
+ * - --help               : Print the usage summary and exit.
  */
 
-int main() {
+namespace {
 
-    // WORLD AND SIMULATOR SETUP
+    const char* const kUsage =
+        "usage: DroneSim [--drones N] [--duration T] [--dt S] [--seed S] [--threads N]\n"
+        "                [--sinks csv,comms,metrics|none] [--quiet] [--profile trace.json]\n"
+        "                [--param name=value] [--realtime F] [--overrun catch-up|skip|slow-down]\n"
+        "                [--stream endpoint] [--shm name] [--record path] [--log-compress]\n"
+        "                [--log-every N] [--log-pos-eps M] [--log-vel-eps V] [--log-max-gap N]\n"
+        "                [--log-threads N] [--help]\n";
 
-    World world(Vector2(0.0, -9.8), 100.0, 100.0);
-    Simulator sim(world);
+    // whole argument as a finite number; false on trailing text or overflow
+    bool parseDouble(const char* text, double& value) {
+        char* end = nullptr;
+        errno = 0;
+        double parsed = std::strtod(text, &end);
+        if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(parsed)) return false;
+        value = parsed;
+        return true;
+    }
 
-     // DRONE PHYSICAL PARAMETERS
+    // whole argument as a base-10 integer in [min, max]
+    bool parseInteger(const char* text, long long min, long long max, long long& value) {
+        char* end = nullptr;
+        errno = 0;
+        long long parsed = std::strtoll(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE || parsed < min || parsed > max) return false;
+        value = parsed;
+        return true;
+    }
 
-    DroneParams params;
-    params.mass = 1.0;         // kg
-    params.maxThrust = 40.0;   // Maximum thrust force avaliable
-    params.maxSpeed = 25.0;    // Speed limit used in drone physics.
+    // whole argument as an unsigned 64-bit integer (no sign)
+    bool parseUnsigned(const char* text, std::uint64_t& value) {
+        char* end = nullptr;
+        errno = 0;
+        if (*text == '-' || *text == '+') return false;
+        unsigned long long parsed = std::strtoull(text, &end, 10);
+        if (end == text || *end != '\0' || errno == ERANGE) return false;
+        value = parsed;
+        return true;
+    }
 
-    // Starting position: Corners of the World.
-    std::vector<Vector2> startPositions = {
-        Vector2(10.0, 10.0),
-        Vector2(90.0, 10.0),
-        Vector2(10.0, 90.0),
-        Vector2(90.0, 90.0)
-    };
+    int badValue(const std::string& option, const char* value) {
+        std::cerr << "Error: bad value for " << option << ": " << value << "\n" << kUsage;
+        return 2;
+    }
+
+    // --sinks list, e.g. "csv,metrics"; false for an unknown name
+    bool parseSinks(const std::string& list, bool& csv, bool& comms, bool& metrics) {
+        csv = comms = metrics = false;
+        std::size_t begin = 0;
+        while (begin <= list.size()) {
+            std::size_t end = list.find(',', begin);
+            if (end == std::string::npos) end = list.size();
+            std::string name = list.substr(begin, end - begin);
+            if (name == "csv") csv = true;
+            else if (name == "comms") comms = true;
+            else if (name == "metrics") metrics = true;
+            else if (name != "none") return false;
+            begin = end + 1;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+
+    // COMMAND LINE
+
+    long long drones = -1;              // -1 = demo scenario
+    double durationOverride = -1.0;
+    double dtOverride = -1.0;
+    std::uint64_t seed = 0;
+    bool seeded = false;
+    bool quiet = false;
+    bool csvSink = true;
+    bool commsSink = true;
+    bool metricsSink = true;
+    std::string profilePath = "profile_trace.json";
+    bool profileRequested = false;
+    std::vector<std::string> assignments;
+    std::string streamEndpoint;
+    std::string shmName;
+    std::string recordPath;
+    DecimationParams decimation;
+    bool decimate = false;
+    std::size_t logThreads = 1;
+    bool compressLogs = false;
+    PacingParams pacing;
+    bool paced = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        long long count = 0;
+        if (arg == "--quiet") quiet = true;
+        else if (arg == "--log-compress") compressLogs = true;
+        else if (arg == "--help") {
+            std::cout << kUsage;
+            return 0;
+        }
+        else if (arg == "--drones" && hasValue) {
+            if (!parseInteger(argv[++i], 1, INT_MAX, drones)) return badValue(arg, argv[i]);
+        }
+        else if (arg == "--duration" && hasValue) {
+            if (!parseDouble(argv[++i], durationOverride) || durationOverride < 0.0) return badValue(arg, argv[i]);
+        }
+        else if (arg == "--dt" && hasValue) {
+            if (!parseDouble(argv[++i], dtOverride) || dtOverride <= 0.0) return badValue(arg, argv[i]);
+        }
+        else if (arg == "--seed" && hasValue) {
+            if (!parseUnsigned(argv[++i], seed)) return badValue(arg, argv[i]);
+            seeded = true;
+        }
+        else if ((arg == "--threads" || arg == "--log-threads") && hasValue) {
+            if (!parseInteger(argv[++i], 1, 256, count)) return badValue(arg, argv[i]);
+            logThreads = static_cast<std::size_t>(count);
+        }
+        else if (arg == "--sinks" && hasValue && parseSinks(argv[i + 1], csvSink, commsSink, metricsSink)) ++i;
+        else if (arg == "--profile" && hasValue) {
+            profilePath = argv[++i];
+            profileRequested = true;
+        }
+        else if (arg == "--param" && hasValue) assignments.push_back(argv[++i]);
+        else if (arg == "--realtime" && hasValue) {
+            paced = true;
+            if (!parseDouble(argv[++i], pacing.realTimeFactor) || pacing.realTimeFactor <= 0.0) {
+                return badValue(arg, argv[i]);
+            }
+        }
+        else if (arg == "--overrun" && hasValue) {
+            std::string policy = argv[++i];
+            if (policy == "catch-up") pacing.policy = OverrunPolicy::CatchUp;
+            else if (policy == "skip") pacing.policy = OverrunPolicy::Skip;
+            else if (policy == "slow-down") pacing.policy = OverrunPolicy::SlowDown;
+            else {
+                std::cerr << "Error: unknown --overrun " << policy << "\n" << kUsage;
+                return 2;
+            }
+        }
+        else if (arg == "--stream" && hasValue) streamEndpoint = argv[++i];
+        else if (arg == "--shm" && hasValue) shmName = argv[++i];
+        else if (arg == "--record" && hasValue) recordPath = argv[++i];
+        else if ((arg == "--log-every" || arg == "--log-pos-eps" || arg == "--log-vel-eps" || arg == "--log-max-gap") && hasValue) {
+            decimate = true;
+            const char* value = argv[++i];
+            bool ok = true;
+            if (arg == "--log-every") {
+                ok = parseInteger(value, 1, INT_MAX, count);
+                decimation.stepInterval = static_cast<int>(count);
+            }
+            if (arg == "--log-pos-eps") ok = parseDouble(value, decimation.positionEpsilon) && decimation.positionEpsilon >= 0.0;
+            if (arg == "--log-vel-eps") ok = parseDouble(value, decimation.velocityEpsilon) && decimation.velocityEpsilon >= 0.0;
+            if (arg == "--log-max-gap") {
+                ok = parseInteger(value, 0, INT_MAX, count);
+                decimation.maxGapSteps = static_cast<int>(count);
+            }
+            if (!ok) return badValue(arg, value);
+        }
+        else {
+            std::cerr << "Error: bad option " << arg << "\n" << kUsage;
+            return 2;
+        }
+    }
+#if !defined(DRONESIM_PROFILE)
+    if (profileRequested) {
+        std::cerr << "Warning: --profile ignored, build with -DDRONESIM_PROFILE\n";
+    }
+#endif
+
+    // SCENARIO (world, drones, formation targets, gains; see Scenario.cpp)
+
+    ScenarioParams scenario = drones > 0 ? swarmScenario(static_cast<std::size_t>(drones)) : demoScenario();
+    for (const std::string& assignment : assignments) {
+        std::size_t eq = assignment.find('=');
+        double value = 0.0;
+        if (eq == std::string::npos || !parseDouble(assignment.c_str() + eq + 1, value)) {
+            return badValue("--param", assignment.c_str());
+        }
+        if (!setScenarioParameter(scenario, assignment.substr(0, eq), value)) {
+            std::cerr << "Error: unknown --param " << assignment << "\n" << kUsage;
+            return 2;
+        }
+    }
+    if (durationOverride >= 0.0) scenario.duration = durationOverride;
+    if (dtOverride >= 0.0) scenario.dt = dtOverride;
+    if (scenario.dt <= 0.0) {
+        std::cerr << "Error: dt must be positive\n";
+        return 2;
+    }
+    if (seeded) scenario.network.seed = seed;
+    if (!commsSink) scenario.network.logPath.clear();
+    if (quiet) scenario.network.printEvents = false;
+    const World& world = scenario.world;
+    const DroneParams& params = scenario.drone;
+
+    // WORLD AND SIMULATOR SETUP
+
+    Simulator sim(world, scenario.network);
 
     std::vector<int> droneIds;
-    for (const auto& startPos : startPositions) {
-        int id = sim.addDrone(params, startPos);
+    for (const auto& startPos : scenario.startPositions) {
+        int id = sim.droneIndex(sim.addDrone(params, startPos));
         droneIds.push_back(id);
     }
 
-    // FORMATION GEOMETRY (CENTER + PER-DRONE OFFSET)
-    Vector2 formationCenter(60.0, 60.0);
-    std::vector<Vector2> offsets = {
-        Vector2(-5.0,  0.0),  // Drone 0 target = (55, 60)
-        Vector2(5.0,  0.0),   // Drone 1 target = (65, 60)
-        Vector2(0.0,  5.0),   // Drone 2 target = (60, 65)
-        Vector2(0.0, -5.0)    // Drone 3 target = (60, 55)
-    };
-
     // SIMULATION PARAMETERS
-    double dt = 0.01;            // Time step in seconds
-    double totalTime = 0.0;      // Simulation clock
-    double simDuration = 10.0;   // Total runtime
-    double stopRadius = 1.5;     // Distance considered "close enough" to objective
+    double dt = scenario.dt;                 // Time step in seconds
+    double totalTime = 0.0;                  // Simulation clock
+    double simDuration = scenario.duration;  // Total runtime
+    double stopRadius = scenario.stopRadius; // Distance considered "close enough" to objective
 
-    // PD Control gains
-    double kP = 0.4;    // Proportional gain
-    double kD = 1.2;    // Derivative gain
+    // FORMATION CONTROLLER (targets = center + offset, computed once)
+    FormationController controller(stopRadius);
+    for (size_t i = 0; i < droneIds.size(); ++i) {
+        controller.addDrone(droneIds[i], scenario.targets[i], scenario.kP, scenario.kD, params.mass);
+    }
 
     std::cout << std::fixed << std::setprecision(3);
 
-    // OPEN CSV LOG FILE
-    std::ofstream logFile("simulation_log.csv");
-    if (!logFile) {
-        std::cerr << "Error: could not open simulation_log.csv for writing\n";
-        return 1;
+    // OPTIONAL LIVE TELEMETRY STREAM (one binary frame per step)
+    std::unique_ptr<SocketTelemetrySink> stream;
+    std::unique_ptr<ShmFrameRingWriter> shmRing;
+    std::unique_ptr<CompressedTelemetrySink> recording;
+    std::unique_ptr<RealTimePacer> pacer;
+    if (!recordPath.empty()) {
+        recording = std::make_unique<CompressedTelemetrySink>(recordPath);
+        if (!recording->isOpen()) {
+            std::cerr << "Warning: recording disabled: " << recording->error() << "\n";
+            recording.reset();
+        }
+        else {
+            sim.addTelemetrySink(*recording);
+        }
+    }
+    if (!shmName.empty()) {
+        shmRing = std::make_unique<ShmFrameRingWriter>(shmName, droneIds.size());
+        if (!shmRing->isOpen()) {
+            std::cerr << "Warning: shared-memory ring disabled: " << shmRing->error() << "\n";
+            shmRing.reset();
+        }
+        else {
+            sim.addTelemetrySink(*shmRing);
+        }
+    }
+    if (!streamEndpoint.empty()) {
+        stream = std::make_unique<SocketTelemetrySink>(streamEndpoint);
+        if (!stream->isOpen()) {
+            std::cerr << "Warning: telemetry stream disabled: " << stream->error() << "\n";
+            stream.reset();
+        }
+        else {
+            sim.addTelemetrySink(*stream);
+        }
+    }
+
+    // OPEN CSV LOG FILE (+ step index), written once per step by the simulator
+    std::unique_ptr<CsvTelemetrySink> logFile;
+    if (compressLogs && commsSink && !sim.enableCommsLogCompression()) {
+        std::cerr << "Warning: comms_log.csv is written uncompressed\n";
+    }
+    if (csvSink) {
+        logFile = std::make_unique<CsvTelemetrySink>("simulation_log.csv", logThreads, compressLogs);
+        if (!logFile->isOpen()) {
+            std::cerr << "Error: " << logFile->error() << "\n";
+            return 1;
+        }
+    }
+
+    // OPTIONAL DECIMATION (sparse log + metadata sidecar)
+    std::unique_ptr<DecimatingTelemetrySink> decimator;
+    std::vector<bool> arrived(droneIds.size(), false);
+    if (logFile && decimate) {
+        decimator = std::make_unique<DecimatingTelemetrySink>(*logFile, decimation);
+        sim.addTelemetrySink(*decimator);
+    }
+    else if (logFile) {
+        sim.addTelemetrySink(*logFile);
+    }
+
+    // RUNTIME METRICS (snapshot every simulated second, tail-able while running)
+    std::unique_ptr<MetricsSnapshotWriter> metricsWriter;
+    if (metricsSink) {
+        metricsWriter = std::make_unique<MetricsSnapshotWriter>("metrics.csv", 1.0);
     }
 
-    // CSV HEADER
-    logFile << "time,droneId,x,y,vx,vy\n";
+    // OPTIONAL WALL-CLOCK PACING
+    if (paced) {
+        pacer = std::make_unique<RealTimePacer>(dt, pacing);
+        pacer->start();
+    }
 
     // MAIN SIMULATION LOOP
 
+    const std::uint64_t printEvery = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::llround(0.5 / dt)));
+    std::uint64_t steps = 0;
+    auto wallStart = std::chrono::steady_clock::now();
     while (totalTime < simDuration) {
-        const auto& drones = sim.getDrones();
-
-        // CONTROL STEP
-        for (size_t i = 0; i < droneIds.size(); ++i) {
-            int id = droneIds[i];
-            const Drone& d = drones[id];
-
-            Vector2 pos = d.getPosition();
-            Vector2 vel = d.getVelocity();
-
-            // Target for this drone = formation center + its offset
-            Vector2 target(
-                formationCenter.x + offsets[i].x,
-                formationCenter.y + offsets[i].y
-            );
-
-            Vector2 toTarget(target.x - pos.x, target.y - pos.y);
-            double dist = toTarget.length();
-
-            if (dist > stopRadius) {
-                // PD acceleration command
-                Vector2 accCmd = toTarget * kP - vel * kD;
-                // Convert acceleration to force = m*a subtract gravity
-                Vector2 desiredForce = accCmd * params.mass - world.gravity * params.mass;
-                sim.setDroneThrustForce(id, desiredForce);
-            }
-            else {
-                sim.clearDroneThrust(id);
-            }
+        // CONTROL STEP (all drones in one batched pass)
+        {
+            PROFILE_SCOPE("control");
+            controller.compute(sim.getDrones(), world.gravity);
+            sim.setDroneThrustForces(controller.droneIds(), controller.thrustX(),
+                controller.thrustY(), controller.size());
         }
 
-        // PHYSICS + NETWORK
+        // PHYSICS + NETWORK (+ CSV log and live sinks)
         sim.step(dt);
         totalTime += dt;
+        ++steps;
 
-        // LOG STATE
         const auto& dState = sim.getDrones();
-        for (size_t i = 0; i < droneIds.size(); ++i) {
-            int id = droneIds[i];
-            const Vector2& p = dState[id].getPosition();
-            const Vector2& v = dState[id].getVelocity();
 
-            logFile << totalTime << ","
-                << id << ","
-                << p.x << ","
-                << p.y << ","
-                << v.x << ","
-                << v.y << "\n";
+        // EVENTS: reaching the target is always kept in a decimated log
+        if (decimator) {
+            for (size_t i = 0; i < droneIds.size(); ++i) {
+                Vector2 target = controller.target(i);
+                const Vector2& p = dState[droneIds[i]].getPosition();
+                bool inside = Vector2(target.x - p.x, target.y - p.y).length() < stopRadius;
+                if (inside && !arrived[i]) {
+                    decimator->flagEvent(droneIds[i]);
+                }
+                arrived[i] = inside;
+            }
+        }
+
+        if (metricsWriter) {
+            metricsWriter->maybeWrite(totalTime);
         }
 
-        if (static_cast<int>(totalTime * 100) % 50 == 0) {
+        if (!quiet && steps % printEvery == 0) {
             std::cout << "t=" << totalTime << "\n";
             for (size_t i = 0; i < droneIds.size(); ++i) {
                 int id = droneIds[i];
                 const Vector2& p = dState[id].getPosition();
                 const Vector2& v = dState[id].getVelocity();
 
-                Vector2 target(
-                    formationCenter.x + offsets[i].x,
-                    formationCenter.y + offsets[i].y
-                );
+                Vector2 target = controller.target(i);
                 Vector2 toTarget(target.x - p.x, target.y - p.y);
                 double dist = toTarget.length();
 
@@ -161,15 +449,55 @@ int main() {
             }
             std::cout << "\n";
         }
+
+        if (pacer) {
+            pacer->wait();
+        }
     }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
 
-    logFile.close();
+    if (decimator) {
+        decimator->close();
+        decimator->writeMetadata("simulation_log.csv.meta");
+    }
+    if (logFile) {
+        logFile->close();
+    }
+    if (metricsWriter) {
+        metricsWriter->write(totalTime);
+    }
+    if (stream) {
+        stream->close();
+    }
+    if (shmRing) {
+        shmRing->close();
+    }
+    if (recording) {
+        recording->close();
+    }
 
     // PRINY FINAL COMMUNICATION STATISTICS
-    sim.printCommsSummary();
+    if (!quiet) {
+        sim.printCommsSummary();
+    }
+    if (pacer) {
+        pacer->printSummary(std::cout);
+    }
+
+#if defined(DRONESIM_PROFILE)
+    // PROFILER OUTPUT (chrome://tracing or Perfetto)
+    Profiler::writeChromeTrace(profilePath);
+    if (!quiet || profileRequested) {
+        Profiler::printSummary(std::cout);
+    }
+#endif
 
-    std::cout << "\nSimulation complete. Press Enter to exit.\n";
-    std::cin.get();
+    // THROUGHPUT (loop only: setup and final flushes excluded)
+    double stepsPerSecond = wallSeconds > 0.0 ? static_cast<double>(steps) / wallSeconds : 0.0;
+    std::cout << (quiet ? "" : "\n") << "Simulation complete: " << droneIds.size() << " drones, " << steps << " steps ("
+        << totalTime << " s simulated) in " << wallSeconds << " s wall\n"
+        << "Throughput: " << std::setprecision(0) << stepsPerSecond << " steps/s, "
+        << stepsPerSecond * static_cast<double>(droneIds.size()) << " drone-steps/s\n";
 
     return 0;
 }